@@ -37,6 +37,11 @@ else
 	print "Action not specified\n"
 end
 
+newoption {
+	trigger = "with-opengl",
+	description = "Enable optional OpenGL rendering (set \"KMETER_OPENGL=1\" at run-time)"
+}
+
 solution "kmeter"
 	language "C++"
 
@@ -63,6 +68,18 @@ solution "kmeter"
 		"../libraries/juce/modules/juce_video/juce_video.cpp"
 	}
 
+	if _OPTIONS["with-opengl"] then
+		defines { "KMETER_OPENGL=1" }
+
+		files {
+			"../libraries/juce/modules/juce_opengl/juce_opengl.cpp"
+		}
+
+		configuration { "linux" }
+			links { "GL" }
+
+		configuration { }
+	end
 
 	includedirs {
 		"../JuceLibraryCode/",
@@ -119,6 +136,17 @@ solution "kmeter"
 			"JUCE_USE_VSTSDK_2_4=0"
 		}
 
+		excludes {
+			"../Source/analyser_*.h",
+			"../Source/analyser_*.cpp",
+			"../Source/console_output.h",
+			"../Source/console_output.cpp",
+			"../Source/statistics_test_*.h",
+			"../Source/statistics_test_*.cpp",
+			"../Source/stress_test_*.h",
+			"../Source/stress_test_*.cpp"
+		}
+
 		configuration {"linux"}
 			defines {
 				"LINUX=1",
@@ -163,6 +191,17 @@ solution "kmeter"
 			"JUCE_USE_VSTSDK_2_4=0"
 		}
 
+		excludes {
+			"../Source/analyser_*.h",
+			"../Source/analyser_*.cpp",
+			"../Source/console_output.h",
+			"../Source/console_output.cpp",
+			"../Source/statistics_test_*.h",
+			"../Source/statistics_test_*.cpp",
+			"../Source/stress_test_*.h",
+			"../Source/stress_test_*.cpp"
+		}
+
 		configuration {"linux"}
 			defines {
 				"LINUX=1",
@@ -193,6 +232,205 @@ solution "kmeter"
 		configuration "Release"
 			objdir ("../bin/intermediate_" .. os.get() .. "/standalone_surround_release")
 
+--------------------------------------------------------------------------------
+
+	project (os.get() .. "_analyser")
+		kind "ConsoleApp"
+		location (os.get() .. "/analyser")
+		targetname "kmeter_analyser"
+		targetprefix ""
+
+		defines {
+			"KMETER_ANALYSER=1",
+			"JUCE_USE_VSTSDK_2_4=0"
+		}
+
+		-- the analyser has no GUI, so only link the audio and core
+		-- modules (juce_events would pull in X11 on Linux)
+		excludes {
+			"../Source/resources/**",
+			"../Source/channel_slider.*",
+			"../Source/goniometer*",
+			"../Source/kmeter.*",
+			"../Source/meter_bar.*",
+			"../Source/meter_segment.*",
+			"../Source/numeric_label.*",
+			"../Source/overflow_meter.*",
+			"../Source/peak_label.*",
+			"../Source/phase_correlation_meter.*",
+			"../Source/plugin_editor.*",
+			"../Source/plugin_parameters.*",
+			"../Source/plugin_processor.*",
+			"../Source/skin.*",
+			"../Source/spectrum_meter.*",
+			"../Source/standalone_application.*",
+			"../Source/statistics_test_*",
+			"../Source/stereo_meter.*",
+			"../Source/stress_test_*",
+			"../Source/window_about.*",
+			"../Source/window_validation.*",
+
+			"../libraries/juce/modules/juce_audio_devices/juce_audio_devices.cpp",
+			"../libraries/juce/modules/juce_audio_processors/juce_audio_processors.cpp",
+			"../libraries/juce/modules/juce_audio_utils/juce_audio_utils.cpp",
+			"../libraries/juce/modules/juce_cryptography/juce_cryptography.cpp",
+			"../libraries/juce/modules/juce_data_structures/juce_data_structures.cpp",
+			"../libraries/juce/modules/juce_events/juce_events.cpp",
+			"../libraries/juce/modules/juce_graphics/juce_graphics.cpp",
+			"../libraries/juce/modules/juce_gui_basics/juce_gui_basics.cpp",
+			"../libraries/juce/modules/juce_gui_extra/juce_gui_extra.cpp",
+			"../libraries/juce/modules/juce_opengl/juce_opengl.cpp",
+			"../libraries/juce/modules/juce_video/juce_video.cpp"
+		}
+
+		configuration {"linux"}
+			defines {
+				"LINUX=1",
+				"JUCE_ALSA=0",
+				"JUCE_JACK=0",
+				"JUCE_ASIO=0",
+				"JUCE_DIRECTSOUND=0"
+			}
+
+			links {
+				"pthread",
+				"rt",
+				"dl"
+			}
+
+		configuration "Debug"
+			objdir ("../bin/intermediate_" .. os.get() .. "/analyser_debug")
+
+		configuration "Release"
+			objdir ("../bin/intermediate_" .. os.get() .. "/analyser_release")
+
+--------------------------------------------------------------------------------
+
+	project (os.get() .. "_statistics_test")
+		kind "ConsoleApp"
+		location (os.get() .. "/statistics_test")
+		targetname "kmeter_statistics_test"
+		targetprefix ""
+
+		defines {
+			"KMETER_STATISTICS_TEST=1",
+			"JUCE_USE_VSTSDK_2_4=0"
+		}
+
+		-- runs analyser jobs, so it is built just like the analyser
+		excludes {
+			"../Source/resources/**",
+			"../Source/analyser_application.*",
+			"../Source/analyser_benchmark.*",
+			"../Source/analyser_microbenchmark.*",
+			"../Source/channel_slider.*",
+			"../Source/goniometer*",
+			"../Source/kmeter.*",
+			"../Source/meter_bar.*",
+			"../Source/meter_segment.*",
+			"../Source/numeric_label.*",
+			"../Source/overflow_meter.*",
+			"../Source/peak_label.*",
+			"../Source/phase_correlation_meter.*",
+			"../Source/plugin_editor.*",
+			"../Source/plugin_parameters.*",
+			"../Source/plugin_processor.*",
+			"../Source/skin.*",
+			"../Source/spectrum_meter.*",
+			"../Source/standalone_application.*",
+			"../Source/stereo_meter.*",
+			"../Source/stress_test_*",
+			"../Source/window_about.*",
+			"../Source/window_validation.*",
+
+			"../libraries/juce/modules/juce_audio_devices/juce_audio_devices.cpp",
+			"../libraries/juce/modules/juce_audio_processors/juce_audio_processors.cpp",
+			"../libraries/juce/modules/juce_audio_utils/juce_audio_utils.cpp",
+			"../libraries/juce/modules/juce_cryptography/juce_cryptography.cpp",
+			"../libraries/juce/modules/juce_data_structures/juce_data_structures.cpp",
+			"../libraries/juce/modules/juce_events/juce_events.cpp",
+			"../libraries/juce/modules/juce_graphics/juce_graphics.cpp",
+			"../libraries/juce/modules/juce_gui_basics/juce_gui_basics.cpp",
+			"../libraries/juce/modules/juce_gui_extra/juce_gui_extra.cpp",
+			"../libraries/juce/modules/juce_opengl/juce_opengl.cpp",
+			"../libraries/juce/modules/juce_video/juce_video.cpp"
+		}
+
+		configuration {"linux"}
+			defines {
+				"LINUX=1",
+				"JUCE_ALSA=0",
+				"JUCE_JACK=0",
+				"JUCE_ASIO=0",
+				"JUCE_DIRECTSOUND=0"
+			}
+
+			links {
+				"pthread",
+				"rt",
+				"dl"
+			}
+
+		configuration "Debug"
+			objdir ("../bin/intermediate_" .. os.get() .. "/statistics_test_debug")
+
+		configuration "Release"
+			objdir ("../bin/intermediate_" .. os.get() .. "/statistics_test_release")
+
+--------------------------------------------------------------------------------
+
+	project (os.get() .. "_stress_test")
+		kind "ConsoleApp"
+		location (os.get() .. "/stress_test")
+		targetname "kmeter_stress_test"
+		targetprefix ""
+
+		defines {
+			"KMETER_STRESS_TEST=1",
+			"KMETER_STEREO=1",
+			"JUCE_USE_VSTSDK_2_4=0"
+		}
+
+		-- instantiates the plug-in without an editor, but the
+		-- processor still needs the GUI modules to link
+		excludes {
+			"../Source/analyser_*.h",
+			"../Source/analyser_*.cpp",
+			"../Source/standalone_application.h",
+			"../Source/standalone_application.cpp",
+			"../Source/statistics_test_*.h",
+			"../Source/statistics_test_*.cpp"
+		}
+
+		configuration {"linux"}
+			defines {
+				"LINUX=1",
+				"JUCE_USE_XSHM=1",
+				"JUCE_ALSA=0",
+				"JUCE_JACK=0",
+				"JUCE_ASIO=0",
+				"JUCE_DIRECTSOUND=0"
+			}
+
+			includedirs {
+				"/usr/include",
+				"/usr/include/freetype2"
+			}
+
+			links {
+				"freetype",
+				"pthread",
+				"rt",
+				"X11",
+				"Xext"
+			}
+
+		configuration "Debug"
+			objdir ("../bin/intermediate_" .. os.get() .. "/stress_test_debug")
+
+		configuration "Release"
+			objdir ("../bin/intermediate_" .. os.get() .. "/stress_test_release")
+
 --------------------------------------------------------------------------------
 
 	project (os.get() .. "_lv2_stereo")
@@ -213,6 +451,14 @@ solution "kmeter"
 		}
 
 		excludes {
+			"../Source/analyser_*.h",
+			"../Source/analyser_*.cpp",
+			"../Source/console_output.h",
+			"../Source/console_output.cpp",
+			"../Source/statistics_test_*.h",
+			"../Source/statistics_test_*.cpp",
+			"../Source/stress_test_*.h",
+			"../Source/stress_test_*.cpp",
 			"../Source/standalone_application.h",
 			"../Source/standalone_application.cpp"
 		}
@@ -272,6 +518,14 @@ solution "kmeter"
 		}
 
 		excludes {
+			"../Source/analyser_*.h",
+			"../Source/analyser_*.cpp",
+			"../Source/console_output.h",
+			"../Source/console_output.cpp",
+			"../Source/statistics_test_*.h",
+			"../Source/statistics_test_*.cpp",
+			"../Source/stress_test_*.h",
+			"../Source/stress_test_*.cpp",
 			"../Source/standalone_application.h",
 			"../Source/standalone_application.cpp"
 		}
@@ -335,6 +589,14 @@ solution "kmeter"
 		}
 
 		excludes {
+			"../Source/analyser_*.h",
+			"../Source/analyser_*.cpp",
+			"../Source/console_output.h",
+			"../Source/console_output.cpp",
+			"../Source/statistics_test_*.h",
+			"../Source/statistics_test_*.cpp",
+			"../Source/stress_test_*.h",
+			"../Source/stress_test_*.cpp",
 			"../Source/standalone_application.h",
 			"../Source/standalone_application.cpp"
 		}
@@ -392,6 +654,14 @@ solution "kmeter"
 		}
 
 		excludes {
+			"../Source/analyser_*.h",
+			"../Source/analyser_*.cpp",
+			"../Source/console_output.h",
+			"../Source/console_output.cpp",
+			"../Source/statistics_test_*.h",
+			"../Source/statistics_test_*.cpp",
+			"../Source/stress_test_*.h",
+			"../Source/stress_test_*.cpp",
 			"../Source/standalone_application.h",
 			"../Source/standalone_application.cpp"
 		}
@@ -146,6 +146,11 @@ solution "kmeter"
 			"JUCE_USE_VSTSDK_2_4=0"
 		}
 
+		excludes {
+			"../Source/analyser_*.h",
+			"../Source/analyser_*.cpp"
+		}
+
 		includedirs {
 			"../libraries/asiosdk2.2/common"
 		}
@@ -178,6 +183,11 @@ solution "kmeter"
 			"JUCE_USE_VSTSDK_2_4=0"
 		}
 
+		excludes {
+			"../Source/analyser_*.h",
+			"../Source/analyser_*.cpp"
+		}
+
 		includedirs {
 			"../libraries/asiosdk2.2/common"
 		}
@@ -220,6 +230,8 @@ solution "kmeter"
 		}
 
 		excludes {
+			"../Source/analyser_*.h",
+			"../Source/analyser_*.cpp",
 			"../Source/standalone_application.h",
 			"../Source/standalone_application.cpp"
 		}
@@ -262,6 +274,8 @@ solution "kmeter"
 		}
 
 		excludes {
+			"../Source/analyser_*.h",
+			"../Source/analyser_*.cpp",
 			"../Source/standalone_application.h",
 			"../Source/standalone_application.cpp"
 		}
@@ -0,0 +1,344 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "analyser_application.h"
+
+
+AnalyserApplication::AnalyserApplication()
+{
+    // use the plug-in's defaults
+    nAverageAlgorithm = KmeterPluginParameters::selAlgorithmItuBs1770;
+    nCrestFactor = 20;
+
+    nNumberOfThreads = SystemStats::getNumCpus();
+    nSegmentLength = -1;
+    bBenchmark = false;
+    bMicrobenchmark = false;
+}
+
+
+AnalyserApplication::~AnalyserApplication()
+{
+}
+
+
+int AnalyserApplication::run(const StringArray& arguments)
+/*  Analyse audio files in parallel and print a report for each
+    file.
+
+    arguments (StringArray): command line arguments (without the name
+    of the executable)
+
+    return value (integer): exit code (0 when all files could be
+    analysed)
+*/
+{
+    if (!parseArguments(arguments))
+    {
+        printUsage();
+        return 2;
+    }
+
+    if (bMicrobenchmark)
+    {
+        AnalyserMicrobenchmark microbenchmark;
+        return microbenchmark.run();
+    }
+    else if (strConvertFormat.isNotEmpty())
+    {
+        return convertLogs();
+    }
+    else if (bBenchmark)
+    {
+        AnalyserBenchmark benchmark;
+        return benchmark.run(arrAudioFiles);
+    }
+
+    ThreadPool threadPool(nNumberOfThreads);
+    OwnedArray<AnalyserJob> arrJobs;
+    Array<int> arrFirstJobs;
+
+    int nSegmentLengthFinal = (nSegmentLength < 0) ? 60 : nSegmentLength;
+
+    for (int nFile = 0; nFile < arrAudioFiles.size(); nFile++)
+    {
+        arrFirstJobs.add(arrJobs.size());
+        AnalyserJob::addJobs(arrAudioFiles[nFile], nAverageAlgorithm, nSegmentLengthFinal, threadPool, arrJobs);
+    }
+
+    arrFirstJobs.add(arrJobs.size());
+    int nExitCode = 0;
+
+    // print reports in the order the files were passed, while the
+    // remaining files are still being analysed
+    for (int nFile = 0; nFile < arrAudioFiles.size(); nFile++)
+    {
+        AnalyserJob* pFirstJob = arrJobs[arrFirstJobs[nFile]];
+
+        // merge segments in order, so the results do not depend on
+        // which segment finished first
+        for (int nJob = arrFirstJobs[nFile]; nJob < arrFirstJobs[nFile + 1]; nJob++)
+        {
+            AnalyserJob* pJob = arrJobs[nJob];
+            threadPool.waitForJobToFinish(pJob, -1);
+
+            if (pJob != pFirstJob)
+            {
+                pFirstJob->mergeResults(*pJob);
+            }
+        }
+
+        if (pFirstJob->hasFailed())
+        {
+            nExitCode = 1;
+        }
+
+        ConsoleOutput::printMessage(pFirstJob->getReport(nCrestFactor));
+    }
+
+    return nExitCode;
+}
+
+
+int AnalyserApplication::convertLogs()
+/*  Convert binary validation logs to CSV or JSON.  The text files
+    are written next to the log files.
+
+    return value (integer): exit code (0 when all files could be
+    converted)
+*/
+{
+    bool bJson = (strConvertFormat == "json");
+    int nExitCode = 0;
+
+    for (int nFile = 0; nFile < arrLogFiles.size(); nFile++)
+    {
+        File fileLog = arrLogFiles[nFile];
+        File fileText = fileLog.withFileExtension(strConvertFormat);
+
+        if (MeasurementLog::convertToText(fileLog, fileText, bJson))
+        {
+            ConsoleOutput::printMessage(fileLog.getFullPathName() + " --> " + fileText.getFullPathName());
+        }
+        else
+        {
+            ConsoleOutput::printMessage(fileLog.getFullPathName() + ": could not convert log file");
+            nExitCode = 1;
+        }
+    }
+
+    return nExitCode;
+}
+
+
+bool AnalyserApplication::parseArguments(const StringArray& arguments)
+/*  Parse command line arguments.
+
+    arguments (StringArray): command line arguments
+
+    return value (Boolean): false if the arguments are invalid
+*/
+{
+    Array<File> arrInputFiles;
+
+    for (int nArgument = 0; nArgument < arguments.size(); nArgument++)
+    {
+        String strArgument = arguments[nArgument];
+
+        if (strArgument == "--rms")
+        {
+            nAverageAlgorithm = KmeterPluginParameters::selAlgorithmRms;
+        }
+        else if (strArgument == "--itu")
+        {
+            nAverageAlgorithm = KmeterPluginParameters::selAlgorithmItuBs1770;
+        }
+        else if (strArgument == "--normal")
+        {
+            nCrestFactor = 0;
+        }
+        else if (strArgument == "--k12")
+        {
+            nCrestFactor = 12;
+        }
+        else if (strArgument == "--k14")
+        {
+            nCrestFactor = 14;
+        }
+        else if (strArgument == "--k20")
+        {
+            nCrestFactor = 20;
+        }
+        else if (strArgument.startsWith("--threads="))
+        {
+            nNumberOfThreads = strArgument.fromFirstOccurrenceOf("=", false, false).getIntValue();
+
+            if (nNumberOfThreads < 1)
+            {
+                return false;
+            }
+        }
+        else if (strArgument == "--benchmark")
+        {
+            bBenchmark = true;
+        }
+        else if (strArgument == "--microbenchmark")
+        {
+            bMicrobenchmark = true;
+        }
+        else if (strArgument.startsWith("--segment="))
+        {
+            nSegmentLength = strArgument.fromFirstOccurrenceOf("=", false, false).getIntValue();
+
+            if (nSegmentLength < 0)
+            {
+                return false;
+            }
+        }
+        else if (strArgument.startsWith("--convert="))
+        {
+            strConvertFormat = strArgument.fromFirstOccurrenceOf("=", false, false);
+
+            if ((strConvertFormat != "csv") && (strConvertFormat != "json"))
+            {
+                return false;
+            }
+        }
+        else if (strArgument.startsWith("-"))
+        {
+            return false;
+        }
+        else
+        {
+            File fileInput = File::getCurrentWorkingDirectory().getChildFile(strArgument);
+
+            if (fileInput.exists())
+            {
+                arrInputFiles.add(fileInput);
+            }
+            else
+            {
+                ConsoleOutput::printMessage("File not found: \"" + strArgument + "\"\n");
+                return false;
+            }
+        }
+    }
+
+    // options may follow file names, so look into directories only
+    // after all options are known
+    for (int nFile = 0; nFile < arrInputFiles.size(); nFile++)
+    {
+        File fileInput = arrInputFiles[nFile];
+
+        if (fileInput.isDirectory())
+        {
+            addDirectory(fileInput);
+        }
+        else if (strConvertFormat.isNotEmpty())
+        {
+            arrLogFiles.add(fileInput);
+        }
+        else
+        {
+            arrAudioFiles.add(fileInput);
+        }
+    }
+
+    // the microbenchmark generates its own input
+    if (bMicrobenchmark)
+    {
+        return true;
+    }
+    else if (strConvertFormat.isNotEmpty())
+    {
+        return (arrLogFiles.size() > 0);
+    }
+    else
+    {
+        return (arrAudioFiles.size() > 0);
+    }
+}
+
+
+void AnalyserApplication::addDirectory(const File& directory)
+/*  Add all audio files (or log files when converting) in a
+    directory, but not in its sub-directories, sorted by name.
+
+    directory (const File&): directory to be searched
+
+    return value: none
+*/
+{
+    Array<File> arrFiles;
+    FileNameComparator comparator;
+
+    if (strConvertFormat.isNotEmpty())
+    {
+        directory.findChildFiles(arrFiles, File::findFiles, false, "*.kmlog");
+        arrFiles.sort(comparator);
+
+        arrLogFiles.addArray(arrFiles);
+    }
+    else
+    {
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        directory.findChildFiles(arrFiles, File::findFiles, false, formatManager.getWildcardForAllFormats());
+        arrFiles.sort(comparator);
+
+        arrAudioFiles.addArray(arrFiles);
+    }
+}
+
+
+void AnalyserApplication::printUsage()
+{
+    ConsoleOutput::printMessage(String(ProjectInfo::projectName) + " analyser " + ProjectInfo::versionString);
+    ConsoleOutput::printMessage(String::empty);
+    ConsoleOutput::printMessage("Usage: kmeter_analyser [options] file|directory ...");
+    ConsoleOutput::printMessage("       kmeter_analyser --benchmark file|directory ...");
+    ConsoleOutput::printMessage("       kmeter_analyser --convert=csv|json logfile|directory ...");
+    ConsoleOutput::printMessage("       kmeter_analyser --microbenchmark");
+    ConsoleOutput::printMessage(String::empty);
+    ConsoleOutput::printMessage("  --itu          ITU-R BS.1770-1 average levels (default)");
+    ConsoleOutput::printMessage("  --rms          RMS average levels");
+    ConsoleOutput::printMessage("  --normal       no crest factor");
+    ConsoleOutput::printMessage("  --k12          K-12 scale");
+    ConsoleOutput::printMessage("  --k14          K-14 scale");
+    ConsoleOutput::printMessage("  --k20          K-20 scale (default)");
+    ConsoleOutput::printMessage("  --threads=N    use N threads (default: number of CPUs)");
+    ConsoleOutput::printMessage("  --segment=S    split files into segments of S seconds (default: 60; 0 = off)");
+    ConsoleOutput::printMessage("  --benchmark    measure throughput and check meter readings of validation files");
+    ConsoleOutput::printMessage("                 (at several sample rates, using both averaging algorithms)");
+    ConsoleOutput::printMessage("  --convert=F    convert binary validation logs (*.kmlog) to F (csv or json)");
+    ConsoleOutput::printMessage("  --microbenchmark  print processing time (ns/sample) of ring buffer, filters and");
+    ConsoleOutput::printMessage("                    ballistics for 1 to 16 channels and chunk sizes of 256 to 4096 as JSON");
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
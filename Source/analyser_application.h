@@ -0,0 +1,87 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __ANALYSER_APPLICATION_H__
+#define __ANALYSER_APPLICATION_H__
+
+class AnalyserApplication;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "analyser_benchmark.h"
+#include "analyser_job.h"
+#include "analyser_microbenchmark.h"
+#include "console_output.h"
+#include "measurement_log.h"
+#include "plugin_parameters.h"
+
+
+//==============================================================================
+/**
+*/
+class AnalyserApplication
+{
+public:
+    AnalyserApplication();
+    ~AnalyserApplication();
+
+    int run(const StringArray& arguments);
+
+private:
+    JUCE_LEAK_DETECTOR(AnalyserApplication);
+
+    int nAverageAlgorithm;
+    int nCrestFactor;
+    int nNumberOfThreads;
+    int nSegmentLength;
+    bool bBenchmark;
+    bool bMicrobenchmark;
+    String strConvertFormat;
+
+    Array<File> arrAudioFiles;
+    Array<File> arrLogFiles;
+
+    class FileNameComparator
+    {
+    public:
+        static int compareElements(const File& first, const File& second)
+        {
+            return first.getFullPathName().compare(second.getFullPathName());
+        }
+    };
+
+    int convertLogs();
+
+    bool parseArguments(const StringArray& arguments);
+    void addDirectory(const File& directory);
+    void printUsage();
+};
+
+
+#endif  // __ANALYSER_APPLICATION_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
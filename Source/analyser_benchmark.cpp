@@ -0,0 +1,395 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "analyser_benchmark.h"
+
+
+// expected readings of the files in "validation" (see the PDF files
+// next to them); all levels on the K-20 scale
+struct GoldenValue
+{
+    const char* strFileName;
+    int nAverageAlgorithm;
+    double dSeconds;
+    int nReading;
+    int nChannel;
+    float fExpected;
+    float fTolerance;
+    bool bNativeSampleRateOnly;
+};
+
+// averaging algorithm -1 --> valid in all modes; time -1.0 --> end
+// of file; small differences are caused by the time granularity of
+// the meters (one chunk of KMETER_BUFFER_SIZE samples)
+static const GoldenValue arrGoldenValues[] =
+{
+    {"meter_ballistics.flac", KmeterPluginParameters::selAlgorithmRms, 12.6, AnalyserBenchmark::readingAverageLevel, 0, -69.11f, 2.0f, false},
+    {"meter_ballistics.flac", KmeterPluginParameters::selAlgorithmRms, 25.2, AnalyserBenchmark::readingAverageLevel, 0, 19.10f, 2.0f, false},
+    {"meter_ballistics.flac", KmeterPluginParameters::selAlgorithmRms, 40.2, AnalyserBenchmark::readingPeakLevel, 0, -6.00f, 1.0f, false},
+
+    // sample peaks of resampled audio are different from the original
+    {"overflow.flac", -1, -1.0, AnalyserBenchmark::readingOverflows, 0, 16.0f, 0.0f, true},
+    {"overflow.flac", -1, -1.0, AnalyserBenchmark::readingOverflows, 1, 9.0f, 0.0f, true},
+
+    {"phase_correlation_meter.flac", -1, 26.0, AnalyserBenchmark::readingPhaseCorrelation, 0, +1.00f, 0.05f, false},
+    {"phase_correlation_meter.flac", -1, 31.0, AnalyserBenchmark::readingPhaseCorrelation, 0, +0.79f, 0.05f, false},
+    {"phase_correlation_meter.flac", -1, 36.0, AnalyserBenchmark::readingPhaseCorrelation, 0, +0.30f, 0.05f, false},
+    {"phase_correlation_meter.flac", -1, 41.0, AnalyserBenchmark::readingPhaseCorrelation, 0, -0.30f, 0.05f, false},
+    {"phase_correlation_meter.flac", -1, 46.0, AnalyserBenchmark::readingPhaseCorrelation, 0, -0.79f, 0.05f, false},
+    {"phase_correlation_meter.flac", -1, 51.0, AnalyserBenchmark::readingPhaseCorrelation, 0, -1.00f, 0.05f, false},
+
+    {"pink_noise_bandlimited.flac", KmeterPluginParameters::selAlgorithmRms, 10.0, AnalyserBenchmark::readingAverageLevel, 0, 0.00f, 0.5f, false},
+    {"pink_noise_bandlimited.flac", KmeterPluginParameters::selAlgorithmRms, 10.0, AnalyserBenchmark::readingAverageLevel, 1, 0.00f, 0.5f, false},
+
+    {"stereo_meter.flac", -1, 4.0, AnalyserBenchmark::readingStereoMeterValue, 0, -1.00f, 0.05f, false},
+    {"stereo_meter.flac", -1, 9.0, AnalyserBenchmark::readingStereoMeterValue, 0, -0.50f, 0.05f, false},
+    {"stereo_meter.flac", -1, 14.0, AnalyserBenchmark::readingStereoMeterValue, 0, 0.00f, 0.05f, false},
+    {"stereo_meter.flac", -1, 19.0, AnalyserBenchmark::readingStereoMeterValue, 0, +0.50f, 0.05f, false},
+    {"stereo_meter.flac", -1, 24.0, AnalyserBenchmark::readingStereoMeterValue, 0, +1.00f, 0.05f, false},
+};
+
+static const int arrSampleRates[] = {44100, 48000, 96000, 192000};
+
+
+AnalyserBenchmark::AnalyserBenchmark()
+/*  Constructor.  Runs the meters over audio files at several sample
+    rates, reports the throughput of every processing stage and
+    compares meter readings of the validation files with their
+    expected values.  This makes sure that optimisations do not
+    silently break the meters.
+
+    return value: none
+*/
+{
+    nSampleRate = 0;
+    nAverageAlgorithm = KmeterPluginParameters::selAlgorithmRms;
+    bNativeSampleRate = true;
+
+    pMeterAnalyser = NULL;
+    pRingBuffer = NULL;
+
+    nCurrentChunk = 0;
+    nTicksAnalyser = 0;
+
+    arrChecked.insertMultiple(0, false, numElementsInArray(arrGoldenValues));
+    nChecks = 0;
+    nFailures = 0;
+}
+
+
+AnalyserBenchmark::~AnalyserBenchmark()
+{
+    delete pRingBuffer;
+    pRingBuffer = NULL;
+
+    delete pMeterAnalyser;
+    pMeterAnalyser = NULL;
+}
+
+
+int AnalyserBenchmark::run(const Array<File>& audioFiles)
+/*  Benchmark audio files at all supported sample rates and in both
+    averaging modes.
+
+    audioFiles (const Array<File>&): audio files to be processed
+
+    return value (integer): exit code (0 when all files could be
+    processed and all readings were as expected)
+*/
+{
+    bool bSuccess = true;
+
+    for (int nFile = 0; nFile < audioFiles.size(); nFile++)
+    {
+        ConsoleOutput::printMessage(audioFiles[nFile].getFullPathName());
+
+        for (int nRate = 0; nRate < numElementsInArray(arrSampleRates); nRate++)
+        {
+            if (!benchmarkFile(audioFiles[nFile], arrSampleRates[nRate], KmeterPluginParameters::selAlgorithmRms))
+            {
+                bSuccess = false;
+            }
+
+            if (!benchmarkFile(audioFiles[nFile], arrSampleRates[nRate], KmeterPluginParameters::selAlgorithmItuBs1770))
+            {
+                bSuccess = false;
+            }
+        }
+
+        ConsoleOutput::printMessage(String::empty);
+    }
+
+    ConsoleOutput::printMessage(String(nChecks - nFailures) + " of " + String(nChecks) + " readings as expected");
+
+    return (bSuccess && (nFailures == 0)) ? 0 : 1;
+}
+
+
+bool AnalyserBenchmark::benchmarkFile(const File& audioFile, const int sample_rate, const int average_algorithm)
+/*  Process an audio file in chunks of KMETER_BUFFER_SIZE samples,
+    just like the plug-in does.  The audio is resampled to the given
+    sample rate first.
+
+    audioFile (const File&): audio file to be processed
+
+    sample_rate (integer): sample rate to be used for metering
+
+    average_algorithm (integer): algorithm for calculating average
+    meter levels; must be one of the "selAlgorithm..."  values defined
+    in "plugin_parameters.h"
+
+    return value (Boolean): false if the file could not be read
+*/
+{
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    AudioFormatReader* formatReader = formatManager.createReaderFor(audioFile);
+
+    if (formatReader == NULL)
+    {
+        ConsoleOutput::printMessage("  could not open audio file");
+        return false;
+    }
+
+    int nChannels = (int) formatReader->numChannels;
+    double dFileSampleRate = formatReader->sampleRate;
+    int64 nFileLength = formatReader->lengthInSamples;
+
+    AudioFormatReaderSource source(formatReader, true);
+    ResamplingAudioSource resampler(&source, false, nChannels);
+
+    strFileName = audioFile.getFileName();
+    nSampleRate = sample_rate;
+    nAverageAlgorithm = average_algorithm;
+    bNativeSampleRate = (roundToInt(dFileSampleRate) == nSampleRate);
+
+    // do not touch the samples at the file's sample rate, so that
+    // overflows can be checked
+    AudioSource* pInput = &source;
+
+    if (!bNativeSampleRate)
+    {
+        resampler.setResamplingRatio(dFileSampleRate / nSampleRate);
+        pInput = &resampler;
+    }
+
+    pInput->prepareToPlay(KMETER_BUFFER_SIZE, nSampleRate);
+
+    int64 nLengthInSamples = (int64) ceil(nFileLength * nSampleRate / dFileSampleRate);
+    int64 nChunks = AnalyserJob::getNumberOfChunks(nLengthInSamples);
+
+    pMeterAnalyser = new MeterAnalyser(nChannels, KMETER_BUFFER_SIZE, nSampleRate, nAverageAlgorithm);
+
+    pRingBuffer = new AudioRingBuffer("Benchmark ring buffer", nChannels, KMETER_BUFFER_SIZE, KMETER_BUFFER_SIZE, KMETER_BUFFER_SIZE);
+    pRingBuffer->setCallbackClass(this);
+
+    AudioSampleBuffer SampleBuffer(nChannels, KMETER_BUFFER_SIZE);
+
+    AudioSourceChannelInfo channelInfo;
+    channelInfo.buffer = &SampleBuffer;
+    channelInfo.startSample = 0;
+    channelInfo.numSamples = KMETER_BUFFER_SIZE;
+
+    for (int nGoldenValue = 0; nGoldenValue < arrChecked.size(); nGoldenValue++)
+    {
+        arrChecked.set(nGoldenValue, false);
+    }
+
+    nCurrentChunk = 0;
+    nTicksAnalyser = 0;
+
+    int64 nTicksDecoder = 0;
+    int64 nTicksRingBuffer = 0;
+
+    for (int64 nChunk = 0; nChunk < nChunks; nChunk++)
+    {
+        int64 nTicksStart = Time::getHighResolutionTicks();
+
+        // the source pads the buffer with silence after the end of
+        // the file
+        pInput->getNextAudioBlock(channelInfo);
+
+        int64 nTicksDecoded = Time::getHighResolutionTicks();
+
+        // triggers processBufferChunk()
+        pRingBuffer->addSamples(SampleBuffer, 0, KMETER_BUFFER_SIZE);
+
+        int64 nTicksProcessed = Time::getHighResolutionTicks();
+
+        nTicksDecoder += nTicksDecoded - nTicksStart;
+        nTicksRingBuffer += nTicksProcessed - nTicksDecoded;
+    }
+
+    // meter analyser has been timed separately
+    nTicksRingBuffer -= nTicksAnalyser;
+
+    checkGoldenValues(-1.0);
+    pInput->releaseResources();
+
+    int64 nSamples = nChunks * KMETER_BUFFER_SIZE;
+    String strAlgorithm = (nAverageAlgorithm == KmeterPluginParameters::selAlgorithmItuBs1770) ? "ITU-R" : "RMS";
+
+    String strReport = "  " + String(nSampleRate).paddedLeft(' ', 6) + " Hz, " + strAlgorithm.paddedRight(' ', 5) + "  ";
+    strReport += "decoder: " + formatSpeed(nSamples, nTicksDecoder) + "  ";
+    strReport += "ring buffer: " + formatSpeed(nSamples, nTicksRingBuffer) + "  ";
+    strReport += "meters: " + formatSpeed(nSamples, nTicksAnalyser);
+
+    ConsoleOutput::printMessage(strReport);
+
+    delete pRingBuffer;
+    pRingBuffer = NULL;
+
+    delete pMeterAnalyser;
+    pMeterAnalyser = NULL;
+
+    return true;
+}
+
+
+void AnalyserBenchmark::processBufferChunk(AudioSampleBuffer& buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples)
+{
+    int64 nTicksStart = Time::getHighResolutionTicks();
+
+    pMeterAnalyser->processBufferChunk(*pRingBuffer, uChunkSize, false);
+
+    nTicksAnalyser += Time::getHighResolutionTicks() - nTicksStart;
+    nCurrentChunk++;
+
+    // the meters look (KMETER_BUFFER_SIZE / 2) samples into the past
+    double dSeconds = double(nCurrentChunk * KMETER_BUFFER_SIZE - KMETER_BUFFER_SIZE / 2) / nSampleRate;
+    checkGoldenValues(dSeconds);
+}
+
+
+void AnalyserBenchmark::checkGoldenValues(const double seconds)
+/*  Compare meter readings with the expected values that are due.
+
+    seconds (double): current position in the audio file; pass -1.0
+    to check the values that apply to the end of the file
+
+    return value: none
+*/
+{
+    for (int nGoldenValue = 0; nGoldenValue < arrChecked.size(); nGoldenValue++)
+    {
+        const GoldenValue& golden = arrGoldenValues[nGoldenValue];
+
+        if (arrChecked[nGoldenValue] || (strFileName != golden.strFileName))
+        {
+            continue;
+        }
+
+        if ((golden.nAverageAlgorithm >= 0) && (golden.nAverageAlgorithm != nAverageAlgorithm))
+        {
+            continue;
+        }
+
+        if (golden.bNativeSampleRateOnly && !bNativeSampleRate)
+        {
+            continue;
+        }
+
+        if (seconds < 0.0)
+        {
+            if (golden.dSeconds >= 0.0)
+            {
+                continue;
+            }
+        }
+        else if ((golden.dSeconds < 0.0) || (seconds < golden.dSeconds))
+        {
+            continue;
+        }
+
+        arrChecked.set(nGoldenValue, true);
+        nChecks++;
+
+        float fReading = getReading(golden.nReading, golden.nChannel);
+
+        if (fabs(fReading - golden.fExpected) > golden.fTolerance)
+        {
+            nFailures++;
+
+            String strPosition = (golden.dSeconds < 0.0) ? "end of file" : (String(golden.dSeconds, 1) + " s");
+            ConsoleOutput::printMessage("  FAILED (" + String(nSampleRate) + " Hz, " + strPosition + ", channel " + String(golden.nChannel + 1) + "): read " + String(fReading, 2) + ", expected " + String(golden.fExpected, 2) + " +/- " + String(golden.fTolerance, 2));
+        }
+    }
+}
+
+
+float AnalyserBenchmark::getReading(const int reading, const int channel)
+{
+    MeterBallistics* pMeterBallistics = pMeterAnalyser->getLevels();
+
+    // K-20 scale
+    float fCrestFactor = 20.0f;
+
+    switch (reading)
+    {
+    case readingAverageLevel:
+        return fCrestFactor + pMeterBallistics->getAverageMeterLevel(channel);
+
+    case readingPeakLevel:
+        return fCrestFactor + pMeterBallistics->getPeakMeterLevel(channel);
+
+    case readingStereoMeterValue:
+        return pMeterBallistics->getStereoMeterValue();
+
+    case readingPhaseCorrelation:
+        return pMeterBallistics->getPhaseCorrelation();
+
+    case readingOverflows:
+        return (float) pMeterBallistics->getNumberOfOverflows(channel);
+
+    default:
+        jassertfalse;
+        return 0.0f;
+    }
+}
+
+
+String AnalyserBenchmark::formatSpeed(const int64 samples, const int64 ticks)
+/*  Format throughput of a processing stage.
+
+    samples (64-bit integer): number of processed samples (per
+    channel)
+
+    ticks (64-bit integer): processing time in high-resolution ticks
+
+    return value (String): samples per second and speed relative to
+    real-time
+*/
+{
+    double dSeconds = Time::highResolutionTicksToSeconds(jmax((int64) 1, ticks));
+    double dSamplesPerSecond = samples / dSeconds;
+
+    return String(dSamplesPerSecond / 1.0e6, 1) + " MS/s (" + String(roundToInt(dSamplesPerSecond / nSampleRate)) + "x)";
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
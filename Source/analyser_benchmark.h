@@ -0,0 +1,91 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __ANALYSER_BENCHMARK_H__
+#define __ANALYSER_BENCHMARK_H__
+
+class AnalyserBenchmark;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "analyser_job.h"
+#include "audio_ring_buffer.h"
+#include "console_output.h"
+#include "meter_analyser.h"
+#include "plugin_parameters.h"
+
+
+//==============================================================================
+/**
+*/
+class AnalyserBenchmark : public AudioRingBufferCallback
+{
+public:
+    AnalyserBenchmark();
+    ~AnalyserBenchmark();
+
+    int run(const Array<File>& audioFiles);
+    void processBufferChunk(AudioSampleBuffer& buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples);
+
+    enum Readings  // public namespace!
+    {
+        readingAverageLevel = 0,
+        readingPeakLevel,
+        readingStereoMeterValue,
+        readingPhaseCorrelation,
+        readingOverflows,
+    };
+
+private:
+    JUCE_LEAK_DETECTOR(AnalyserBenchmark);
+
+    bool benchmarkFile(const File& audioFile, const int sample_rate, const int average_algorithm);
+    void checkGoldenValues(const double seconds);
+    float getReading(const int reading, const int channel);
+
+    String formatSpeed(const int64 samples, const int64 ticks);
+
+    String strFileName;
+    int nSampleRate;
+    int nAverageAlgorithm;
+    bool bNativeSampleRate;
+
+    MeterAnalyser* pMeterAnalyser;
+    AudioRingBuffer* pRingBuffer;
+
+    int64 nCurrentChunk;
+    int64 nTicksAnalyser;
+
+    Array<bool> arrChecked;
+    int nChecks;
+    int nFailures;
+};
+
+
+#endif  // __ANALYSER_BENCHMARK_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,515 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "analyser_job.h"
+
+
+AnalyserJob::AnalyserJob(const File audioFile, const int average_algorithm, const int64 first_chunk, const int64 number_of_chunks)
+    : ThreadPoolJob("Analyse " + audioFile.getFileName())
+/*  Constructor.  Long audio files may be split into segments that
+    are analysed by separate jobs; their results can be combined
+    using mergeResults().
+
+    audioFile (File): audio file to be analysed
+
+    average_algorithm (integer): algorithm for calculating average
+    meter levels; must be one of the "selAlgorithm..."  values defined
+    in "plugin_parameters.h"
+
+    first_chunk (64-bit integer): first chunk of KMETER_BUFFER_SIZE
+    samples to be analysed
+
+    number_of_chunks (64-bit integer): number of chunks to be
+    analysed; pass -1 to analyse up to the end of the file
+
+    return value: none
+*/
+{
+    jassert(first_chunk >= 0);
+
+    fileAudio = audioFile;
+    strError = String::empty;
+
+    nAverageAlgorithm = average_algorithm;
+
+    nNumberOfChannels = 0;
+    nSampleRate = 0;
+    nLengthInSamples = 0;
+
+    nFirstChunk = first_chunk;
+    nNumberOfChunks = number_of_chunks;
+    nCurrentChunk = 0;
+
+    pMeterAnalyser = NULL;
+    pRingBuffer = NULL;
+
+    pStatistics = NULL;
+
+    nBlockChunks = 0;
+    nBlockStep = 0;
+    dChunkEnergies = NULL;
+}
+
+
+AnalyserJob::~AnalyserJob()
+{
+    deleteBuffers();
+
+    delete pStatistics;
+    pStatistics = NULL;
+}
+
+
+void AnalyserJob::deleteBuffers()
+/*  Free meters and ring buffer, but keep results.
+
+    return value: none
+*/
+{
+    delete pRingBuffer;
+    pRingBuffer = NULL;
+
+    delete pMeterAnalyser;
+    pMeterAnalyser = NULL;
+
+    delete [] dChunkEnergies;
+    dChunkEnergies = NULL;
+}
+
+
+ThreadPoolJob::JobStatus AnalyserJob::runJob()
+/*  Analyse audio file.  The file is read in chunks of
+    KMETER_BUFFER_SIZE samples, which are metered exactly like the
+    plug-in's audio input.
+
+    Segments other than the first one start with a pre-roll that is
+    metered, but not counted.  It overlaps the previous segment by the
+    settling time of the average filters plus one gating block, so
+    that segments can be analysed independently of each other and
+    still yield the same results as analysing the whole file.
+
+    return value (JobStatus): always "jobHasFinished"
+*/
+{
+    // WAV files are mapped into memory and converted straight into
+    // the ring buffer; other formats have to be decoded
+    ScopedPointer<MappedWavReader> mappedReader(new MappedWavReader(fileAudio));
+    ScopedPointer<AudioFormatReader> formatReader;
+
+    if (mappedReader->isValid())
+    {
+        nNumberOfChannels = mappedReader->getNumberOfChannels();
+        nSampleRate = mappedReader->getSampleRate();
+        nLengthInSamples = mappedReader->getLengthInSamples();
+    }
+    else
+    {
+        mappedReader = NULL;
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        formatReader = formatManager.createReaderFor(fileAudio);
+
+        if (formatReader == NULL)
+        {
+            strError = "could not open audio file";
+            return jobHasFinished;
+        }
+
+        nNumberOfChannels = (int) formatReader->numChannels;
+        nSampleRate = (int) formatReader->sampleRate;
+        nLengthInSamples = formatReader->lengthInSamples;
+    }
+
+    if ((nSampleRate < 44100) || (nSampleRate > 192000))
+    {
+        strError = "sample rate of " + String(nSampleRate) + " Hz not supported";
+        return jobHasFinished;
+    }
+
+    int64 nChunksInFile = getNumberOfChunks(nLengthInSamples);
+
+    if ((nNumberOfChunks < 0) || ((nFirstChunk + nNumberOfChunks) > nChunksInFile))
+    {
+        nNumberOfChunks = nChunksInFile - nFirstChunk;
+    }
+
+    // gating blocks of 400 ms with an overlap of 75 % (ITU-R
+    // BS.1770-3), rounded to whole chunks
+    nBlockChunks = jmax(1, roundToInt(0.4 * nSampleRate / KMETER_BUFFER_SIZE));
+    nBlockStep = jmax(1, roundToInt(0.1 * nSampleRate / KMETER_BUFFER_SIZE));
+
+    dChunkEnergies = new double[nBlockChunks];
+
+    for (int nChunk = 0; nChunk < nBlockChunks; nChunk++)
+    {
+        dChunkEnergies[nChunk] = 0.0;
+    }
+
+    pMeterAnalyser = new MeterAnalyser(nNumberOfChannels, KMETER_BUFFER_SIZE, nSampleRate, nAverageAlgorithm);
+    pMeterAnalyser->enableStatistics();
+
+    // weight channels by the speaker positions stored in the file;
+    // otherwise, the layout is guessed from the number of channels
+    // (up to 7.1.4)
+    if (mappedReader != NULL)
+    {
+        StringArray strChannelNames = ChannelLayout::getChannelNamesFromMask(mappedReader->getChannelMask(), nNumberOfChannels);
+
+        if (strChannelNames.size() > 0)
+        {
+            pMeterAnalyser->setChannelLayout(strChannelNames);
+        }
+    }
+
+    pRingBuffer = new AudioRingBuffer("Analyser ring buffer", nNumberOfChannels, KMETER_BUFFER_SIZE, KMETER_BUFFER_SIZE, KMETER_BUFFER_SIZE);
+    pRingBuffer->setCallbackClass(this);
+
+    AudioSampleBuffer SampleBuffer(nNumberOfChannels, KMETER_BUFFER_SIZE);
+
+    // the meters look (KMETER_BUFFER_SIZE / 2) samples into the past,
+    // so add another chunk
+    int nSettlingTime = pMeterAnalyser->getSettlingTime() + KMETER_BUFFER_SIZE;
+    int64 nPreRollChunks = (nSettlingTime + KMETER_BUFFER_SIZE - 1) / KMETER_BUFFER_SIZE + nBlockChunks;
+    int64 nStartChunk = jmax((int64) 0, nFirstChunk - nPreRollChunks);
+    int64 nEndChunk = nFirstChunk + nNumberOfChunks;
+
+    for (nCurrentChunk = nStartChunk; nCurrentChunk < nEndChunk; nCurrentChunk++)
+    {
+        if (shouldExit())
+        {
+            strError = "analysis cancelled";
+            break;
+        }
+
+        // the readers pad the buffer with silence after the end of
+        // the file
+        if (mappedReader != NULL)
+        {
+            mappedReader->readToRingBuffer(*pRingBuffer, nCurrentChunk * KMETER_BUFFER_SIZE, KMETER_BUFFER_SIZE);
+        }
+        else
+        {
+            SampleBuffer.clear();
+            formatReader->read(&SampleBuffer, 0, KMETER_BUFFER_SIZE, nCurrentChunk * KMETER_BUFFER_SIZE, true, true);
+
+            pRingBuffer->addSamples(SampleBuffer, 0, KMETER_BUFFER_SIZE);
+        }
+    }
+
+    // keep statistics; meters and filters are no longer needed, so
+    // free their memory while other files are still being analysed
+    pStatistics = new MeterStatistics(*pMeterAnalyser->getStatistics());
+    deleteBuffers();
+
+    return jobHasFinished;
+}
+
+
+void AnalyserJob::processBufferChunk(AudioSampleBuffer& buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples)
+{
+    MeterStatistics& statistics = *pMeterAnalyser->getStatistics();
+
+    // discard statistics of pre-roll
+    if (nCurrentChunk == nFirstChunk)
+    {
+        statistics.reset();
+    }
+
+    pMeterAnalyser->processBufferChunk(*pRingBuffer, uChunkSize, false);
+
+    if (nAverageAlgorithm != KmeterPluginParameters::selAlgorithmItuBs1770)
+    {
+        return;
+    }
+
+    // convert loudness back to weighted mean square
+    float fLoudness = pMeterAnalyser->getAverageLevel(0);
+    dChunkEnergies[nCurrentChunk % nBlockChunks] = pow(10.0, (fLoudness + 0.691) / 10.0);
+
+    // gating blocks are aligned to the start of the file, so every
+    // block is counted by exactly one segment
+    if ((nCurrentChunk >= nFirstChunk) && (nCurrentChunk >= (nBlockChunks - 1)) && (((nCurrentChunk + 1) % nBlockStep) == 0))
+    {
+        double dBlockEnergy = 0.0;
+
+        for (int nChunk = 0; nChunk < nBlockChunks; nChunk++)
+        {
+            dBlockEnergy += dChunkEnergies[nChunk];
+        }
+
+        statistics.addLoudnessBlock(dBlockEnergy / nBlockChunks);
+    }
+}
+
+
+void AnalyserJob::mergeResults(const AnalyserJob& other)
+/*  Add results of the following segment of the same audio file.
+    Both jobs must have finished.
+
+    other (const AnalyserJob&): job that has analysed another segment
+
+    return value: none
+*/
+{
+    jassert(other.fileAudio == fileAudio);
+
+    if (other.strError.isNotEmpty())
+    {
+        if (strError.isEmpty())
+        {
+            strError = other.strError;
+        }
+
+        return;
+    }
+    else if (strError.isNotEmpty())
+    {
+        return;
+    }
+
+    pStatistics->merge(*other.pStatistics);
+}
+
+
+const MeterStatistics* AnalyserJob::getStatistics()
+/*  Get results of analysis.
+
+    return value (const MeterStatistics*): statistics of the analysed
+    segment, or NULL if the analysis has failed
+*/
+{
+    if (hasFailed())
+    {
+        return NULL;
+    }
+
+    return pStatistics;
+}
+
+
+bool AnalyserJob::hasFailed()
+/*  Check whether analysis has failed.
+
+    return value (Boolean): true if the audio file could not be
+    analysed
+*/
+{
+    return strError.isNotEmpty();
+}
+
+
+String AnalyserJob::getReport(const int crest_factor)
+/*  Format analysis results.
+
+    crest_factor (integer): crest factor of the selected K-System
+    scale
+
+    return value (String): multi-line report
+*/
+{
+    String strReport = "File:         \"" + fileAudio.getFullPathName() + "\"\n";
+
+    if (hasFailed())
+    {
+        strReport += "Error:        " + strError + "\n";
+        return strReport;
+    }
+
+    String strCrestFactor = (crest_factor == 0) ? "Normal" : "K-" + String(crest_factor);
+    String strAlgorithm = (nAverageAlgorithm == KmeterPluginParameters::selAlgorithmItuBs1770) ? "ITU-R BS.1770-1" : "RMS";
+
+    strReport += "Format:       " + String(nNumberOfChannels) + " channel(s), " + String(nSampleRate) + " Hz, " + formatTime() + "\n";
+    strReport += "Meter:        " + strCrestFactor + ", " + strAlgorithm + "\n";
+    strReport += "\n";
+    strReport += "              peak   average  max. peak  overflows\n";
+
+    float fCrestFactor = float(crest_factor);
+    bool bItuBs1770 = (nAverageAlgorithm == KmeterPluginParameters::selAlgorithmItuBs1770);
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        float fMaximumPeakLevel = pStatistics->getMaximumPeakLevel(nChannel);
+
+        strReport += ("ch. " + String(nChannel + 1)).paddedRight(' ', 10);
+        strReport += formatValue(fCrestFactor + fMaximumPeakLevel, 8);
+
+        // in ITU-R BS.1770-1 mode, the loudness of all channels is
+        // reported on the first channel
+        if (bItuBs1770 && (nChannel > 0))
+        {
+            strReport += String("-").paddedLeft(' ', 10);
+        }
+        else
+        {
+            strReport += formatValue(fCrestFactor + pStatistics->getAverageLevel(nChannel), 10);
+        }
+
+        strReport += formatValue(fMaximumPeakLevel, 11);
+        strReport += String(pStatistics->getNumberOfOverflows(nChannel)).paddedLeft(' ', 11) + "\n";
+    }
+
+    strReport += "\n";
+
+    if (nNumberOfChannels == 2)
+    {
+        strReport += "Correlation:  " + formatValue(pStatistics->getPhaseCorrelation(), 0) + "\n";
+    }
+
+    if (bItuBs1770)
+    {
+        float fLoudness = pStatistics->getLoudnessHistogram().getIntegratedLoudness();
+
+        strReport += "Loudness:     " + formatValue(fLoudness, 0) + " LUFS (gated)\n";
+        strReport += "              " + formatValue(pStatistics->getAverageLevel(0), 0) + " LUFS (ungated)\n";
+    }
+
+    return strReport;
+}
+
+
+int64 AnalyserJob::getNumberOfChunks(const int64 length_in_samples)
+/*  Get number of chunks needed to analyse an audio file.  The meters
+    look (KMETER_BUFFER_SIZE / 2) samples into the past, so a chunk
+    of silence is appended to process the end of the file.
+
+    length_in_samples (64-bit integer): length of audio file
+
+    return value (64-bit integer): number of chunks of
+    KMETER_BUFFER_SIZE samples
+*/
+{
+    return (length_in_samples + 2 * KMETER_BUFFER_SIZE - 1) / KMETER_BUFFER_SIZE;
+}
+
+
+void AnalyserJob::addJobs(const File& fileAudio, const int average_algorithm, const int segment_length, ThreadPool& threadPool, OwnedArray<AnalyserJob>& arrJobs)
+/*  Split an audio file into segments and queue a job for each
+    segment.  The thread pool hands out jobs to whichever thread
+    becomes idle first; splitting long files into segments of equal
+    length keeps all threads busy, even when only a few files are
+    left.
+
+    fileAudio (const File&): audio file to be analysed
+
+    average_algorithm (integer): algorithm for calculating average
+    meter levels; must be one of the "selAlgorithm..."  values defined
+    in "plugin_parameters.h"
+
+    segment_length (integer): length of segments in seconds; pass 0
+    to analyse the file in one piece
+
+    threadPool (ThreadPool&): thread pool that runs the jobs
+
+    arrJobs (OwnedArray<AnalyserJob>&): new jobs are appended to this
+    array
+
+    return value: none
+*/
+{
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    ScopedPointer<AudioFormatReader> formatReader(formatManager.createReaderFor(fileAudio));
+
+    int64 nChunksInFile = -1;
+    int64 nChunksPerSegment = -1;
+
+    // files that cannot be opened are passed to a single job, which
+    // will report the error
+    if ((formatReader != NULL) && (segment_length > 0))
+    {
+        nChunksInFile = getNumberOfChunks(formatReader->lengthInSamples);
+        nChunksPerSegment = jmax((int64) 1, (int64)(segment_length * formatReader->sampleRate) / KMETER_BUFFER_SIZE);
+    }
+
+    if (nChunksPerSegment < 0)
+    {
+        AnalyserJob* pJob = new AnalyserJob(fileAudio, average_algorithm, 0, -1);
+
+        arrJobs.add(pJob);
+        threadPool.addJob(pJob, false);
+    }
+    else
+    {
+        for (int64 nFirstChunk = 0; nFirstChunk < nChunksInFile; nFirstChunk += nChunksPerSegment)
+        {
+            AnalyserJob* pJob = new AnalyserJob(fileAudio, average_algorithm, nFirstChunk, nChunksPerSegment);
+
+            arrJobs.add(pJob);
+            threadPool.addJob(pJob, false);
+        }
+    }
+}
+
+
+String AnalyserJob::formatTime(void)
+/*  Format length of audio file.
+
+    return value (String): length as "mm:ss.mmm"
+*/
+{
+    int64 nMilliSeconds = (1000 * nLengthInSamples) / nSampleRate;
+
+    int nTime = int(nMilliSeconds / 1000);
+    nMilliSeconds %= 1000;
+
+    String strMinutes = String(nTime / 60).paddedLeft('0', 2);
+    String strSeconds = String(nTime % 60).paddedLeft('0', 2);
+    String strMilliSeconds = String(nMilliSeconds).paddedLeft('0', 3);
+
+    return strMinutes + ":" + strSeconds + "." + strMilliSeconds;
+}
+
+
+String AnalyserJob::formatValue(const float fValue, const int nWidth)
+/*  Format level for output in a table.
+
+    fValue (float): level in decibels
+
+    nWidth (integer): pad level with spaces to this width
+
+    return value (String): formatted level
+*/
+{
+    String strValue;
+
+    if (fValue < 0.0f)
+    {
+        strValue = String(fValue, 2);
+    }
+    else
+    {
+        strValue = "+" + String(fValue, 2);
+    }
+
+    return strValue.paddedLeft(' ', nWidth);
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
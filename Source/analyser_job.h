@@ -0,0 +1,97 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __ANALYSER_JOB_H__
+#define __ANALYSER_JOB_H__
+
+class AnalyserJob;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "audio_ring_buffer.h"
+#include "channel_layout.h"
+#include "mapped_wav_reader.h"
+#include "meter_analyser.h"
+#include "meter_statistics.h"
+
+
+//==============================================================================
+/**
+*/
+class AnalyserJob : public ThreadPoolJob, public AudioRingBufferCallback
+{
+public:
+    AnalyserJob(const File audioFile, const int average_algorithm, const int64 first_chunk, const int64 number_of_chunks);
+    ~AnalyserJob();
+
+    JobStatus runJob();
+    void processBufferChunk(AudioSampleBuffer& buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples);
+
+    void mergeResults(const AnalyserJob& other);
+    const MeterStatistics* getStatistics();
+
+    bool hasFailed();
+    String getReport(const int crest_factor);
+
+    static int64 getNumberOfChunks(const int64 length_in_samples);
+    static void addJobs(const File& fileAudio, const int average_algorithm, const int segment_length, ThreadPool& threadPool, OwnedArray<AnalyserJob>& arrJobs);
+
+private:
+    JUCE_LEAK_DETECTOR(AnalyserJob);
+
+    File fileAudio;
+    String strError;
+
+    int nAverageAlgorithm;
+
+    int nNumberOfChannels;
+    int nSampleRate;
+    int64 nLengthInSamples;
+
+    int64 nFirstChunk;
+    int64 nNumberOfChunks;
+    int64 nCurrentChunk;
+
+    MeterAnalyser* pMeterAnalyser;
+    AudioRingBuffer* pRingBuffer;
+
+    MeterStatistics* pStatistics;
+
+    int nBlockChunks;
+    int nBlockStep;
+    double* dChunkEnergies;
+
+    void deleteBuffers();
+
+    String formatTime(void);
+    String formatValue(const float fValue, const int nWidth);
+};
+
+
+#endif  // __ANALYSER_JOB_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
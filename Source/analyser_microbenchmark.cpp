@@ -0,0 +1,277 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "analyser_microbenchmark.h"
+
+
+// channel counts and chunk sizes to be benchmarked
+static const int arrChannels[] = {1, 2, 6, 8, 16};
+static const int arrChunkSizes[] = {256, 512, 1024, 2048, 4096};
+
+// samples per channel for each measurement (about 22 seconds at
+// 48 kHz), plus a few chunks for warming up caches and FFTW
+static const int nSamplesPerMeasurement = 1048576;
+static const int nWarmUpIterations = 4;
+
+
+AnalyserMicrobenchmark::AnalyserMicrobenchmark()
+/*  Constructor.  Measures the cost of the metering building blocks in
+    isolation and prints the results as JSON, so that changes in
+    performance can be tracked over time without loading the plug-in
+    into a host.
+
+    return value: none
+*/
+{
+    nSampleRate = 48000;
+
+    fSink = 0.0f;
+}
+
+
+AnalyserMicrobenchmark::~AnalyserMicrobenchmark()
+{
+}
+
+
+int AnalyserMicrobenchmark::run()
+/*  Benchmark all components for all channel counts and chunk sizes.
+
+    return value (integer): exit code (always 0)
+*/
+{
+    StringArray arrResults;
+
+    for (int nChannelIndex = 0; nChannelIndex < numElementsInArray(arrChannels); nChannelIndex++)
+    {
+        int nChannels = arrChannels[nChannelIndex];
+
+        for (int nChunkIndex = 0; nChunkIndex < numElementsInArray(arrChunkSizes); nChunkIndex++)
+        {
+            int nChunkSize = arrChunkSizes[nChunkIndex];
+
+            arrResults.add(formatResult("audio_ring_buffer", nChannels, nChunkSize, benchmarkRingBuffer(nChannels, nChunkSize)));
+            arrResults.add(formatResult("average_level_filtered_rms", nChannels, nChunkSize, benchmarkAverageLevelFiltered(nChannels, nChunkSize, KmeterPluginParameters::selAlgorithmRms)));
+            arrResults.add(formatResult("average_level_filtered_itu", nChannels, nChunkSize, benchmarkAverageLevelFiltered(nChannels, nChunkSize, KmeterPluginParameters::selAlgorithmItuBs1770)));
+            arrResults.add(formatResult("meter_ballistics", nChannels, nChunkSize, benchmarkMeterBallistics(nChannels, nChunkSize)));
+        }
+    }
+
+    ConsoleOutput::printMessage("{");
+    ConsoleOutput::printMessage("  \"version\": \"" + String(ProjectInfo::versionString) + "\",");
+    ConsoleOutput::printMessage("  \"sample_rate\": " + String(nSampleRate) + ",");
+    ConsoleOutput::printMessage("  \"results\": [");
+    ConsoleOutput::printMessage(arrResults.joinIntoString(",\n"));
+    ConsoleOutput::printMessage("  ]");
+    ConsoleOutput::printMessage("}");
+
+    return 0;
+}
+
+
+double AnalyserMicrobenchmark::benchmarkRingBuffer(const int channels, const int chunk_size)
+/*  Benchmark writing a chunk to the ring buffer and reading peak and
+    RMS levels back, just like the meter analyser does.
+
+    channels (integer): number of audio channels
+
+    chunk_size (integer): number of samples per chunk
+
+    return value (double): processing time in nanoseconds per sample
+*/
+{
+    AudioRingBuffer ringBuffer("Benchmark ring buffer", channels, chunk_size, chunk_size, chunk_size);
+    AudioSampleBuffer sampleBuffer(channels, chunk_size);
+
+    // fixed seed, so that all runs process the same signal
+    SignalGenerator signalGenerator(SignalGenerator::signalPinkNoise, nSampleRate, 1);
+    signalGenerator.fillBuffer(sampleBuffer, 0, chunk_size);
+
+    unsigned int uPreDelay = chunk_size / 2;
+    int nIterations = getNumberOfIterations(chunk_size);
+    int64 nTicksStart = 0;
+
+    for (int nIteration = -nWarmUpIterations; nIteration < nIterations; nIteration++)
+    {
+        if (nIteration == 0)
+        {
+            nTicksStart = Time::getHighResolutionTicks();
+        }
+
+        ringBuffer.addSamples(sampleBuffer, 0, chunk_size);
+
+        for (int nChannel = 0; nChannel < channels; nChannel++)
+        {
+            fSink = ringBuffer.getMagnitude(nChannel, chunk_size, uPreDelay);
+            fSink = ringBuffer.getRMSLevel(nChannel, chunk_size, uPreDelay);
+        }
+    }
+
+    return getNanosecondsPerSample(Time::getHighResolutionTicks() - nTicksStart, nIterations, channels, chunk_size);
+}
+
+
+double AnalyserMicrobenchmark::benchmarkAverageLevelFiltered(const int channels, const int chunk_size, const int average_algorithm)
+/*  Benchmark copying a chunk from the ring buffer and filtering it.
+
+    channels (integer): number of audio channels
+
+    chunk_size (integer): number of samples per chunk
+
+    average_algorithm (integer): algorithm for calculating average
+    meter levels; must be one of the "selAlgorithm..."  values defined
+    in "plugin_parameters.h"
+
+    return value (double): processing time in nanoseconds per sample
+*/
+{
+    AudioRingBuffer ringBuffer("Benchmark ring buffer", channels, chunk_size, chunk_size, chunk_size);
+    AudioSampleBuffer sampleBuffer(channels, chunk_size);
+
+    // fixed seed, so that all runs process the same signal
+    SignalGenerator signalGenerator(SignalGenerator::signalPinkNoise, nSampleRate, 1);
+    signalGenerator.fillBuffer(sampleBuffer, 0, chunk_size);
+
+    // the ring buffer is not part of this measurement
+    ringBuffer.addSamples(sampleBuffer, 0, chunk_size);
+
+    AverageLevelFiltered averageLevelFiltered(channels, chunk_size, nSampleRate, average_algorithm);
+    int nIterations = getNumberOfIterations(chunk_size);
+    int64 nTicksStart = 0;
+
+    for (int nIteration = -nWarmUpIterations; nIteration < nIterations; nIteration++)
+    {
+        if (nIteration == 0)
+        {
+            nTicksStart = Time::getHighResolutionTicks();
+        }
+
+        averageLevelFiltered.copyFromBuffer(ringBuffer, 0, nSampleRate);
+
+        // channel 0 filters all channels in ITU-R mode
+        for (int nChannel = 0; nChannel < channels; nChannel++)
+        {
+            fSink = averageLevelFiltered.getLevel(nChannel);
+        }
+    }
+
+    return getNanosecondsPerSample(Time::getHighResolutionTicks() - nTicksStart, nIterations, channels, chunk_size);
+}
+
+
+double AnalyserMicrobenchmark::benchmarkMeterBallistics(const int channels, const int chunk_size)
+/*  Benchmark updating meter ballistics once per chunk.  The cost
+    does not depend on the number of samples in a chunk, so larger
+    chunks are cheaper per sample.
+
+    channels (integer): number of audio channels
+
+    chunk_size (integer): number of samples per chunk
+
+    return value (double): processing time in nanoseconds per sample
+*/
+{
+    MeterBallistics meterBallistics(channels, KmeterPluginParameters::selAlgorithmItuBs1770, false, false);
+
+    // pre-computed random levels, so that the random number
+    // generator is not part of this measurement
+    const int nLevels = 1024;
+    HeapBlock<float> arrLevels(nLevels);
+    Random random(1);
+
+    for (int nLevel = 0; nLevel < nLevels; nLevel++)
+    {
+        arrLevels[nLevel] = random.nextFloat();
+    }
+
+    float fTimePassed = float(chunk_size) / float(nSampleRate);
+    int nIterations = getNumberOfIterations(chunk_size);
+    int nLevel = 0;
+    int64 nTicksStart = 0;
+
+    for (int nIteration = -nWarmUpIterations; nIteration < nIterations; nIteration++)
+    {
+        if (nIteration == 0)
+        {
+            nTicksStart = Time::getHighResolutionTicks();
+        }
+
+        for (int nChannel = 0; nChannel < channels; nChannel++)
+        {
+            float fLevel = arrLevels[nLevel];
+            nLevel = (nLevel + 1) % nLevels;
+
+            float fAverageFiltered = MeterBallistics::level2decibel(fLevel);
+            meterBallistics.updateChannel(nChannel, fTimePassed, fLevel, fLevel * 0.5f, fAverageFiltered, 0);
+        }
+
+        if (channels == 2)
+        {
+            meterBallistics.setStereoMeterValue(fTimePassed, arrLevels[nLevel] * 2.0f - 1.0f);
+            meterBallistics.setPhaseCorrelation(fTimePassed, arrLevels[nLevel] * 2.0f - 1.0f);
+        }
+
+        fSink = meterBallistics.getAverageMeterLevel(0);
+    }
+
+    return getNanosecondsPerSample(Time::getHighResolutionTicks() - nTicksStart, nIterations, channels, chunk_size);
+}
+
+
+int AnalyserMicrobenchmark::getNumberOfIterations(const int chunk_size)
+{
+    return jmax(1, nSamplesPerMeasurement / chunk_size);
+}
+
+
+double AnalyserMicrobenchmark::getNanosecondsPerSample(const int64 ticks, const int iterations, const int channels, const int chunk_size)
+/*  Convert processing time to nanoseconds per sample.
+
+    ticks (64-bit integer): processing time in high-resolution ticks
+
+    iterations (integer): number of processed chunks
+
+    channels (integer): number of audio channels
+
+    chunk_size (integer): number of samples per chunk
+
+    return value (double): processing time in nanoseconds per sample
+    (each channel counts separately)
+*/
+{
+    double dSamples = double(iterations) * channels * chunk_size;
+    return Time::highResolutionTicksToSeconds(ticks) * 1.0e9 / dSamples;
+}
+
+
+String AnalyserMicrobenchmark::formatResult(const String& strComponent, const int channels, const int chunk_size, const double ns_per_sample)
+{
+    return "    {\"component\": \"" + strComponent + "\", \"channels\": " + String(channels) + ", \"chunk_size\": " + String(chunk_size) + ", \"ns_per_sample\": " + String(ns_per_sample, 3) + "}";
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,75 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __ANALYSER_MICROBENCHMARK_H__
+#define __ANALYSER_MICROBENCHMARK_H__
+
+class AnalyserMicrobenchmark;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "audio_ring_buffer.h"
+#include "average_level_filtered.h"
+#include "console_output.h"
+#include "meter_ballistics.h"
+#include "plugin_parameters.h"
+#include "signal_generator.h"
+
+
+//==============================================================================
+/**
+*/
+class AnalyserMicrobenchmark
+{
+public:
+    AnalyserMicrobenchmark();
+    ~AnalyserMicrobenchmark();
+
+    int run();
+
+private:
+    JUCE_LEAK_DETECTOR(AnalyserMicrobenchmark);
+
+    double benchmarkRingBuffer(const int channels, const int chunk_size);
+    double benchmarkAverageLevelFiltered(const int channels, const int chunk_size, const int average_algorithm);
+    double benchmarkMeterBallistics(const int channels, const int chunk_size);
+
+    int getNumberOfIterations(const int chunk_size);
+    double getNanosecondsPerSample(const int64 ticks, const int iterations, const int channels, const int chunk_size);
+
+    String formatResult(const String& strComponent, const int channels, const int chunk_size, const double ns_per_sample);
+
+    int nSampleRate;
+
+    // keeps the compiler from optimising away unused readings
+    volatile float fSink;
+};
+
+
+#endif  // __ANALYSER_MICROBENCHMARK_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,237 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "audio_file_decoder.h"
+
+
+AudioFileDecoder::AudioFileDecoder(AudioFileDecoderCallback* callback_class, const int channels, const int block_size, const int number_of_blocks)
+    : Thread("K-Meter audio file decoder")
+/*  Constructor.  Decodes audio on a background thread into a queue
+    of preallocated blocks, so that the audio thread never has to
+    wait for the disk or for a decoder.  The queue has a single
+    producer (the decoder thread) and a single consumer (the audio
+    thread) and is lock-free.
+
+    callback_class (AudioFileDecoderCallback*): class that decodes
+    audio into the blocks
+
+    channels (integer): number of audio channels
+
+    block_size (integer): number of samples per block
+
+    number_of_blocks (integer): number of blocks in queue
+
+    return value: none
+*/
+{
+    jassert(callback_class != NULL);
+    jassert(channels > 0);
+    jassert(block_size > 0);
+    jassert(number_of_blocks > 1);
+
+    pCallbackClass = callback_class;
+
+    nNumberOfChannels = channels;
+    nBlockSize = block_size;
+    nBlockOffset = 0;
+
+    // one block of audio lasts at least 5 ms (at 192 kHz, and more
+    // at lower sample rates), so check for free blocks a little more
+    // often than that
+    nWaitTime = 2;
+
+    nUnderruns = 0;
+    nUnderrunSamples = 0;
+
+    // all memory is allocated up front
+    pFifo = new AbstractFifo(number_of_blocks);
+    pBlocks = new AudioSampleBuffer(nNumberOfChannels, nBlockSize * number_of_blocks);
+    pBlocks->clear();
+}
+
+
+AudioFileDecoder::~AudioFileDecoder()
+{
+    // decoding checks for this after every block, so the thread
+    // should exit almost immediately
+    stopThread(5000);
+
+    delete pFifo;
+    pFifo = NULL;
+
+    delete pBlocks;
+    pBlocks = NULL;
+}
+
+
+void AudioFileDecoder::prefill()
+/*  Fill all free blocks on the calling thread.  Call this before
+    starting the thread to avoid underruns at the start of playback.
+
+    return value: none
+*/
+{
+    jassert(!isThreadRunning());
+
+    while (decodeNextBlock())
+    {
+        // fill queue
+    }
+}
+
+
+bool AudioFileDecoder::decodeNextBlock()
+/*  Decode audio into the next free block.  Runs on the decoder
+    thread only.
+
+    return value (Boolean): false if the queue is full
+*/
+{
+    int nStart1, nSize1, nStart2, nSize2;
+    pFifo->prepareToWrite(1, nStart1, nSize1, nStart2, nSize2);
+
+    if (nSize1 < 1)
+    {
+        return false;
+    }
+
+    pCallbackClass->decodeBlock(*pBlocks, nStart1 * nBlockSize, nBlockSize);
+    pFifo->finishedWrite(1);
+
+    return true;
+}
+
+
+void AudioFileDecoder::run()
+/*  Keep the queue filled until the thread is stopped.
+
+    return value: none
+*/
+{
+    while (!threadShouldExit())
+    {
+        if (!decodeNextBlock())
+        {
+            // the audio thread must not be held up by signalling the
+            // decoder, so poll for free blocks instead
+            wait(nWaitTime);
+        }
+    }
+}
+
+
+int AudioFileDecoder::readSamples(AudioSampleBuffer& destination, const int destStartSample, const int numSamples)
+/*  Copy decoded audio from the queue.  Runs on the audio thread and
+    neither locks nor allocates memory.  If the decoder has fallen
+    behind, missing samples are replaced by silence and the underrun
+    is counted.  Surplus channels of the destination buffer are
+    cleared.
+
+    destination (AudioSampleBuffer&): buffer receiving the samples
+
+    destStartSample (integer): first sample in destination buffer
+
+    numSamples (integer): number of samples to copy
+
+    return value (integer): number of samples copied from the queue
+*/
+{
+    int nChannels = jmin(nNumberOfChannels, destination.getNumChannels());
+    int nSamplesCopied = 0;
+
+    while (nSamplesCopied < numSamples)
+    {
+        int nStart1, nSize1, nStart2, nSize2;
+        pFifo->prepareToRead(1, nStart1, nSize1, nStart2, nSize2);
+
+        if (nSize1 < 1)
+        {
+            break;
+        }
+
+        int nSamplesToCopy = jmin(numSamples - nSamplesCopied, nBlockSize - nBlockOffset);
+        int nSourceStartSample = nStart1 * nBlockSize + nBlockOffset;
+
+        for (int nChannel = 0; nChannel < nChannels; nChannel++)
+        {
+            destination.copyFrom(nChannel, destStartSample + nSamplesCopied, *pBlocks, nChannel, nSourceStartSample, nSamplesToCopy);
+        }
+
+        nSamplesCopied += nSamplesToCopy;
+        nBlockOffset += nSamplesToCopy;
+
+        // hand block back to the decoder
+        if (nBlockOffset >= nBlockSize)
+        {
+            nBlockOffset = 0;
+            pFifo->finishedRead(1);
+        }
+    }
+
+    if (nSamplesCopied < numSamples)
+    {
+        nUnderruns++;
+        nUnderrunSamples += numSamples - nSamplesCopied;
+
+        for (int nChannel = 0; nChannel < nChannels; nChannel++)
+        {
+            destination.clear(nChannel, destStartSample + nSamplesCopied, numSamples - nSamplesCopied);
+        }
+    }
+
+    for (int nChannel = nChannels; nChannel < destination.getNumChannels(); nChannel++)
+    {
+        destination.clear(nChannel, destStartSample, numSamples);
+    }
+
+    return nSamplesCopied;
+}
+
+
+int AudioFileDecoder::getNumberOfUnderruns()
+/*  Get number of calls to readSamples() that could not be satisfied
+    from the queue.
+
+    return value (integer): number of underruns
+*/
+{
+    return nUnderruns;
+}
+
+
+int64 AudioFileDecoder::getNumberOfUnderrunSamples()
+/*  Get number of samples that were replaced by silence because the
+    decoder had fallen behind.
+
+    return value (64-bit integer): number of missing samples
+*/
+{
+    return nUnderrunSamples;
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,90 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __AUDIO_FILE_DECODER_H__
+#define __AUDIO_FILE_DECODER_H__
+
+class AudioFileDecoder;
+class AudioFileDecoderCallback;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+
+//==============================================================================
+/**
+*/
+class AudioFileDecoderCallback
+{
+public:
+    virtual ~AudioFileDecoderCallback() {};
+
+    // called on the decoder thread whenever a free block has to be
+    // filled with "numSamples" samples of audio
+    virtual void decodeBlock(AudioSampleBuffer& buffer, const int startSample, const int numSamples) = 0;
+};
+
+
+//==============================================================================
+/**
+*/
+class AudioFileDecoder : public Thread
+{
+public:
+    AudioFileDecoder(AudioFileDecoderCallback* callback_class, const int channels, const int block_size, const int number_of_blocks);
+    ~AudioFileDecoder();
+
+    void prefill();
+    int readSamples(AudioSampleBuffer& destination, const int destStartSample, const int numSamples);
+
+    int getNumberOfUnderruns();
+    int64 getNumberOfUnderrunSamples();
+
+    void run();
+
+private:
+    JUCE_LEAK_DETECTOR(AudioFileDecoder);
+
+    bool decodeNextBlock();
+
+    AudioFileDecoderCallback* pCallbackClass;
+    AbstractFifo* pFifo;
+    AudioSampleBuffer* pBlocks;
+
+    int nNumberOfChannels;
+    int nBlockSize;
+    int nBlockOffset;
+    int nWaitTime;
+
+    int nUnderruns;
+    int64 nUnderrunSamples;
+};
+
+
+#endif  // __AUDIO_FILE_DECODER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -26,7 +26,23 @@
 #include "audio_file_player.h"
 
 
-AudioFilePlayer::AudioFilePlayer(const File audioFile, int sample_rate, MeterBallistics* meter_ballistics, int crest_factor)
+AudioFilePlayer::AudioFilePlayer(const File audioFile, int sample_rate, MeterBallistics* meter_ballistics, int crest_factor, bool background_decoding)
+/*  Constructor.
+
+    audioFile (File): audio file to be played
+
+    sample_rate (integer): sample rate of the host
+
+    meter_ballistics (MeterBallistics*): meters to be reported
+
+    crest_factor (integer): crest factor of the selected K-System
+    scale
+
+    background_decoding (Boolean): decode audio on a separate thread;
+    set this when fillBufferChunk() is called from the audio thread
+
+    return value: none
+*/
 {
     nReportChannel = -1;
     bReports = false;
@@ -41,6 +57,11 @@ AudioFilePlayer::AudioFilePlayer(const File audioFile, int sample_rate, MeterBal
     setCrestFactor(crest_factor);
 
     pMeterBallistics = meter_ballistics;
+    pReportStream = NULL;
+    pMeasurementLog = NULL;
+
+    nReportColumns = 0;
+    pReportValues = NULL;
 
     // try "300" for uncorrelated band-limited pink noise
     nSamplesMovingAverage = 50;
@@ -55,42 +76,86 @@ AudioFilePlayer::AudioFilePlayer(const File audioFile, int sample_rate, MeterBal
         pAverager_PeakMeterLevels[nChannel] = new Averager(nSamplesMovingAverage, fMeterMinimumDecibel);
     }
 
-    AudioFormatManager formatManager;
-    formatManager.registerBasicFormats();
+    audioFileSource = NULL;
+    pDecoder = NULL;
+    nReadPosition = 0;
+    nDecodePosition = 0;
+
+    int nFileChannels = 0;
+    int nFileSampleRate = 0;
+    int nFileBitsPerSample = 0;
 
-    AudioFormatReader* formatReader = formatManager.createReaderFor(audioFile);
+    // map large WAV files into memory; this avoids decoding on the
+    // audio thread and lets the operating system read ahead
+    pMappedReader = new MappedWavReader(audioFile);
 
-    if (formatReader)
+    if (pMappedReader->isValid())
     {
-        audioFileSource = new AudioFormatReaderSource(formatReader, true);
         bIsPlaying = true;
+        nNumberOfSamples = pMappedReader->getLengthInSamples();
+
+        nFileChannels = pMappedReader->getNumberOfChannels();
+        nFileSampleRate = pMappedReader->getSampleRate();
+        nFileBitsPerSample = pMappedReader->getBitsPerSample();
+    }
+    else
+    {
+        delete pMappedReader;
+        pMappedReader = NULL;
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        AudioFormatReader* formatReader = formatManager.createReaderFor(audioFile);
+
+        if (formatReader)
+        {
+            audioFileSource = new AudioFormatReaderSource(formatReader, true);
+            bIsPlaying = true;
 
-        nNumberOfSamples = audioFileSource->getTotalLength();
+            nNumberOfSamples = audioFileSource->getTotalLength();
+
+            nFileChannels = (int) formatReader->numChannels;
+            nFileSampleRate = (int) formatReader->sampleRate;
+            nFileBitsPerSample = (int) formatReader->bitsPerSample;
+        }
+        else
+        {
+            bIsPlaying = false;
+            bReports = false;
+        }
+    }
+
+    if (bIsPlaying)
+    {
         // pause for ten seconds after playback
         nNumberOfSamples += 10 * sample_rate;
 
         outputMessage("Audio file: \"" + audioFile.getFullPathName() + "\"");
-        outputMessage(String(formatReader->numChannels) + " channel(s), " + String(formatReader->sampleRate) + " Hz, " + String(formatReader->bitsPerSample) + " bit");
+        outputMessage(String(nFileChannels) + " channel(s), " + String(nFileSampleRate) + " Hz, " + String(nFileBitsPerSample) + " bit");
 
-        fSampleRate = (float) formatReader->sampleRate;
+        fSampleRate = (float) nFileSampleRate;
 
-        if (formatReader->sampleRate != sample_rate)
+        if (nFileSampleRate != sample_rate)
         {
             outputMessage(String::empty);
             outputMessage("WARNING: sample rate mismatch (host: " + String(sample_rate) + " Hz)!");
             outputMessage(String::empty);
         }
 
+        // keep decoding off the audio thread; the queue holds about
+        // three seconds of audio at 44.1 kHz
+        if (background_decoding)
+        {
+            pDecoder = new AudioFileDecoder(this, nNumberOfChannels, 4096, 32);
+            pDecoder->prefill();
+            pDecoder->startThread();
+        }
+
         outputMessage(String::empty);
         outputMessage("Starting validation ...");
         outputMessage(String::empty);
     }
-    else
-    {
-        audioFileSource = NULL;
-        bIsPlaying = false;
-        bReports = false;
-    }
 }
 
 
@@ -99,11 +164,31 @@ AudioFilePlayer::~AudioFilePlayer()
     if (isPlaying())
     {
         outputMessage("Stopping validation ...");
+        outputDecoderStatistics();
+        outputMeasurementLogStatistics();
     }
 
+    // stop decoder thread before deleting the audio sources
+    delete pDecoder;
+    pDecoder = NULL;
+
     delete audioFileSource;
     audioFileSource = NULL;
 
+    delete pMappedReader;
+    pMappedReader = NULL;
+
+    // flushes and closes report file
+    delete pReportStream;
+    pReportStream = NULL;
+
+    // writes queued rows and closes log file
+    delete pMeasurementLog;
+    pMeasurementLog = NULL;
+
+    delete [] pReportValues;
+    pReportValues = NULL;
+
     for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
     {
         delete pAverager_AverageMeterLevels[nChannel];
@@ -157,6 +242,43 @@ void AudioFilePlayer::setReporters(int nChannel, bool ReportCSV, bool bAverageMe
     bReportPhaseCorrelation = bPhaseCorrelation;
 
     bReports = bReportAverageMeterLevel || bReportPeakMeterLevel || bReportMaximumPeakLevel || bReportStereoMeterValue || bReportPhaseCorrelation;
+
+    // allocate memory for meter readings here, as reports are created
+    // on the audio thread
+    delete [] pReportValues;
+
+    nReportColumns = getReportColumns().size();
+    pReportValues = new float[jmax(1, nReportColumns)];
+}
+
+
+bool AudioFilePlayer::setReportFile(const File& reportFile)
+{
+    delete pReportStream;
+    pReportStream = NULL;
+
+    // reports will be written to the debug log
+    if (reportFile == File::nonexistent)
+    {
+        return true;
+    }
+
+    // "FileOutputStream" appends to existing files, so remove old
+    // reports first
+    reportFile.deleteFile();
+    pReportStream = new FileOutputStream(reportFile);
+
+    if (pReportStream->failedToOpen())
+    {
+        delete pReportStream;
+        pReportStream = NULL;
+
+        outputMessage("WARNING: could not open report file \"" + reportFile.getFullPathName() + "\"");
+        return false;
+    }
+
+    outputMessage("Report file: \"" + reportFile.getFullPathName() + "\"");
+    return true;
 }
 
 
@@ -164,13 +286,15 @@ bool AudioFilePlayer::isPlaying()
 {
     if (bIsPlaying)
     {
-        if (audioFileSource->getNextReadPosition() < nNumberOfSamples)
+        if (nReadPosition < nNumberOfSamples)
         {
             return true;
         }
         else
         {
             outputMessage("Stopping validation ...");
+            outputDecoderStatistics();
+            outputMeasurementLogStatistics();
 
             bIsPlaying = false;
             bReports = false;
@@ -189,7 +313,11 @@ void AudioFilePlayer::fillBufferChunk(AudioSampleBuffer* buffer)
     // report old meter readings
     if (bReports)
     {
-        if (bReportCSV)
+        if (pMeasurementLog)
+        {
+            outputMeasurementLogRow();
+        }
+        else if (bReportCSV)
         {
             outputReportCSVLine();
         }
@@ -200,15 +328,71 @@ void AudioFilePlayer::fillBufferChunk(AudioSampleBuffer* buffer)
     }
 
     if (isPlaying())
+    {
+        int nNumSamples = buffer->getNumSamples();
+
+        if (pDecoder)
+        {
+            // never blocks; samples that have not been decoded in time
+            // are replaced by silence and played later
+            nReadPosition += pDecoder->readSamples(*buffer, 0, nNumSamples);
+        }
+        else
+        {
+            decodeBlock(*buffer, 0, nNumSamples);
+            nReadPosition += nNumSamples;
+        }
+    }
+}
+
+
+void AudioFilePlayer::decodeBlock(AudioSampleBuffer& buffer, const int startSample, const int numSamples)
+/*  Read the next samples from the audio file.  Samples after the end
+    of the file read as silence.
+
+    buffer (AudioSampleBuffer&): buffer receiving the samples
+
+    startSample (integer): first sample in buffer
+
+    numSamples (integer): number of samples to read
+
+    return value: none
+*/
+{
+    if (pMappedReader)
+    {
+        pMappedReader->readToBuffer(buffer, startSample, nDecodePosition, numSamples);
+    }
+    else
     {
         AudioSourceChannelInfo channelInfo;
-        channelInfo.buffer = buffer;
-        channelInfo.startSample = 0;
-        channelInfo.numSamples = buffer->getNumSamples();
+        channelInfo.buffer = &buffer;
+        channelInfo.startSample = startSample;
+        channelInfo.numSamples = numSamples;
 
         channelInfo.clearActiveBufferRegion();
         audioFileSource->getNextAudioBlock(channelInfo);
     }
+
+    nDecodePosition += numSamples;
+}
+
+
+void AudioFilePlayer::outputDecoderStatistics(void)
+{
+    if (pDecoder && (pDecoder->getNumberOfUnderruns() > 0))
+    {
+        outputMessage("WARNING: decoder fell behind " + String(pDecoder->getNumberOfUnderruns()) + " time(s), " + String(pDecoder->getNumberOfUnderrunSamples()) + " sample(s) were delayed");
+    }
+}
+
+
+void AudioFilePlayer::outputMeasurementLogStatistics(void)
+{
+    if (pMeasurementLog && (pMeasurementLog->getNumberOfDroppedRows() > 0))
+    {
+        outputMessage("WARNING: measurement log fell behind, " + String(pMeasurementLog->getNumberOfDroppedRows()) + " row(s) were dropped");
+    }
 }
 
 
@@ -293,14 +477,60 @@ void AudioFilePlayer::outputReportPlain(void)
         outputValue(fPhaseCorrelation, NULL, strPrefix, strSuffix);
     }
 
-    outputMessage(String::empty);
+    outputReport(formatMessage(String::empty));
 }
 
 
-void AudioFilePlayer::outputReportCSVHeader(void)
+bool AudioFilePlayer::setMeasurementLog(const File& logFile, const bool realtime)
+/*  Write meter readings to a binary log file instead of text
+    reports.  This is much cheaper than formatting text on the audio
+    thread.  Please call this after setReporters().
+
+    logFile (const File&): log file; pass File::nonexistent to write
+    text reports instead
+
+    realtime (Boolean): readings are reported from the audio thread,
+    so queue them and write them on a background thread (rows are
+    dropped if the writer falls behind); otherwise, write them
+    directly so that none are lost
+
+    return value (Boolean): false if the log file could not be opened
+*/
 {
-    bHeaderIsWritten = true;
-    String strOutput = "\"timecode\"\t";
+    delete pMeasurementLog;
+    pMeasurementLog = NULL;
+
+    // audio file may not have been opened
+    if ((logFile == File::nonexistent) || (nReportColumns < 1) || !bIsPlaying)
+    {
+        return true;
+    }
+
+    // the queue holds several seconds of meter readings
+    pMeasurementLog = new MeasurementLog(logFile, getReportColumns(), (int) fSampleRate, 4096, realtime);
+
+    if (!pMeasurementLog->isOpen())
+    {
+        delete pMeasurementLog;
+        pMeasurementLog = NULL;
+
+        outputMessage("WARNING: could not open log file \"" + logFile.getFullPathName() + "\"");
+        return false;
+    }
+
+    outputMessage("Log file: \"" + logFile.getFullPathName() + "\"");
+    return true;
+}
+
+
+StringArray AudioFilePlayer::getReportColumns(void)
+/*  Get names of the reported meter readings, in the order of
+    getReportValues().
+
+    return value (StringArray): column names
+*/
+{
+    StringArray arrColumns;
 
     if (bReportAverageMeterLevel)
     {
@@ -308,12 +538,12 @@ void AudioFilePlayer::outputReportCSVHeader(void)
         {
             for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
             {
-                strOutput += "\"avg_" + String(nChannel + 1) + "\"\t";
+                arrColumns.add("avg_" + String(nChannel + 1));
             }
         }
         else
         {
-            strOutput += "\"avg_" + String(nReportChannel + 1) + "\"\t";
+            arrColumns.add("avg_" + String(nReportChannel + 1));
         }
     }
 
@@ -323,12 +553,12 @@ void AudioFilePlayer::outputReportCSVHeader(void)
         {
             for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
             {
-                strOutput += "\"peak_" + String(nChannel + 1) + "\"\t";
+                arrColumns.add("peak_" + String(nChannel + 1));
             }
         }
         else
         {
-            strOutput += "\"peak_" + String(nReportChannel + 1) + "\"\t";
+            arrColumns.add("peak_" + String(nReportChannel + 1));
         }
     }
 
@@ -338,37 +568,39 @@ void AudioFilePlayer::outputReportCSVHeader(void)
         {
             for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
             {
-                strOutput += "\"max_" + String(nChannel + 1) + "\"\t";
+                arrColumns.add("max_" + String(nChannel + 1));
             }
         }
         else
         {
-            strOutput += "\"max_" + String(nReportChannel + 1) + "\"\t";
+            arrColumns.add("max_" + String(nReportChannel + 1));
         }
     }
 
     if (bReportStereoMeterValue)
     {
-        strOutput += "\"stereo\"\t";
+        arrColumns.add("stereo");
     }
 
     if (bReportPhaseCorrelation)
     {
-        strOutput += "\"corr\"\t";
+        arrColumns.add("corr");
     }
 
-    Logger::outputDebugString(strOutput);
+    return arrColumns;
 }
 
 
-void AudioFilePlayer::outputReportCSVLine(void)
-{
-    String strOutput;
+void AudioFilePlayer::getReportValues(float* values)
+/*  Get reported meter readings.  Neither locks nor allocates memory.
 
-    if (!bHeaderIsWritten)
-    {
-        outputReportCSVHeader();
-    }
+    values (float*): array receiving the meter readings; must hold
+    one value per column (see getReportColumns())
+
+    return value: none
+*/
+{
+    int nColumn = 0;
 
     if (bReportAverageMeterLevel)
     {
@@ -376,14 +608,12 @@ void AudioFilePlayer::outputReportCSVLine(void)
         {
             for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
             {
-                float fAverageMeterLevel = fCrestFactor + pMeterBallistics->getAverageMeterLevel(nChannel);
-                strOutput += formatValue(fAverageMeterLevel);
+                values[nColumn++] = fCrestFactor + pMeterBallistics->getAverageMeterLevel(nChannel);
             }
         }
         else
         {
-            float fAverageMeterLevel = fCrestFactor + pMeterBallistics->getAverageMeterLevel(nReportChannel);
-            strOutput += formatValue(fAverageMeterLevel);
+            values[nColumn++] = fCrestFactor + pMeterBallistics->getAverageMeterLevel(nReportChannel);
         }
     }
 
@@ -393,14 +623,12 @@ void AudioFilePlayer::outputReportCSVLine(void)
         {
             for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
             {
-                float fPeakMeterLevel = fCrestFactor + pMeterBallistics->getPeakMeterLevel(nChannel);
-                strOutput += formatValue(fPeakMeterLevel);
+                values[nColumn++] = fCrestFactor + pMeterBallistics->getPeakMeterLevel(nChannel);
             }
         }
         else
         {
-            float fPeakMeterLevel = fCrestFactor + pMeterBallistics->getPeakMeterLevel(nReportChannel);
-            strOutput += formatValue(fPeakMeterLevel);
+            values[nColumn++] = fCrestFactor + pMeterBallistics->getPeakMeterLevel(nReportChannel);
         }
     }
 
@@ -410,36 +638,78 @@ void AudioFilePlayer::outputReportCSVLine(void)
         {
             for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
             {
-                float fMaximumPeakLevel = fCrestFactor + pMeterBallistics->getMaximumPeakLevel(nChannel);
-                strOutput += formatValue(fMaximumPeakLevel);
+                values[nColumn++] = fCrestFactor + pMeterBallistics->getMaximumPeakLevel(nChannel);
             }
         }
         else
         {
-            float fMaximumPeakLevel = fCrestFactor + pMeterBallistics->getMaximumPeakLevel(nReportChannel);
-            strOutput += formatValue(fMaximumPeakLevel);
+            values[nColumn++] = fCrestFactor + pMeterBallistics->getMaximumPeakLevel(nReportChannel);
         }
     }
 
     if (bReportStereoMeterValue)
     {
-        float fStereoMeterValue = pMeterBallistics->getStereoMeterValue();
-        strOutput += formatValue(fStereoMeterValue);
+        values[nColumn++] = pMeterBallistics->getStereoMeterValue();
     }
 
     if (bReportPhaseCorrelation)
     {
-        float fPhaseCorrelation = pMeterBallistics->getPhaseCorrelation();
-        strOutput += formatValue(fPhaseCorrelation);
+        values[nColumn++] = pMeterBallistics->getPhaseCorrelation();
+    }
+}
+
+
+void AudioFilePlayer::outputReportCSVHeader(void)
+{
+    bHeaderIsWritten = true;
+    String strOutput = "\"timecode\"\t";
+
+    StringArray arrColumns = getReportColumns();
+
+    for (int nColumn = 0; nColumn < arrColumns.size(); nColumn++)
+    {
+        strOutput += arrColumns[nColumn].quoted() + "\t";
     }
 
-    Logger::outputDebugString("\"" + formatTime() + "\"\t" + strOutput);
+    outputReport(strOutput);
+}
+
+
+void AudioFilePlayer::outputReportCSVLine(void)
+{
+    getReportValues(pReportValues);
+    String strOutput;
+
+    if (!bHeaderIsWritten)
+    {
+        outputReportCSVHeader();
+    }
+
+    for (int nColumn = 0; nColumn < nReportColumns; nColumn++)
+    {
+        strOutput += formatValue(pReportValues[nColumn]);
+    }
+
+    outputReport("\"" + formatTime() + "\"\t" + strOutput);
+}
+
+
+void AudioFilePlayer::outputMeasurementLogRow(void)
+{
+    getReportValues(pReportValues);
+    pMeasurementLog->addRow(nReadPosition, pReportValues);
 }
 
 
 String AudioFilePlayer::formatTime(void)
 {
-    float fTime = audioFileSource->getNextReadPosition() / fSampleRate;
+    float fTime = 0.0f;
+
+    // audio file may not have been opened
+    if (audioFileSource || pMappedReader)
+    {
+        fTime = nReadPosition / fSampleRate;
+    }
 
     // check for NaN
     if (fTime != fTime)
@@ -509,14 +779,34 @@ void AudioFilePlayer::outputValue(const float fValue, Averager* pAverager, const
         }
     }
 
-    outputMessage(strPrefix + strValue + strSimpleMovingAverage);
+    outputReport(formatMessage(strPrefix + strValue + strSimpleMovingAverage));
+}
+
+
+String AudioFilePlayer::formatMessage(const String& strMessage)
+{
+    return "[Validation - " + formatTime() + "] " + strMessage;
 }
 
 
 void AudioFilePlayer::outputMessage(const String& strMessage)
 {
+    // status messages always go to the debug log so that report
+    // files only contain meter readings
+    Logger::outputDebugString(formatMessage(strMessage));
+}
 
-    Logger::outputDebugString("[Validation - " + formatTime() + "] " + strMessage);
+
+void AudioFilePlayer::outputReport(const String& strReport)
+{
+    if (pReportStream)
+    {
+        pReportStream->writeText(strReport + "\n", false, false);
+    }
+    else
+    {
+        Logger::outputDebugString(strReport);
+    }
 }
 
 
@@ -29,20 +29,26 @@
 class AudioFilePlayer;
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "audio_file_decoder.h"
 #include "averager.h"
+#include "mapped_wav_reader.h"
+#include "measurement_log.h"
 #include "meter_ballistics.h"
 
 
-class AudioFilePlayer
+class AudioFilePlayer : public AudioFileDecoderCallback
 {
 public:
-    AudioFilePlayer(const File audioFile, int sample_rate, MeterBallistics* meter_ballistics, int crest_factor);
+    AudioFilePlayer(const File audioFile, int sample_rate, MeterBallistics* meter_ballistics, int crest_factor, bool background_decoding);
     ~AudioFilePlayer();
 
     bool isPlaying();
     void fillBufferChunk(AudioSampleBuffer* buffer);
+    void decodeBlock(AudioSampleBuffer& buffer, const int startSample, const int numSamples);
     void setCrestFactor(int crest_factor);
     void setReporters(int nChannel, bool ReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel, bool bMaximumPeakLevel, bool bStereoMeterValue, bool bPhaseCorrelation);
+    bool setReportFile(const File& reportFile);
+    bool setMeasurementLog(const File& logFile, const bool realtime);
 
 private:
     JUCE_LEAK_DETECTOR(AudioFilePlayer);
@@ -69,18 +75,36 @@ private:
     Averager** pAverager_AverageMeterLevels;
     Averager** pAverager_PeakMeterLevels;
 
+    int nReportColumns;
+    float* pReportValues;
+
     AudioFormatReaderSource* audioFileSource;
+    MappedWavReader* pMappedReader;
+    AudioFileDecoder* pDecoder;
+    int64 nReadPosition;
+    int64 nDecodePosition;
+
     MeterBallistics* pMeterBallistics;
+    FileOutputStream* pReportStream;
+    MeasurementLog* pMeasurementLog;
 
+    void outputDecoderStatistics(void);
+    void outputMeasurementLogStatistics(void);
     void outputReportPlain(void);
+    StringArray getReportColumns(void);
+    void getReportValues(float* values);
+
     void outputReportCSVHeader(void);
     void outputReportCSVLine(void);
+    void outputMeasurementLogRow(void);
 
     String formatTime(void);
     String formatValue(const float fValue);
+    String formatMessage(const String& strMessage);
 
     void outputValue(const float fValue, Averager* pAverager, const String& strPrefix, const String& strSuffix);
     void outputMessage(const String& strMessage);
+    void outputReport(const String& strReport);
 };
 
 #endif   // __AUDIO_FILE_PLAYER__
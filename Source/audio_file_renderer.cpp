@@ -0,0 +1,223 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "audio_file_renderer.h"
+
+
+AudioFileRenderer::AudioFileRenderer(const File audioFile, const File reportFile, int channels, int buffer_size, int average_algorithm, int crest_factor, bool mono)
+    : Thread("K-Meter offline validation")
+/*  Constructor.
+
+    audioFile (File): audio file to be validated
+
+    reportFile (File): file receiving the validation report (or the
+    binary log); pass File::nonexistent to write the report to the
+    debug log
+
+    channels (integer): number of audio channels to be metered
+
+    buffer_size (integer): size of the audio chunks to be metered
+
+    average_algorithm (integer): algorithm for calculating average
+    meter levels; must be one of the "selAlgorithm..."  values defined
+    in "plugin_parameters.h"
+
+    crest_factor (integer): crest factor of the selected K-System
+    scale
+
+    mono (Boolean): mix stereo input down to mono before metering
+
+    return value: none
+*/
+{
+    jassert(channels > 0);
+
+    nNumberOfChannels = channels;
+    nBufferSize = buffer_size;
+    bMono = mono;
+
+    pCallbackClass = NULL;
+    pAudioFilePlayer = NULL;
+    pRingBuffer = NULL;
+    pMeterAnalyser = NULL;
+    pSampleBuffer = NULL;
+
+    // rendering runs at the sample rate of the audio file, so we need
+    // to peek into the file before setting up the meters
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    ScopedPointer<AudioFormatReader> formatReader(formatManager.createReaderFor(audioFile));
+
+    if (formatReader)
+    {
+        nSampleRate = (int) formatReader->sampleRate;
+    }
+    else
+    {
+        nSampleRate = 0;
+    }
+
+    formatReader = NULL;
+
+    if ((nSampleRate < 44100) || (nSampleRate > 192000))
+    {
+        Logger::outputDebugString("[K-Meter] WARNING: sample rate of " + String(nSampleRate) + " Hz not supported");
+        return;
+    }
+
+    pMeterAnalyser = new MeterAnalyser(nNumberOfChannels, nBufferSize, nSampleRate, average_algorithm);
+
+    pAudioFilePlayer = new AudioFilePlayer(audioFile, nSampleRate, pMeterAnalyser->getLevels(), crest_factor, false);
+    fileReport = reportFile;
+
+    pSampleBuffer = new AudioSampleBuffer(nNumberOfChannels, nBufferSize);
+
+    pRingBuffer = new AudioRingBuffer("Offline ring buffer", nNumberOfChannels, nBufferSize, nBufferSize, nBufferSize);
+    pRingBuffer->setCallbackClass(this);
+}
+
+
+AudioFileRenderer::~AudioFileRenderer()
+{
+    // rendering checks for this after every chunk, so the thread
+    // should exit almost immediately
+    stopThread(5000);
+
+    delete pAudioFilePlayer;
+    pAudioFilePlayer = NULL;
+
+    delete pRingBuffer;
+    pRingBuffer = NULL;
+
+    delete pMeterAnalyser;
+    pMeterAnalyser = NULL;
+
+    delete pSampleBuffer;
+    pSampleBuffer = NULL;
+}
+
+
+bool AudioFileRenderer::isRendering() const
+/*  Check whether the audio file is still being rendered.
+
+    return value (Boolean): false if rendering has finished or
+    failed
+*/
+{
+    return isThreadRunning();
+}
+
+
+void AudioFileRenderer::setCallbackClass(AudioFileRendererCallback* callback_class)
+/*  Set class to be notified when rendering has finished.  Please
+    call this before starting the thread.
+
+    callback_class (AudioFileRendererCallback*): class to be
+    notified; pass NULL to disable notification
+
+    return value: none
+*/
+{
+    pCallbackClass = callback_class;
+}
+
+
+void AudioFileRenderer::setReporters(int nChannel, bool ReportCSV, bool BinaryLog, bool bAverageMeterLevel, bool bPeakMeterLevel, bool bMaximumPeakLevel, bool bStereoMeterValue, bool bPhaseCorrelation)
+/*  Select meter readings to be reported and open the report file.
+    Binary logs (see MeasurementLog) are written on the rendering
+    thread, so no rows are lost when rendering outpaces the disk.
+    Please call this before starting the thread.
+
+    return value: none
+*/
+{
+    if (pAudioFilePlayer)
+    {
+        pAudioFilePlayer->setReporters(nChannel, ReportCSV, bAverageMeterLevel, bPeakMeterLevel, bMaximumPeakLevel, bStereoMeterValue, bPhaseCorrelation);
+
+        if (BinaryLog)
+        {
+            pAudioFilePlayer->setMeasurementLog(fileReport, false);
+        }
+        else
+        {
+            pAudioFilePlayer->setReportFile(fileReport);
+        }
+    }
+}
+
+
+void AudioFileRenderer::run()
+/*  Render audio file as fast as possible.  The audio is read in
+    chunks of "nBufferSize" samples; every chunk completes a ring
+    buffer chunk and thus triggers processBufferChunk(), so the meter
+    readings are always up to date when the next chunk is read.
+
+    return value: none
+*/
+{
+    bool bDownmix = bMono && (nNumberOfChannels == 2);
+
+    while ((pAudioFilePlayer != NULL) && !threadShouldExit() && pAudioFilePlayer->isPlaying())
+    {
+        // report meter readings of previous chunk and read next chunk
+        pAudioFilePlayer->fillBufferChunk(pSampleBuffer);
+
+        // convert stereo input to mono if "Mono" button has been
+        // pressed
+        if (bDownmix)
+        {
+            float* output_left = pSampleBuffer->getSampleData(0);
+            float* output_right = pSampleBuffer->getSampleData(1);
+
+            for (int i = 0; i < nBufferSize; i++)
+            {
+                output_left[i] = 0.5f * (output_left[i] + output_right[i]);
+                output_right[i] = output_left[i];
+            }
+        }
+
+        pRingBuffer->addSamples(*pSampleBuffer, 0, nBufferSize);
+    }
+
+    // whoever told the thread to exit already knows that rendering
+    // has stopped
+    if (pCallbackClass && !threadShouldExit())
+    {
+        pCallbackClass->renderingFinished();
+    }
+}
+
+
+void AudioFileRenderer::processBufferChunk(AudioSampleBuffer& buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples)
+{
+    pMeterAnalyser->processBufferChunk(*pRingBuffer, uChunkSize, bMono);
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
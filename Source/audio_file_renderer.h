@@ -0,0 +1,90 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __AUDIO_FILE_RENDERER_H__
+#define __AUDIO_FILE_RENDERER_H__
+
+class AudioFileRenderer;
+class AudioFileRendererCallback;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "audio_file_player.h"
+#include "audio_ring_buffer.h"
+#include "meter_analyser.h"
+
+
+//==============================================================================
+/**
+*/
+class AudioFileRendererCallback
+{
+public:
+    virtual ~AudioFileRendererCallback() {};
+
+    // called on the rendering thread when rendering has finished or
+    // failed (but not when the thread has been told to exit)
+    virtual void renderingFinished() = 0;
+};
+
+
+//==============================================================================
+/**
+*/
+class AudioFileRenderer : public Thread, public AudioRingBufferCallback
+{
+public:
+    AudioFileRenderer(const File audioFile, const File reportFile, int channels, int buffer_size, int average_algorithm, int crest_factor, bool mono);
+    ~AudioFileRenderer();
+
+    bool isRendering() const;
+    void setCallbackClass(AudioFileRendererCallback* callback_class);
+    void setReporters(int nChannel, bool ReportCSV, bool BinaryLog, bool bAverageMeterLevel, bool bPeakMeterLevel, bool bMaximumPeakLevel, bool bStereoMeterValue, bool bPhaseCorrelation);
+
+    void run();
+    void processBufferChunk(AudioSampleBuffer& buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples);
+
+private:
+    JUCE_LEAK_DETECTOR(AudioFileRenderer);
+
+    AudioFileRendererCallback* pCallbackClass;
+    AudioFilePlayer* pAudioFilePlayer;
+    AudioRingBuffer* pRingBuffer;
+    MeterAnalyser* pMeterAnalyser;
+    AudioSampleBuffer* pSampleBuffer;
+    File fileReport;
+
+    int nNumberOfChannels;
+    int nBufferSize;
+    int nSampleRate;
+    bool bMono;
+};
+
+
+#endif  // __AUDIO_FILE_RENDERER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
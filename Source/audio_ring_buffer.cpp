@@ -52,6 +52,7 @@ AudioRingBuffer::AudioRingBuffer(const String& buffer_name, const unsigned int c
     uCurrentPosition = 0;
     uSamplesInBuffer = 0;
     uChannelOffset = new unsigned int[uChannels];
+    pWritePointers = new float*[uChannels];
 
     for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
     {
@@ -67,6 +68,9 @@ AudioRingBuffer::~AudioRingBuffer()
     delete [] uChannelOffset;
     uChannelOffset = NULL;
 
+    delete [] pWritePointers;
+    pWritePointers = NULL;
+
     free(pAudioData);
 }
 
@@ -101,6 +105,12 @@ String AudioRingBuffer::getBufferName()
 }
 
 
+unsigned int AudioRingBuffer::getNumberOfChannels()
+{
+    return uChannels;
+}
+
+
 unsigned int AudioRingBuffer::getCurrentPosition()
 {
     return uCurrentPosition;
@@ -201,6 +211,8 @@ unsigned int AudioRingBuffer::addSamples(AudioSampleBuffer& source, const unsign
 
         uSamplesLeft -= uSamplesToCopy;
 
+        triggerSamplesAdded(uSamplesToCopy);
+
         if (bBufferFull)
         {
             triggerFullBuffer(source, uChunkSize, sourceStartSample + uSamplesFinished, uProcessedSamples);
@@ -226,6 +238,104 @@ unsigned int AudioRingBuffer::addSamples(AudioSampleBuffer& source, const unsign
 }
 
 
+unsigned int AudioRingBuffer::getWritableSamples()
+/*  Get number of samples that may be written directly to the ring
+    buffer (see getWritePointer()).  Writing stops at the end of the
+    ring buffer and at the end of the current chunk, so that chunks
+    are processed as soon as they are complete.
+
+    return value (unsigned integer): number of contiguous samples
+    that may be written
+*/
+{
+    unsigned int uSamplesWritable = uChunkSize - uSamplesInBuffer;
+    unsigned int uSamplesWritable_2 = uTotalLength - uCurrentPosition;
+
+    if (uSamplesWritable_2 < uSamplesWritable)
+    {
+        uSamplesWritable = uSamplesWritable_2;
+    }
+
+    return uSamplesWritable;
+}
+
+
+float* AudioRingBuffer::getWritePointer(const unsigned int channel)
+/*  Get pointer to the current write position.  This allows audio
+    readers to convert samples straight into the ring buffer instead
+    of filling an intermediate buffer first.  After writing, call
+    advanceWritePosition().
+
+    channel (unsigned integer): selected audio channel
+
+    return value (float*): write position of the given channel; up to
+    getWritableSamples() samples may be written
+*/
+{
+    jassert(channel < uChannels);
+
+    return pAudioData + uCurrentPosition + uChannelOffset[channel];
+}
+
+
+unsigned int AudioRingBuffer::advanceWritePosition(const unsigned int numSamples)
+/*  Add samples that have been written directly to the ring buffer
+    (see getWritePointer()).  Processes the current chunk when it is
+    complete.
+
+    numSamples (unsigned integer): number of samples written; must
+    not exceed getWritableSamples()
+
+    return value (unsigned integer): like addSamples(), number of
+    samples written after the last processed chunk
+*/
+{
+    if (numSamples <= 0)
+    {
+        return 0;
+    }
+
+    jassert(numSamples <= getWritableSamples());
+
+    // the chunk callback is passed the written samples, which are
+    // referenced rather than copied
+    for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
+    {
+        pWritePointers[uChannel] = getWritePointer(uChannel);
+    }
+
+    AudioSampleBuffer WrittenSamples(pWritePointers, (int) uChannels, (int) numSamples);
+
+    uSamplesInBuffer += numSamples;
+
+    bool bBufferFull = (uSamplesInBuffer == uChunkSize);
+    uSamplesInBuffer %= uChunkSize;
+
+    uCurrentPosition += numSamples;
+    uCurrentPosition %= uTotalLength;
+
+    triggerSamplesAdded(numSamples);
+
+    if (bBufferFull)
+    {
+        triggerFullBuffer(WrittenSamples, uChunkSize, 0, numSamples);
+    }
+
+#ifdef DEBUG
+
+    // detection of memory leaks
+    for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
+    {
+        jassert(pAudioData[uChannelOffset[uChannel] - 1] == RING_BUFFER_MEM_TEST);
+        jassert(pAudioData[uChannelOffset[uChannel] + uTotalLength] == RING_BUFFER_MEM_TEST);
+    }
+
+#endif
+
+    return bBufferFull ? 0 : numSamples;
+}
+
+
 void AudioRingBuffer::copyToBuffer(AudioSampleBuffer& destination, const unsigned int destStartSample, const unsigned int numSamples, const unsigned int pre_delay)
 {
     if (numSamples <= 0)
@@ -305,7 +415,7 @@ float AudioRingBuffer::getRMSLevel(const unsigned int channel, const unsigned in
 }
 
 
-void AudioRingBuffer::setCallbackClass(KmeterAudioProcessor* callback_class)
+void AudioRingBuffer::setCallbackClass(AudioRingBufferCallback* callback_class)
 {
     pCallbackClass = callback_class;
 }
@@ -326,6 +436,15 @@ void AudioRingBuffer::triggerFullBuffer(AudioSampleBuffer& buffer, const unsigne
 }
 
 
+void AudioRingBuffer::triggerSamplesAdded(const unsigned int uNumSamples)
+{
+    if (pCallbackClass)
+    {
+        pCallbackClass->processBufferSamples(uNumSamples);
+    }
+}
+
+
 // Local Variables:
 // ispell-local-dictionary: "british"
 // End:
@@ -29,9 +29,28 @@
 #define RING_BUFFER_MEM_TEST 255.0f
 
 class AudioRingBuffer;
+class AudioRingBufferCallback;
 
 #include "../JuceLibraryCode/JuceHeader.h"
-#include "plugin_processor.h"
+
+
+//==============================================================================
+/**
+*/
+class AudioRingBufferCallback
+{
+public:
+    virtual ~AudioRingBufferCallback() {};
+
+    // called by the ring buffer whenever "uChunkSize" new samples
+    // have been added
+    virtual void processBufferChunk(AudioSampleBuffer& buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples) = 0;
+
+    // called by the ring buffer whenever "uNumSamples" new samples
+    // have been added (before processBufferChunk() if they complete a
+    // chunk), so that work can be spread over all audio callbacks
+    virtual void processBufferSamples(const unsigned int uNumSamples) {};
+};
 
 
 //==============================================================================
@@ -44,9 +63,10 @@ public:
     ~AudioRingBuffer();
 
     void clear();
-    void setCallbackClass(KmeterAudioProcessor* callback_class);
+    void setCallbackClass(AudioRingBufferCallback* callback_class);
 
     String getBufferName();
+    unsigned int getNumberOfChannels();
     unsigned int getCurrentPosition();
     unsigned int getSamplesInBuffer();
     unsigned int getBufferLength();
@@ -56,6 +76,11 @@ public:
     float getSample(const unsigned int channel, const unsigned int relative_position, const unsigned int pre_delay);
 
     unsigned int addSamples(AudioSampleBuffer& source, const unsigned int sourceStartSample, const unsigned int numSamples);
+
+    unsigned int getWritableSamples();
+    float* getWritePointer(const unsigned int channel);
+    unsigned int advanceWritePosition(const unsigned int numSamples);
+
     void copyToBuffer(AudioSampleBuffer& destination, const unsigned int destStartSample, const unsigned int numSamples, const unsigned int pre_delay);
 
     float getMagnitude(const unsigned int channel, const unsigned int numSamples, const unsigned int pre_delay);
@@ -66,8 +91,9 @@ private:
 
     void clearCallbackClass();
     void triggerFullBuffer(AudioSampleBuffer& buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples);
+    void triggerSamplesAdded(const unsigned int uNumSamples);
 
-    KmeterAudioProcessor* pCallbackClass;
+    AudioRingBufferCallback* pCallbackClass;
     String strBufferName;
 
     unsigned int uChannels;
@@ -79,6 +105,7 @@ private:
     unsigned int uCurrentPosition;
     unsigned int uSamplesInBuffer;
     unsigned int* uChannelOffset;
+    float** pWritePointers;
 
     float* pAudioData;
 };
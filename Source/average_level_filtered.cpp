@@ -25,7 +25,10 @@
 
 #include "average_level_filtered.h"
 
-AverageLevelFiltered::AverageLevelFiltered(KmeterAudioProcessor* processor, const int channels, const int buffer_size, const int sample_rate, const int average_algorithm)
+CriticalSection AverageLevelFiltered::csFftwPlanner;
+
+
+AverageLevelFiltered::AverageLevelFiltered(const int channels, const int buffer_size, const int sample_rate, const int average_algorithm)
 {
     jassert(channels > 0);
 
@@ -55,16 +58,24 @@ AverageLevelFiltered::AverageLevelFiltered(KmeterAudioProcessor* processor, cons
     fftwf_execute = (void (*)(const fftwf_plan)) pDynamicLibraryFFTW->getFunction("fftwf_execute");
 #endif
 
-    pProcessor = processor;
     nNumberOfChannels = channels;
     nSampleRate = sample_rate;
     nBufferSize = buffer_size;
     fPeakToAverageCorrection = 0.0f;
     fAverageLevelItuBs1770 = 0.0f;
+    nSettlingTime = 0;
 
     nFftSize = nBufferSize * 2;
     nHalfFftSize = nFftSize / 2 + 1;
 
+    // channel weights (ITU-R BS.1770) and mean squares of filtered
+    // channels
+    pChannelLayout = new ChannelLayout(nNumberOfChannels);
+    arrMeanSquares = new float[nNumberOfChannels];
+
+    // spectrum analyser is optional and owned by the caller
+    pSpectrum = NULL;
+
     pSampleBuffer = new AudioSampleBuffer(nNumberOfChannels, nBufferSize);
     pOverlapAddSamples = new AudioSampleBuffer(nNumberOfChannels, nBufferSize);
 
@@ -109,13 +120,17 @@ AverageLevelFiltered::AverageLevelFiltered(KmeterAudioProcessor* processor, cons
     arrFilterKernel_TD = fftwf_alloc_real(nFftSize);
     arrFilterKernel_FD = fftwf_alloc_complex(nHalfFftSize);
 
-    planFilterKernel_DFT = fftwf_plan_dft_r2c_1d(nFftSize, arrFilterKernel_TD, arrFilterKernel_FD, FFTW_MEASURE);
-
     arrAudioSamples_TD = fftwf_alloc_real(nFftSize);
     arrAudioSamples_FD = fftwf_alloc_complex(nHalfFftSize);
 
-    planAudioSamples_DFT = fftwf_plan_dft_r2c_1d(nFftSize, arrAudioSamples_TD, arrAudioSamples_FD, FFTW_MEASURE);
-    planAudioSamples_IDFT = fftwf_plan_dft_c2r_1d(nFftSize, arrAudioSamples_FD, arrAudioSamples_TD, FFTW_MEASURE);
+    {
+        const ScopedLock sl(csFftwPlanner);
+
+        planFilterKernel_DFT = fftwf_plan_dft_r2c_1d(nFftSize, arrFilterKernel_TD, arrFilterKernel_FD, FFTW_MEASURE);
+
+        planAudioSamples_DFT = fftwf_plan_dft_r2c_1d(nFftSize, arrAudioSamples_TD, arrAudioSamples_FD, FFTW_MEASURE);
+        planAudioSamples_IDFT = fftwf_plan_dft_c2r_1d(nFftSize, arrAudioSamples_FD, arrAudioSamples_TD, FFTW_MEASURE);
+    }
 
     nAverageAlgorithm = -1;
     setAlgorithm(average_algorithm);
@@ -124,6 +139,12 @@ AverageLevelFiltered::AverageLevelFiltered(KmeterAudioProcessor* processor, cons
 
 AverageLevelFiltered::~AverageLevelFiltered()
 {
+    delete pChannelLayout;
+    pChannelLayout = NULL;
+
+    delete [] arrMeanSquares;
+    arrMeanSquares = NULL;
+
     delete pSampleBuffer;
     pSampleBuffer = NULL;
 
@@ -160,12 +181,17 @@ AverageLevelFiltered::~AverageLevelFiltered()
     delete pPreviousSamplesOutputTemp;
     pPreviousSamplesOutputTemp = NULL;
 
-    fftwf_destroy_plan(planFilterKernel_DFT);
+    {
+        const ScopedLock sl(csFftwPlanner);
+
+        fftwf_destroy_plan(planFilterKernel_DFT);
+        fftwf_destroy_plan(planAudioSamples_DFT);
+        fftwf_destroy_plan(planAudioSamples_IDFT);
+    }
+
     fftwf_free(arrFilterKernel_TD);
     fftwf_free(arrFilterKernel_FD);
 
-    fftwf_destroy_plan(planAudioSamples_DFT);
-    fftwf_destroy_plan(planAudioSamples_IDFT);
     fftwf_free(arrAudioSamples_TD);
     fftwf_free(arrAudioSamples_FD);
 
@@ -210,7 +236,12 @@ void AverageLevelFiltered::setAlgorithm(const int average_algorithm)
     }
 
     calculateFilterKernel();
-    pProcessor->setAverageAlgorithmFinal(nAverageAlgorithm);
+}
+
+
+int AverageLevelFiltered::getSettlingTime()
+{
+    return nSettlingTime;
 }
 
 
@@ -243,6 +274,9 @@ void AverageLevelFiltered::calculateFilterKernel()
         // ITU-R BS.1770-1 provides its own peak-to-average gain
         // correction, so we don't need to apply any!
         setPeakToAverageCorrection(0.0f);
+
+        // the IIR filters are followed by the FIR filter
+        nSettlingTime = calculateSettlingTime_Iir(pIIRCoefficients_1) + calculateSettlingTime_Iir(pIIRCoefficients_2) + nBufferSize + 1;
     }
     else
     {
@@ -254,6 +288,9 @@ void AverageLevelFiltered::calculateFilterKernel()
         // 15 seconds of uncorrelated pink noise with a level of -20
         // dB FS RMS
         setPeakToAverageCorrection(+2.9881f);
+
+        // length of FIR filter kernel
+        nSettlingTime = nBufferSize + 1;
     }
 }
 
@@ -269,6 +306,46 @@ void AverageLevelFiltered::setPeakToAverageCorrection(float peak_to_average_corr
 }
 
 
+int AverageLevelFiltered::calculateSettlingTime_Iir(float** pIIRCoefficients)
+/*  Calculate the time it takes for the impulse response of a
+    second-order IIR filter to decay by 120 dB.
+
+    pIIRCoefficients (float**): filter coefficients
+
+    return value (integer): settling time in samples
+*/
+{
+    // poles are the roots of z^2 - a1 * z - a2 (the output
+    // coefficients are stored with inverted signs)
+    double a1 = pIIRCoefficients[1][1];
+    double a2 = pIIRCoefficients[1][2];
+    double discriminant = a1 * a1 + 4.0 * a2;
+    double pole_radius;
+
+    if (discriminant < 0.0)
+    {
+        // complex conjugate poles
+        pole_radius = sqrt(-a2);
+    }
+    else
+    {
+        // real poles
+        pole_radius = (fabs(a1) + sqrt(discriminant)) / 2.0;
+    }
+
+    // filter has no feedback
+    if (pole_radius <= 0.0)
+    {
+        return KMETER_MAXIMUM_IIR_FILTER_COEFFICIENTS;
+    }
+
+    // unstable filters never settle
+    jassert(pole_radius < 1.0);
+
+    return int(ceil(log(1e-6) / log(pole_radius)));
+}
+
+
 void AverageLevelFiltered::calculateFilterKernel_Rms()
 {
     float nCutoffFrequency = 21000.0f;
@@ -366,7 +443,13 @@ void AverageLevelFiltered::calculateFilterKernel_ItuBs1770()
 }
 
 
-void AverageLevelFiltered::FilterSamples_Rms(const int channel)
+void AverageLevelFiltered::FilterSamples_Dft(const int channel)
+/*  Calculate DFT of a channel's audio data (first filter stage).
+
+    channel (integer): selected audio channel
+
+    return value: none
+*/
 {
     jassert(channel >= 0);
     jassert(channel < nNumberOfChannels);
@@ -384,7 +467,21 @@ void AverageLevelFiltered::FilterSamples_Rms(const int channel)
     // calculate DFT of audio data
     fftwf_execute(planAudioSamples_DFT);
 
-    // convolve audio data with filter kernel
+    // re-use DFT for spectrum analyser
+    if (pSpectrum)
+    {
+        pSpectrum->addSpectrum(channel, arrAudioSamples_FD);
+    }
+}
+
+
+void AverageLevelFiltered::FilterSamples_Convolve()
+/*  Convolve DFT of audio data with filter kernel (second filter
+    stage).
+
+    return value: none
+*/
+{
     for (int i = 0; i < nHalfFftSize; i++)
     {
         // multiplication of complex numbers: index 0 contains the real
@@ -395,6 +492,20 @@ void AverageLevelFiltered::FilterSamples_Rms(const int channel)
         arrAudioSamples_FD[i][0] = real_part;
         arrAudioSamples_FD[i][1] = imaginary_part;
     }
+}
+
+
+void AverageLevelFiltered::FilterSamples_Idft(const int channel)
+/*  Synthesise filtered audio data and overlap-add it to the sample
+    buffer (third filter stage).
+
+    channel (integer): selected audio channel
+
+    return value: none
+*/
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
 
     // synthesise audio data from frequency spectrum (this destroys the
     // contents of "arrAudioSamples_FD"!!!)
@@ -419,120 +530,231 @@ void AverageLevelFiltered::FilterSamples_Rms(const int channel)
 }
 
 
-void AverageLevelFiltered::FilterSamples_ItuBs1770()
+void AverageLevelFiltered::FilterSamples_ItuBs1770(const int channel)
 {
-    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
-    {
-        // pre-filter
-        pPreviousSamplesOutputTemp->clear();
-        float* pSamplesInput = pSampleBuffer->getSampleData(nChannel);
-        float* pSamplesOutput = pPreviousSamplesOutputTemp->getSampleData(0);
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
 
-        float* pSamplesInputOld_1 = pPreviousSamplesInput_1->getSampleData(nChannel);
-        float* pSamplesOutputOld_1 = pPreviousSamplesOutput_1->getSampleData(nChannel);
+    // pre-filter
+    pPreviousSamplesOutputTemp->clear();
+    float* pSamplesInput = pSampleBuffer->getSampleData(channel);
+    float* pSamplesOutput = pPreviousSamplesOutputTemp->getSampleData(0);
 
-        for (int nSample = 0; nSample < nBufferSize; nSample++)
+    float* pSamplesInputOld_1 = pPreviousSamplesInput_1->getSampleData(channel);
+    float* pSamplesOutputOld_1 = pPreviousSamplesOutput_1->getSampleData(channel);
+
+    for (int nSample = 0; nSample < nBufferSize; nSample++)
+    {
+        if (nSample < 2)
         {
-            if (nSample < 2)
+            if (nSample == 0)
             {
-                if (nSample == 0)
-                {
-                    pSamplesOutput[nSample] =
-                        pIIRCoefficients_1[0][0] * pSamplesInput[nSample] +
-                        pIIRCoefficients_1[0][1] * pSamplesInputOld_1[1] +
-                        pIIRCoefficients_1[0][2] * pSamplesInputOld_1[0] +
-                        pIIRCoefficients_1[1][1] * pSamplesOutputOld_1[1] +
-                        pIIRCoefficients_1[1][2] * pSamplesOutputOld_1[0];
-                }
-                else
-                {
-                    pSamplesOutput[nSample] =
-                        pIIRCoefficients_1[0][0] * pSamplesInput[nSample] +
-                        pIIRCoefficients_1[0][1] * pSamplesInput[nSample - 1] +
-                        pIIRCoefficients_1[0][2] * pSamplesInputOld_1[1] +
-                        pIIRCoefficients_1[1][1] * pSamplesOutput[nSample - 1] +
-                        pIIRCoefficients_1[1][2] * pSamplesOutputOld_1[1];
-                }
-
-                // avoid underflows (1e-20f corresponds to -400 dBFS)
-                if (fabs(pSamplesOutput[nSample]) < 1e-20f)
-                {
-                    pSamplesOutput[nSample] = 0.0f;
-                }
+                pSamplesOutput[nSample] =
+                    pIIRCoefficients_1[0][0] * pSamplesInput[nSample] +
+                    pIIRCoefficients_1[0][1] * pSamplesInputOld_1[1] +
+                    pIIRCoefficients_1[0][2] * pSamplesInputOld_1[0] +
+                    pIIRCoefficients_1[1][1] * pSamplesOutputOld_1[1] +
+                    pIIRCoefficients_1[1][2] * pSamplesOutputOld_1[0];
             }
             else
             {
                 pSamplesOutput[nSample] =
                     pIIRCoefficients_1[0][0] * pSamplesInput[nSample] +
                     pIIRCoefficients_1[0][1] * pSamplesInput[nSample - 1] +
-                    pIIRCoefficients_1[0][2] * pSamplesInput[nSample - 2] +
+                    pIIRCoefficients_1[0][2] * pSamplesInputOld_1[1] +
                     pIIRCoefficients_1[1][1] * pSamplesOutput[nSample - 1] +
-                    pIIRCoefficients_1[1][2] * pSamplesOutput[nSample - 2];
+                    pIIRCoefficients_1[1][2] * pSamplesOutputOld_1[1];
+            }
+
+            // avoid underflows (1e-20f corresponds to -400 dBFS)
+            if (fabs(pSamplesOutput[nSample]) < 1e-20f)
+            {
+                pSamplesOutput[nSample] = 0.0f;
             }
         }
+        else
+        {
+            pSamplesOutput[nSample] =
+                pIIRCoefficients_1[0][0] * pSamplesInput[nSample] +
+                pIIRCoefficients_1[0][1] * pSamplesInput[nSample - 1] +
+                pIIRCoefficients_1[0][2] * pSamplesInput[nSample - 2] +
+                pIIRCoefficients_1[1][1] * pSamplesOutput[nSample - 1] +
+                pIIRCoefficients_1[1][2] * pSamplesOutput[nSample - 2];
+        }
+    }
 
-        pPreviousSamplesInput_1->copyFrom(nChannel, 0, *pSampleBuffer, nChannel, nBufferSize - 2, 2);
-        pPreviousSamplesOutput_1->copyFrom(nChannel, 0, *pPreviousSamplesOutputTemp, 0, nBufferSize - 2, 2);
+    pPreviousSamplesInput_1->copyFrom(channel, 0, *pSampleBuffer, channel, nBufferSize - 2, 2);
+    pPreviousSamplesOutput_1->copyFrom(channel, 0, *pPreviousSamplesOutputTemp, 0, nBufferSize - 2, 2);
 
-        pSampleBuffer->copyFrom(nChannel, 0, *pPreviousSamplesOutputTemp, 0, 0, nBufferSize);
+    pSampleBuffer->copyFrom(channel, 0, *pPreviousSamplesOutputTemp, 0, 0, nBufferSize);
 
-        // RLB weighting filter
-        pPreviousSamplesOutputTemp->clear();
+    // RLB weighting filter
+    pPreviousSamplesOutputTemp->clear();
 
-        float* pSamplesInputOld_2 = pPreviousSamplesInput_2->getSampleData(nChannel);
-        float* pSamplesOutputOld_2 = pPreviousSamplesOutput_2->getSampleData(nChannel);
+    float* pSamplesInputOld_2 = pPreviousSamplesInput_2->getSampleData(channel);
+    float* pSamplesOutputOld_2 = pPreviousSamplesOutput_2->getSampleData(channel);
 
-        for (int nSample = 0; nSample < nBufferSize; nSample++)
+    for (int nSample = 0; nSample < nBufferSize; nSample++)
+    {
+        if (nSample < 2)
         {
-            if (nSample < 2)
+            if (nSample == 0)
             {
-                if (nSample == 0)
-                {
-                    pSamplesOutput[nSample] =
-                        pIIRCoefficients_2[0][0] * pSamplesInput[nSample] +
-                        pIIRCoefficients_2[0][1] * pSamplesInputOld_2[1] +
-                        pIIRCoefficients_2[0][2] * pSamplesInputOld_2[0] +
-                        pIIRCoefficients_2[1][1] * pSamplesOutputOld_2[1] +
-                        pIIRCoefficients_2[1][2] * pSamplesOutputOld_2[0];
-                }
-                else
-                {
-                    pSamplesOutput[nSample] =
-                        pIIRCoefficients_2[0][0] * pSamplesInput[nSample] +
-                        pIIRCoefficients_2[0][1] * pSamplesInput[nSample - 1] +
-                        pIIRCoefficients_2[0][2] * pSamplesInputOld_2[1] +
-                        pIIRCoefficients_2[1][1] * pSamplesOutput[nSample - 1] +
-                        pIIRCoefficients_2[1][2] * pSamplesOutputOld_2[1];
-                }
-
-                // avoid underflows (1e-20f corresponds to -400 dBFS)
-                if (fabs(pSamplesOutput[nSample]) < 1e-20f)
-                {
-                    pSamplesOutput[nSample] = 0.0f;
-                }
+                pSamplesOutput[nSample] =
+                    pIIRCoefficients_2[0][0] * pSamplesInput[nSample] +
+                    pIIRCoefficients_2[0][1] * pSamplesInputOld_2[1] +
+                    pIIRCoefficients_2[0][2] * pSamplesInputOld_2[0] +
+                    pIIRCoefficients_2[1][1] * pSamplesOutputOld_2[1] +
+                    pIIRCoefficients_2[1][2] * pSamplesOutputOld_2[0];
             }
             else
             {
                 pSamplesOutput[nSample] =
                     pIIRCoefficients_2[0][0] * pSamplesInput[nSample] +
                     pIIRCoefficients_2[0][1] * pSamplesInput[nSample - 1] +
-                    pIIRCoefficients_2[0][2] * pSamplesInput[nSample - 2] +
+                    pIIRCoefficients_2[0][2] * pSamplesInputOld_2[1] +
                     pIIRCoefficients_2[1][1] * pSamplesOutput[nSample - 1] +
-                    pIIRCoefficients_2[1][2] * pSamplesOutput[nSample - 2];
+                    pIIRCoefficients_2[1][2] * pSamplesOutputOld_2[1];
+            }
+
+            // avoid underflows (1e-20f corresponds to -400 dBFS)
+            if (fabs(pSamplesOutput[nSample]) < 1e-20f)
+            {
+                pSamplesOutput[nSample] = 0.0f;
+            }
+        }
+        else
+        {
+            pSamplesOutput[nSample] =
+                pIIRCoefficients_2[0][0] * pSamplesInput[nSample] +
+                pIIRCoefficients_2[0][1] * pSamplesInput[nSample - 1] +
+                pIIRCoefficients_2[0][2] * pSamplesInput[nSample - 2] +
+                pIIRCoefficients_2[1][1] * pSamplesOutput[nSample - 1] +
+                pIIRCoefficients_2[1][2] * pSamplesOutput[nSample - 2];
+        }
+    }
+
+    pPreviousSamplesInput_2->copyFrom(channel, 0, *pSampleBuffer, channel, nBufferSize - 2, 2);
+    pPreviousSamplesOutput_2->copyFrom(channel, 0, *pPreviousSamplesOutputTemp, 0, nBufferSize - 2, 2);
+
+    pSampleBuffer->copyFrom(channel, 0, *pPreviousSamplesOutputTemp, 0, 0, nBufferSize);
+}
+
+
+float AverageLevelFiltered::getLevel(const int channel)
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+
+    if (nAverageAlgorithm == KmeterPluginParameters::selAlgorithmItuBs1770)
+    {
+        // the loudness of all channels is returned for the first
+        // channel, so filter all channels at once
+        if (channel == 0)
+        {
+            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+            {
+                filterChannel(nChannel);
             }
         }
+    }
+    else
+    {
+        filterChannel(channel);
+    }
+
+    return getFilteredLevel(channel);
+}
+
 
-        pPreviousSamplesInput_2->copyFrom(nChannel, 0, *pSampleBuffer, nChannel, nBufferSize - 2, 2);
-        pPreviousSamplesOutput_2->copyFrom(nChannel, 0, *pPreviousSamplesOutputTemp, 0, nBufferSize - 2, 2);
+void AverageLevelFiltered::filterChannel(const int channel)
+/*  Filter one channel of the audio data copied by copyFromBuffer().
+    This is where the real work is done, so it has been separated
+    from getFilteredLevel() to allow spreading the work of a chunk
+    over several audio callbacks (see filterChannelStage()).
 
-        pSampleBuffer->copyFrom(nChannel, 0, *pPreviousSamplesOutputTemp, 0, 0, nBufferSize);
+    channel (integer): selected audio channel
 
-        FilterSamples_Rms(nChannel);
+    return value: none
+*/
+{
+    for (int nStage = 0; nStage < KMETER_FILTER_STAGES; nStage++)
+    {
+        filterChannelStage(channel, nStage);
     }
 }
 
 
-float AverageLevelFiltered::getLevel(const int channel)
+void AverageLevelFiltered::filterChannelStage(const int channel, const int stage)
+/*  Run a single stage of filtering a channel.  Each stage costs
+    about the same (except for the cheap convolution), so running one
+    stage per audio callback bounds the work of any callback to about
+    a single DFT.  The stages of a channel share buffers, so they
+    must be run in order and must not be interleaved with stages of
+    another channel.
+
+    channel (integer): selected audio channel
+
+    stage (integer): 0 (pre-filters and forward DFT), 1 (convolution)
+    or 2 (inverse DFT)
+
+    return value: none
+*/
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+    jassert(stage >= 0);
+    jassert(stage < KMETER_FILTER_STAGES);
+
+    bool bItuBs1770 = (nAverageAlgorithm == KmeterPluginParameters::selAlgorithmItuBs1770);
+
+    if (stage == 0)
+    {
+        // apply pre-filters (overwrites contents of sample buffer)
+        if (bItuBs1770)
+        {
+            FilterSamples_ItuBs1770(channel);
+        }
+
+        FilterSamples_Dft(channel);
+    }
+    else if (stage == 1)
+    {
+        FilterSamples_Convolve();
+    }
+    else
+    {
+        // overwrites contents of sample buffer
+        FilterSamples_Idft(channel);
+
+        if (bItuBs1770)
+        {
+            float fAverageLevelChannel = 0.0f;
+            float* fSampleData = pSampleBuffer->getSampleData(channel);
+
+            // calculate mean square of the filtered input signal
+            for (int n = 0; n < nBufferSize; n++)
+            {
+                fAverageLevelChannel += (fSampleData[n] * fSampleData[n]);
+            }
+
+            arrMeanSquares[channel] = fAverageLevelChannel / float(nBufferSize);
+        }
+    }
+}
+
+
+float AverageLevelFiltered::getFilteredLevel(const int channel)
+/*  Calculate average level from filtered audio data.  In ITU-R
+    BS.1770-1 mode, all channels must have been filtered; otherwise,
+    only the selected channel.
+
+    channel (integer): selected audio channel
+
+    return value (float): average level in decibels (ITU-R BS.1770-1:
+    loudness of all channels for the first channel, meter minimum for
+    all other channels)
+*/
 {
     jassert(channel >= 0);
     jassert(channel < nNumberOfChannels);
@@ -545,41 +767,15 @@ float AverageLevelFiltered::getLevel(const int channel)
 
         if (channel == 0)
         {
-            // filter audio data (all channels; overwrites contents of
-            // sample buffer)
-            FilterSamples_ItuBs1770();
+            // apply weighting factors and sum channels; the weights
+            // have been pre-computed from the channel layout (LFE
+            // --> 0.00, surround --> 1.41, other --> 1.00), so this
+            // is a plain dot product
+            const float* arrWeights = pChannelLayout->getWeights();
 
             for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
             {
-                float fAverageLevelChannel = 0.0f;
-                float* fSampleData = pSampleBuffer->getSampleData(nChannel);
-
-                // calculate mean square of the filtered input signal
-                for (int n = 0; n < nBufferSize; n++)
-                {
-                    fAverageLevelChannel += (fSampleData[n] * fSampleData[n]);
-                }
-
-                fAverageLevelChannel /= float(nBufferSize);
-
-                // apply weighting factor and sum channels
-                //
-                // L, R, C  --> 1.00 (ignore factor)
-                // LFE      --> 0.00 (skip channel)
-                // LS, RS   --> 1.41
-                // other    --> 0.00 (skip channel)
-                if (nChannel < 3)
-                {
-                    fAverageLevel += fAverageLevelChannel;
-                }
-                else if (nChannel == 4)
-                {
-                    fAverageLevel += 1.41f * fAverageLevelChannel;
-                }
-                else if (nChannel == 5)
-                {
-                    fAverageLevel += 1.41f * fAverageLevelChannel;
-                }
+                fAverageLevel += arrWeights[nChannel] * arrMeanSquares[nChannel];
             }
 
             // calculate loudness by applying the formula from ITU-R
@@ -601,9 +797,6 @@ float AverageLevelFiltered::getLevel(const int channel)
     }
     else
     {
-        // filter audio data (overwrites contents of sample buffer)
-        FilterSamples_Rms(channel);
-
         float fAverageLevel = MeterBallistics::level2decibel(pSampleBuffer->getRMSLevel(channel, 0, nBufferSize));
 
         // apply peak-to-average gain correction so that sine waves
@@ -613,6 +806,40 @@ float AverageLevelFiltered::getLevel(const int channel)
 }
 
 
+int AverageLevelFiltered::getChannelLayout()
+{
+    return pChannelLayout->getLayout();
+}
+
+
+bool AverageLevelFiltered::setChannelLayout(const StringArray& channel_names)
+/*  Weight channels according to their names (see ChannelLayout).
+
+    channel_names (StringArray): names of all audio channels
+
+    return value (Boolean): false if the number of names does not
+    match the number of channels (layout is left unchanged)
+*/
+{
+    return pChannelLayout->setLayoutFromChannelNames(channel_names);
+}
+
+
+void AverageLevelFiltered::setSpectrum(Spectrum* spectrum)
+/*  Pass the spectrum of every filtered block on to a spectrum
+    analyser.
+
+    spectrum (Spectrum pointer): spectrum analyser (or NULL to stop);
+    the caller keeps ownership and has to keep it alive for as long
+    as it is set
+
+    return value: none
+*/
+{
+    pSpectrum = spectrum;
+}
+
+
 void AverageLevelFiltered::copyFromBuffer(AudioRingBuffer& ringBuffer, const unsigned int pre_delay, const int sample_rate)
 {
     // recalculate filter kernel when sample rate changes
@@ -30,8 +30,10 @@ class AverageLevelFiltered;
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "audio_ring_buffer.h"
+#include "channel_layout.h"
 #include "meter_ballistics.h"
-#include "plugin_processor.h"
+#include "plugin_parameters.h"
+#include "spectrum.h"
 #include "fftw3/api/fftw3.h"
 
 //==============================================================================
@@ -42,16 +44,29 @@ class AverageLevelFiltered
 public:
     static const int KMETER_MAXIMUM_IIR_FILTER_COEFFICIENTS = 3;
 
-    AverageLevelFiltered(KmeterAudioProcessor* processor, const int channels, const int buffer_size, const int sample_rate, const int average_algorithm);
+    // filtering a channel is split into forward DFT, convolution and
+    // inverse DFT (see filterChannelStage())
+    static const int KMETER_FILTER_STAGES = 3;
+
+    AverageLevelFiltered(const int channels, const int buffer_size, const int sample_rate, const int average_algorithm);
     ~AverageLevelFiltered();
 
     float getLevel(const int channel);
+    void filterChannel(const int channel);
+    void filterChannelStage(const int channel, const int stage);
+    float getFilteredLevel(const int channel);
     int getAlgorithm();
     void setAlgorithm(const int average_algorithm);
+    int getSettlingTime();
     void copyFromBuffer(AudioRingBuffer& ringBuffer, const unsigned int pre_delay, const int sample_rate);
     void copyToBuffer(AudioRingBuffer& destination, const unsigned int sourceStartSample, const unsigned int numSamples);
     void copyToBuffer(AudioSampleBuffer& destination, const int channel, const int destStartSample, const int numSamples);
 
+    int getChannelLayout();
+    bool setChannelLayout(const StringArray& channel_names);
+
+    void setSpectrum(Spectrum* spectrum);
+
 private:
     JUCE_LEAK_DETECTOR(AverageLevelFiltered);
 
@@ -59,10 +74,13 @@ private:
     void calculateFilterKernel_Rms();
     void calculateFilterKernel_ItuBs1770();
 
-    void FilterSamples_Rms(const int channel);
-    void FilterSamples_ItuBs1770();
+    void FilterSamples_Dft(const int channel);
+    void FilterSamples_Convolve();
+    void FilterSamples_Idft(const int channel);
+    void FilterSamples_ItuBs1770(const int channel);
 
     void setPeakToAverageCorrection(float peak_to_average_correction);
+    int calculateSettlingTime_Iir(float** pIIRCoefficients);
 
     AudioSampleBuffer* pSampleBuffer;
     AudioSampleBuffer* pOverlapAddSamples;
@@ -87,17 +105,25 @@ private:
     AudioSampleBuffer* pPreviousSamplesInput_2;
     AudioSampleBuffer* pPreviousSamplesOutput_2;
 
-    KmeterAudioProcessor* pProcessor;
+    ChannelLayout* pChannelLayout;
+    Spectrum* pSpectrum;
+    float* arrMeanSquares;
+
     int nNumberOfChannels;
     int nAverageAlgorithm;
     int nSampleRate;
     int nBufferSize;
     int nFftSize;
     int nHalfFftSize;
+    int nSettlingTime;
 
     float fAverageLevelItuBs1770;
     float fPeakToAverageCorrection;
 
+    // the FFTW planner is not thread-safe, and instances of this
+    // class may be created and deleted on any thread
+    static CriticalSection csFftwPlanner;
+
 #if (defined (_WIN32) || defined (_WIN64))
     DynamicLibrary* pDynamicLibraryFFTW;
 
@@ -0,0 +1,315 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "channel_layout.h"
+
+
+// channel names of the pre-defined layouts; channels are ordered as
+// in WAVE files (SMPTE order, see ITU-R BS.2051 for the names)
+static const char* arrChannelNames_Mono[] = {"C"};
+static const char* arrChannelNames_Stereo[] = {"L", "R"};
+static const char* arrChannelNames_5_1[] = {"L", "R", "C", "LFE", "Ls", "Rs"};
+static const char* arrChannelNames_7_1[] = {"L", "R", "C", "LFE", "Lrs", "Rrs", "Lss", "Rss"};
+static const char* arrChannelNames_7_1_4[] = {"L", "R", "C", "LFE", "Lrs", "Rrs", "Lss", "Rss", "Ltf", "Rtf", "Ltr", "Rtr"};
+
+
+ChannelLayout::ChannelLayout(const int channels)
+/*  Constructor.
+
+    channels (integer): number of audio input channels
+
+    return value: none
+*/
+{
+    jassert(channels > 0);
+
+    nNumberOfChannels = channels;
+    arrWeights = new float[nNumberOfChannels];
+
+    // guess layout from number of channels; this can be overridden
+    // later on using setLayout() or setLayoutFromChannelNames()
+    setLayout(getDefaultLayout(nNumberOfChannels));
+}
+
+
+ChannelLayout::~ChannelLayout()
+/*  Destructor.
+
+    return value: none
+*/
+{
+    delete [] arrWeights;
+    arrWeights = NULL;
+}
+
+
+int ChannelLayout::getNumberOfChannels()
+{
+    return nNumberOfChannels;
+}
+
+
+int ChannelLayout::getLayout()
+{
+    return nLayout;
+}
+
+
+String ChannelLayout::getChannelName(const int channel)
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+
+    return strChannelNames[channel];
+}
+
+
+void ChannelLayout::setLayout(const int layout)
+/*  Select one of the pre-defined channel layouts and update channel
+    weights.
+
+    layout (integer): channel layout; must be one of the "layout..."
+    values defined in "channel_layout.h"
+
+    return value: none
+*/
+{
+    StringArray strNames;
+
+    switch (layout)
+    {
+    case layoutMono:
+        strNames = StringArray(arrChannelNames_Mono, numElementsInArray(arrChannelNames_Mono));
+        break;
+
+    case layoutStereo:
+        strNames = StringArray(arrChannelNames_Stereo, numElementsInArray(arrChannelNames_Stereo));
+        break;
+
+    case layoutSurround_5_1:
+        strNames = StringArray(arrChannelNames_5_1, numElementsInArray(arrChannelNames_5_1));
+        break;
+
+    case layoutSurround_7_1:
+        strNames = StringArray(arrChannelNames_7_1, numElementsInArray(arrChannelNames_7_1));
+        break;
+
+    case layoutImmersive_7_1_4:
+        strNames = StringArray(arrChannelNames_7_1_4, numElementsInArray(arrChannelNames_7_1_4));
+        break;
+    }
+
+    // layout does not match the number of channels, so fall back to
+    // an unknown layout
+    if (strNames.size() != nNumberOfChannels)
+    {
+        nLayout = layoutUnknown;
+        strChannelNames.clear();
+
+        // treat all channels as full-range channels in front of the
+        // listener rather than silently dropping them
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            strChannelNames.add("Ch" + String(nChannel + 1));
+            arrWeights[nChannel] = 1.0f;
+        }
+    }
+    else
+    {
+        nLayout = layout;
+        strChannelNames = strNames;
+
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            arrWeights[nChannel] = getWeightFromChannelName(strChannelNames[nChannel]);
+        }
+    }
+}
+
+
+bool ChannelLayout::setLayoutFromChannelNames(const StringArray& channel_names)
+/*  Set channel layout as provided by the host (or the user) and
+    update channel weights.
+
+    channel_names (StringArray): names of all audio input channels in
+    the order they are passed to the meter (such as "L", "R", "C",
+    "LFE", "Ls", "Rs")
+
+    return value (Boolean): false if the number of names does not
+    match the number of channels (layout is left unchanged)
+*/
+{
+    if (channel_names.size() != nNumberOfChannels)
+    {
+        return false;
+    }
+
+    nLayout = layoutHost;
+    strChannelNames = channel_names;
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        arrWeights[nChannel] = getWeightFromChannelName(strChannelNames[nChannel]);
+    }
+
+    return true;
+}
+
+
+float ChannelLayout::getWeight(const int channel)
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+
+    return arrWeights[channel];
+}
+
+
+const float* ChannelLayout::getWeights()
+/*  Get pre-computed channel weights (ITU-R BS.1770).
+
+    return value (float pointer): array holding one weight for every
+    audio input channel
+*/
+{
+    return arrWeights;
+}
+
+
+int ChannelLayout::getDefaultLayout(const int channels)
+/*  Guess channel layout from the number of audio channels.
+
+    channels (integer): number of audio input channels
+
+    return value (integer): one of the "layout..." values defined in
+    "channel_layout.h"
+*/
+{
+    switch (channels)
+    {
+    case 1:
+        return layoutMono;
+
+    case 2:
+        return layoutStereo;
+
+    case 6:
+        return layoutSurround_5_1;
+
+    case 8:
+        return layoutSurround_7_1;
+
+    case 12:
+        return layoutImmersive_7_1_4;
+
+    default:
+        return layoutUnknown;
+    }
+}
+
+
+StringArray ChannelLayout::getChannelNamesFromMask(const uint32 channel_mask, const int channels)
+/*  Get channel names from the speaker positions of a
+    WAVE_FORMAT_EXTENSIBLE file.  Channels are stored in the order of
+    the mask's bits.
+
+    channel_mask (unsigned 32-bit integer): "dwChannelMask" of the
+    file's format chunk
+
+    channels (integer): number of audio channels in file
+
+    return value (StringArray): names of all channels; empty if the
+    mask does not describe every channel
+*/
+{
+    // "back" speakers are the surround channels of 5.1, but the rear
+    // surround channels of 7.1 (which has side speakers as well)
+    bool bSideSpeakers = (channel_mask & 0x600) != 0;
+
+    const char* arrSpeakerNames[] =
+    {
+        "L", "R", "C", "LFE",
+        bSideSpeakers ? "Lrs" : "Ls",
+        bSideSpeakers ? "Rrs" : "Rs",
+        "Lc", "Rc", "Cs", "Lss", "Rss",
+        "Tc", "Ltf", "Ctf", "Rtf", "Ltr", "Ctr", "Rtr"
+    };
+
+    StringArray strNames;
+
+    for (int nBit = 0; nBit < numElementsInArray(arrSpeakerNames); nBit++)
+    {
+        if (channel_mask & (1 << nBit))
+        {
+            strNames.add(arrSpeakerNames[nBit]);
+        }
+    }
+
+    if (strNames.size() != channels)
+    {
+        strNames.clear();
+    }
+
+    return strNames;
+}
+
+
+float ChannelLayout::getWeightFromChannelName(const String& channel_name)
+/*  Get channel weight according to ITU-R BS.1770 from a channel's
+    name.
+
+    channel_name (String): short channel name (such as "Ls")
+
+    return value (float): channel weight
+*/
+{
+    String strName = channel_name.trim().toLowerCase();
+
+    // LFE channels are not taken into account
+    if (strName.startsWith("lfe"))
+    {
+        return 0.00f;
+    }
+    // channels with an azimuth of 60 to 120 degrees (surround
+    // channels of 5.1, side surround channels of 7.1) are weighted
+    // with +1.5 dB
+    else if ((strName == "ls") || (strName == "rs") ||
+             (strName == "lss") || (strName == "rss") ||
+             (strName == "sl") || (strName == "sr"))
+    {
+        return 1.41f;
+    }
+    // all other channels (front, rear surround and height channels)
+    // are weighted with 0 dB
+    else
+    {
+        return 1.00f;
+    }
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
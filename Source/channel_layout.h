@@ -0,0 +1,86 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __CHANNEL_LAYOUT_H__
+#define __CHANNEL_LAYOUT_H__
+
+class ChannelLayout;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+
+//==============================================================================
+/**
+*/
+class ChannelLayout
+{
+public:
+    enum Layouts  // public namespace!
+    {
+        layoutUnknown = 0,
+        layoutMono,
+        layoutStereo,
+        layoutSurround_5_1,
+        layoutSurround_7_1,
+        layoutImmersive_7_1_4,
+        layoutHost,
+
+        nNumLayouts,
+    };
+
+    ChannelLayout(const int channels);
+    ~ChannelLayout();
+
+    int getNumberOfChannels();
+    int getLayout();
+    String getChannelName(const int channel);
+
+    void setLayout(const int layout);
+    bool setLayoutFromChannelNames(const StringArray& channel_names);
+
+    float getWeight(const int channel);
+    const float* getWeights();
+
+    static int getDefaultLayout(const int channels);
+    static float getWeightFromChannelName(const String& channel_name);
+    static StringArray getChannelNamesFromMask(const uint32 channel_mask, const int channels);
+
+private:
+    JUCE_LEAK_DETECTOR(ChannelLayout);
+
+    int nNumberOfChannels;
+    int nLayout;
+
+    StringArray strChannelNames;
+    float* arrWeights;
+};
+
+
+#endif  // __CHANNEL_LAYOUT_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
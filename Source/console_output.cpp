@@ -0,0 +1,45 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "console_output.h"
+
+#include <iostream>
+
+
+void ConsoleOutput::printMessage(const String& strMessage)
+/*  Print a line on standard output (command-line tools only).
+
+    strMessage (const String&): line to print
+
+    return value: none
+*/
+{
+    std::cout << strMessage << std::endl;
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
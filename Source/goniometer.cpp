@@ -0,0 +1,226 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "goniometer.h"
+
+
+Goniometer::Goniometer(const String& componentName, const int frame_rate)
+{
+    setName(componentName);
+
+    // this component does not have any transparent areas (increases
+    // performance on redrawing)
+    setOpaque(true);
+
+    fSide = new float[GoniometerBuffer::BUFFER_SIZE];
+    fMid = new float[GoniometerBuffer::BUFFER_SIZE];
+
+    // points below the meter's floor are treated as silence
+    fMinimumLevel = MeterBallistics::decibel2level(MeterBallistics::getMeterMinimumDecibel());
+
+    setFrameRate(frame_rate);
+    nFramesWithoutPoints = nFramesUntilDark;
+}
+
+
+Goniometer::~Goniometer()
+{
+    delete [] fSide;
+    fSide = NULL;
+
+    delete [] fMid;
+    fMid = NULL;
+}
+
+
+void Goniometer::setFrameRate(const int frame_rate)
+/*  Adapt decay of old points to the frame rate.
+
+    frame_rate (integer): number of calls to update() per second
+
+    return value: none
+*/
+{
+    // the afterglow lasts equally long at all frame rates
+    nFramesUntilDark = jmax(1, (AFTERGLOW_MILLISECONDS * frame_rate) / 1000);
+
+    // brightness drops by 48 dB (one step of eight bits) during
+    // the afterglow
+    fDecayAlpha = 1.0f - powf(1.0f / 256.0f, 1.0f / nFramesUntilDark);
+}
+
+
+void Goniometer::update(GoniometerBuffer* pGoniometerBuffer)
+/*  Fade out old points and draw new points.  Call once per frame.
+
+    pGoniometerBuffer (GoniometerBuffer*): buffer holding new points
+    (may be NULL)
+
+    return value: none
+*/
+{
+    int nNumberOfPoints = 0;
+
+    if (pGoniometerBuffer)
+    {
+        nNumberOfPoints = pGoniometerBuffer->readPoints(fSide, fMid, GoniometerBuffer::BUFFER_SIZE);
+    }
+
+    // drop points of digital silence, as they would otherwise keep
+    // the display from ever going dark
+    int nAudiblePoints = 0;
+
+    for (int nPoint = 0; nPoint < nNumberOfPoints; nPoint++)
+    {
+        if ((fabs(fSide[nPoint]) >= fMinimumLevel) || (fabs(fMid[nPoint]) >= fMinimumLevel))
+        {
+            fSide[nAudiblePoints] = fSide[nPoint];
+            fMid[nAudiblePoints] = fMid[nPoint];
+            nAudiblePoints++;
+        }
+    }
+
+    nNumberOfPoints = nAudiblePoints;
+
+    if (nNumberOfPoints > 0)
+    {
+        nFramesWithoutPoints = 0;
+    }
+    // nothing to do once all old points have faded out
+    else if (isDark())
+    {
+        return;
+    }
+    else
+    {
+        nFramesWithoutPoints++;
+    }
+
+    if (imagePersistence.isNull())
+    {
+        return;
+    }
+
+    int width = imagePersistence.getWidth();
+    int height = imagePersistence.getHeight();
+
+    // decay (the costs of this do not depend on the sample rate)
+    {
+        Graphics g(imagePersistence);
+        g.setColour(Colours::black.withAlpha(fDecayAlpha));
+        g.fillAll();
+    }
+
+    // full-scale signals on a single channel and mono signals at
+    // -3 dBFS lie on a circle touching the border
+    float fCentreX = width / 2.0f;
+    float fCentreY = height / 2.0f;
+    float fRadius = jmin(fCentreX, fCentreY) - 1.0f;
+
+    Image::BitmapData bitmapData(imagePersistence, Image::BitmapData::readWrite);
+
+    for (int nPoint = 0; nPoint < nNumberOfPoints; nPoint++)
+    {
+        int x = roundToInt(fCentreX + fSide[nPoint] * fRadius);
+        int y = roundToInt(fCentreY - fMid[nPoint] * fRadius);
+
+        if ((x < 1) || (x >= width - 1) || (y < 1) || (y >= height - 1))
+        {
+            continue;
+        }
+
+        // points that are hit repeatedly become brighter
+        Colour colourOld = bitmapData.getPixelColour(x, y);
+
+        uint8 nRed = (uint8) jmin(255, colourOld.getRed() + 24);
+        uint8 nGreen = (uint8) jmin(255, colourOld.getGreen() + 96);
+        uint8 nBlue = (uint8) jmin(255, colourOld.getBlue() + 48);
+
+        bitmapData.setPixelColour(x, y, Colour(nRed, nGreen, nBlue));
+    }
+
+    repaint();
+}
+
+
+bool Goniometer::isDark()
+/*  Check whether all points have faded out.
+
+    return value (Boolean): true if display shows no points
+*/
+{
+    return (nFramesWithoutPoints >= nFramesUntilDark);
+}
+
+
+void Goniometer::paint(Graphics& g)
+{
+    g.drawImageAt(imagePersistence, 0, 0);
+    g.drawImageAt(imageOverlay, 0, 0);
+}
+
+
+void Goniometer::resized()
+{
+    imagePersistence = Image(Image::RGB, getWidth(), getHeight(), true);
+    renderOverlay();
+}
+
+
+void Goniometer::renderOverlay()
+{
+    int width = getWidth();
+    int height = getHeight();
+
+    imageOverlay = Image(Image::ARGB, width, height, true);
+    Graphics g(imageOverlay);
+
+    float fCentreX = width / 2.0f;
+    float fCentreY = height / 2.0f;
+    float fRadius = jmin(fCentreX, fCentreY) - 1.0f;
+
+    // axes of left and right channel
+    g.setColour(Colours::white.withAlpha(0.15f));
+    g.drawLine(fCentreX - fRadius, fCentreY - fRadius, fCentreX + fRadius, fCentreY + fRadius);
+    g.drawLine(fCentreX + fRadius, fCentreY - fRadius, fCentreX - fRadius, fCentreY + fRadius);
+
+    // axes of mid and side signal
+    g.drawLine(fCentreX, fCentreY - fRadius, fCentreX, fCentreY + fRadius);
+    g.drawLine(fCentreX - fRadius, fCentreY, fCentreX + fRadius, fCentreY);
+
+    g.setColour(Colours::white);
+    g.setFont(11.0f);
+
+    g.drawFittedText("L", 2, 1, 12, 12, Justification::centred, 1, 1.0f);
+    g.drawFittedText("R", width - 14, 1, 12, 12, Justification::centred, 1, 1.0f);
+
+    g.setColour(Colours::darkgrey.darker(0.3f));
+    g.drawRect(0, 0, width, height, 1);
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,80 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __GONIOMETER_H__
+#define __GONIOMETER_H__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "goniometer_buffer.h"
+#include "meter_ballistics.h"
+
+
+//==============================================================================
+/**
+*/
+class Goniometer : public Component
+{
+public:
+    Goniometer(const String& componentName, const int frame_rate);
+    ~Goniometer();
+
+    void setFrameRate(const int frame_rate);
+    void update(GoniometerBuffer* pGoniometerBuffer);
+    bool isDark();
+
+    void paint(Graphics& g);
+    void resized();
+
+private:
+    JUCE_LEAK_DETECTOR(Goniometer);
+
+    // time until persistence has decayed to black
+    static const int AFTERGLOW_MILLISECONDS = 1000;
+
+    void renderOverlay();
+
+    float* fSide;
+    float* fMid;
+
+    int nFramesWithoutPoints;
+    int nFramesUntilDark;
+
+    float fDecayAlpha;
+    float fMinimumLevel;
+
+    // accumulated points with decay
+    Image imagePersistence;
+
+    // cached border, axes and labels
+    Image imageOverlay;
+};
+
+
+#endif  // __GONIOMETER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,158 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "goniometer_buffer.h"
+
+
+GoniometerBuffer::GoniometerBuffer(const int sample_rate)
+/*  Lock-free buffer that passes decimated stereo samples from the
+    audio thread to a goniometer.
+
+    sample_rate (integer): sample rate of audio
+
+    return value: none
+*/
+{
+    // keep the number of points (and thus CPU load of audio thread
+    // and display) independent of the sample rate
+    nDecimationFactor = jmax(1, roundToInt(sample_rate / (double) POINTS_PER_SECOND));
+    nSamplesToSkip = 0;
+
+    pFifo = new AbstractFifo(BUFFER_SIZE);
+
+    fSide = new float[BUFFER_SIZE];
+    fMid = new float[BUFFER_SIZE];
+}
+
+
+GoniometerBuffer::~GoniometerBuffer()
+{
+    delete pFifo;
+    pFifo = NULL;
+
+    delete [] fSide;
+    fSide = NULL;
+
+    delete [] fMid;
+    fMid = NULL;
+}
+
+
+void GoniometerBuffer::addSamples(AudioSampleBuffer& buffer, const int start_sample, const int number_of_samples)
+/*  Decimate stereo samples, rotate them by 45 degrees (mid and side)
+    and append them to buffer.  Points that do not fit into the buffer
+    are dropped.  Should only be called from the audio thread.
+
+    buffer (AudioSampleBuffer): audio samples (left and right channel)
+
+    start_sample (integer): position of first sample in buffer
+
+    number_of_samples (integer): number of samples to add
+
+    return value: none
+*/
+{
+    jassert(buffer.getNumChannels() >= 2);
+
+    // skip samples until the next point is due
+    if (nSamplesToSkip >= number_of_samples)
+    {
+        nSamplesToSkip -= number_of_samples;
+        return;
+    }
+
+    int nNumberOfPoints = (number_of_samples - nSamplesToSkip - 1) / nDecimationFactor + 1;
+
+    float* fLeft = buffer.getSampleData(0, start_sample);
+    float* fRight = buffer.getSampleData(1, start_sample);
+    int nSample = nSamplesToSkip;
+
+    // carry decimation over to the next block
+    nSamplesToSkip += nNumberOfPoints * nDecimationFactor - number_of_samples;
+
+    int nStart1, nSize1, nStart2, nSize2;
+    pFifo->prepareToWrite(nNumberOfPoints, nStart1, nSize1, nStart2, nSize2);
+
+    // the left channel points to the upper left, the right channel to
+    // the upper right
+    const float fScale = sqrtf(0.5f);
+
+    for (int nPoint = nStart1; nPoint < (nStart1 + nSize1); nPoint++)
+    {
+        fSide[nPoint] = (fRight[nSample] - fLeft[nSample]) * fScale;
+        fMid[nPoint] = (fLeft[nSample] + fRight[nSample]) * fScale;
+
+        nSample += nDecimationFactor;
+    }
+
+    for (int nPoint = nStart2; nPoint < (nStart2 + nSize2); nPoint++)
+    {
+        fSide[nPoint] = (fRight[nSample] - fLeft[nSample]) * fScale;
+        fMid[nPoint] = (fLeft[nSample] + fRight[nSample]) * fScale;
+
+        nSample += nDecimationFactor;
+    }
+
+    pFifo->finishedWrite(nSize1 + nSize2);
+}
+
+
+int GoniometerBuffer::readPoints(float* side, float* mid, const int maximum_points)
+/*  Remove points from buffer.  Should only be called from the message
+    thread.
+
+    side (float pointer): array that receives side values (x axis)
+
+    mid (float pointer): array that receives mid values (y axis)
+
+    maximum_points (integer): size of arrays
+
+    return value (integer): number of points read
+*/
+{
+    int nStart1, nSize1, nStart2, nSize2;
+    pFifo->prepareToRead(jmin(maximum_points, pFifo->getNumReady()), nStart1, nSize1, nStart2, nSize2);
+
+    if (nSize1 > 0)
+    {
+        memcpy(side, fSide + nStart1, nSize1 * sizeof(float));
+        memcpy(mid, fMid + nStart1, nSize1 * sizeof(float));
+    }
+
+    if (nSize2 > 0)
+    {
+        memcpy(side + nSize1, fSide + nStart2, nSize2 * sizeof(float));
+        memcpy(mid + nSize1, fMid + nStart2, nSize2 * sizeof(float));
+    }
+
+    pFifo->finishedRead(nSize1 + nSize2);
+
+    return nSize1 + nSize2;
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,68 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __GONIOMETER_BUFFER_H__
+#define __GONIOMETER_BUFFER_H__
+
+class GoniometerBuffer;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+
+//==============================================================================
+/**
+*/
+class GoniometerBuffer
+{
+public:
+    static const int BUFFER_SIZE = 4096;
+    static const int POINTS_PER_SECOND = 16000;
+
+    GoniometerBuffer(const int sample_rate);
+    ~GoniometerBuffer();
+
+    void addSamples(AudioSampleBuffer& buffer, const int start_sample, const int number_of_samples);
+    int readPoints(float* side, float* mid, const int maximum_points);
+
+private:
+    JUCE_LEAK_DETECTOR(GoniometerBuffer);
+
+    int nDecimationFactor;
+    int nSamplesToSkip;
+
+    // single writer (audio thread), single reader (message thread)
+    AbstractFifo* pFifo;
+
+    float* fSide;
+    float* fMid;
+};
+
+
+#endif  // __GONIOMETER_BUFFER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
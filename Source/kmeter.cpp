@@ -25,7 +25,7 @@
 
 #include "kmeter.h"
 
-Kmeter::Kmeter(const String& componentName, int posX, int posY, int nCrestFactor, int nNumChannels, const String& unitName, bool bIsSurround, bool bExpanded, bool bHorizontal, bool bDisplayPeakMeter, int nSegmentHeight)
+Kmeter::Kmeter(const String& componentName, int nCrestFactor, int nNumChannels, const String& unitName, bool bIsSurround, bool bExpanded, bool bHorizontal, bool bDisplayPeakMeter, int nSegmentHeight)
 {
     setName(componentName);
 
@@ -49,8 +49,6 @@ Kmeter::Kmeter(const String& componentName, int posX, int posY, int nCrestFactor
         nMeterPositionTop = 0;
     }
 
-    nPosX = posX;
-    nPosY = posY;
     nMainSegmentHeight = nSegmentHeight;
 
     if (nCrestFactor == 0)
@@ -183,7 +181,8 @@ void Kmeter::visibilityChanged()
             nWidth += 32;
         }
 
-        setBounds(nPosX, nPosY, nWidth, nHeight);
+        // position is set by the skin
+        setSize(nWidth, nHeight);
 
         if (nInputChannels == 1)
         {
@@ -223,7 +222,8 @@ void Kmeter::visibilityChanged()
             nHeight += 32;
         }
 
-        setBounds(nPosX, nPosY, nWidth, nHeight);
+        // position is set by the skin
+        setSize(nWidth, nHeight);
 
         if (nInputChannels == 1)
         {
@@ -253,6 +253,17 @@ void Kmeter::visibilityChanged()
 
 void Kmeter::paint(Graphics& g)
 {
+    g.drawImageAt(imageBackground, 0, 0);
+}
+
+
+void Kmeter::renderBackground()
+{
+    // this component blends in with the background, so start with a
+    // transparent image
+    imageBackground = Image(Image::ARGB, nWidth, nHeight, true);
+    Graphics g(imageBackground);
+
     if (nInputChannels == 1)
     {
         paintMonoChannel(g);
@@ -746,6 +757,11 @@ void Kmeter::paintStereoChannel(Graphics& g, int nStereoChannel)
 
 void Kmeter::resized()
 {
+    // scale, markers and labels never change for a given crest
+    // factor, orientation, expansion state and segment height (the
+    // meter is re-created when any of these change), so render them
+    // only when the meter is laid out
+    renderBackground();
 }
 
 
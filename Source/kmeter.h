@@ -42,7 +42,7 @@ public:
     static const int KMETER_STEREO_WIDTH = 106;
     static const int KMETER_STEREO_WIDTH_2 = KMETER_STEREO_WIDTH / 2;
 
-    Kmeter(const String& componentName, int PosX, int PosY, int nCrestFactor, int nNumChannels, const String& unitName, bool bIsSurround, bool bExpanded, bool bHorizontal, bool bDisplayPeakMeter, int nSegmentHeight);
+    Kmeter(const String& componentName, int nCrestFactor, int nNumChannels, const String& unitName, bool bIsSurround, bool bExpanded, bool bHorizontal, bool bDisplayPeakMeter, int nSegmentHeight);
     ~Kmeter();
 
     void setLevels(MeterBallistics* pMeterBallistics);
@@ -53,6 +53,7 @@ public:
 private:
     JUCE_LEAK_DETECTOR(Kmeter);
 
+    void renderBackground();
     void paintMonoChannel(Graphics& g);
     void paintStereoChannel(Graphics& g, int nStereoChannel);
 
@@ -60,8 +61,6 @@ private:
 
     int nWidth;
     int nHeight;
-    int nPosX;
-    int nPosY;
 
     int nMainSegmentHeight;
     int nMeterPositionTop;
@@ -78,6 +77,9 @@ private:
     OverflowMeter** OverflowMeters;
     PeakLabel** MaximumPeakLabels;
 
+    // cached scale, markers and labels
+    Image imageBackground;
+
     void drawMarkersMono(Graphics& g, String& strMarker, int x, int y, int width, int height);
     void drawMarkersMonoVertical(Graphics& g, String& strMarker, int x, int y, int width, int height);
     void drawMarkersMonoHorizontal(Graphics& g, String& strMarker, int x, int y, int width, int height);
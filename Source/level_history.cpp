@@ -0,0 +1,341 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "level_history.h"
+
+
+LevelHistory::LevelHistory(const double seconds_per_value, const int number_of_levels, const int entries_per_level, const int decimation_factor)
+/*  Constructor.  Keeps a history of levels at several time
+    resolutions, so that graphs of any length (from seconds to hours)
+    can be drawn without scanning the full history.  Every level
+    holds the minimum, maximum and mean of "decimation_factor"
+    entries of the level below in a ring buffer of fixed size.  Memory
+    usage is thus known in advance:
+
+    number_of_levels * entries_per_level * 3 * sizeof(float)
+
+    and the longest history that can be drawn is
+
+    seconds_per_value * decimation_factor^(number_of_levels - 1) *
+    entries_per_level
+
+    seconds_per_value (double): time between two calls of addValue()
+
+    number_of_levels (integer): number of time resolutions
+
+    entries_per_level (integer): length of each level's ring buffer
+
+    decimation_factor (integer): number of entries that are combined
+    into one entry of the next level
+
+    return value: none
+*/
+{
+    jassert(seconds_per_value > 0.0);
+    jassert(number_of_levels > 0);
+    jassert(entries_per_level > 0);
+    jassert(decimation_factor > 1);
+
+    dSecondsPerValue = seconds_per_value;
+    nNumberOfLevels = number_of_levels;
+    nEntriesPerLevel = entries_per_level;
+    nDecimationFactor = decimation_factor;
+
+    fMinimum = new float[nNumberOfLevels * nEntriesPerLevel];
+    fMaximum = new float[nNumberOfLevels * nEntriesPerLevel];
+    fMean = new float[nNumberOfLevels * nEntriesPerLevel];
+
+    nWritePosition = new int[nNumberOfLevels];
+    nEntriesWritten = new int64[nNumberOfLevels];
+
+    fPendingMinimum = new float[nNumberOfLevels];
+    fPendingMaximum = new float[nNumberOfLevels];
+    dPendingSum = new double[nNumberOfLevels];
+    nPendingEntries = new int[nNumberOfLevels];
+
+    reset();
+}
+
+
+LevelHistory::~LevelHistory()
+{
+    delete [] fMinimum;
+    fMinimum = NULL;
+
+    delete [] fMaximum;
+    fMaximum = NULL;
+
+    delete [] fMean;
+    fMean = NULL;
+
+    delete [] nWritePosition;
+    nWritePosition = NULL;
+
+    delete [] nEntriesWritten;
+    nEntriesWritten = NULL;
+
+    delete [] fPendingMinimum;
+    fPendingMinimum = NULL;
+
+    delete [] fPendingMaximum;
+    fPendingMaximum = NULL;
+
+    delete [] dPendingSum;
+    dPendingSum = NULL;
+
+    delete [] nPendingEntries;
+    nPendingEntries = NULL;
+}
+
+
+void LevelHistory::reset()
+/*  Clear history.
+
+    return value: none
+*/
+{
+    for (int nLevel = 0; nLevel < nNumberOfLevels; nLevel++)
+    {
+        nWritePosition[nLevel] = 0;
+        nEntriesWritten[nLevel] = 0;
+
+        fPendingMinimum[nLevel] = 0.0f;
+        fPendingMaximum[nLevel] = 0.0f;
+        dPendingSum[nLevel] = 0.0;
+        nPendingEntries[nLevel] = 0;
+    }
+}
+
+
+void LevelHistory::addValue(const float value)
+/*  Add a level to the history.  Neither locks nor allocates memory,
+    so this may be called on the audio thread.
+
+    value (float): level (usually in decibels)
+
+    return value: none
+*/
+{
+    addEntry(0, value, value, value);
+}
+
+
+void LevelHistory::addEntry(const int level, const float minimum, const float maximum, const float mean)
+{
+    int nIndex = level * nEntriesPerLevel + nWritePosition[level];
+
+    fMinimum[nIndex] = minimum;
+    fMaximum[nIndex] = maximum;
+    fMean[nIndex] = mean;
+
+    nWritePosition[level] = (nWritePosition[level] + 1) % nEntriesPerLevel;
+    nEntriesWritten[level]++;
+
+    int nNextLevel = level + 1;
+
+    if (nNextLevel >= nNumberOfLevels)
+    {
+        return;
+    }
+
+    if (nPendingEntries[nNextLevel] == 0)
+    {
+        fPendingMinimum[nNextLevel] = minimum;
+        fPendingMaximum[nNextLevel] = maximum;
+        dPendingSum[nNextLevel] = mean;
+    }
+    else
+    {
+        fPendingMinimum[nNextLevel] = jmin(fPendingMinimum[nNextLevel], minimum);
+        fPendingMaximum[nNextLevel] = jmax(fPendingMaximum[nNextLevel], maximum);
+        dPendingSum[nNextLevel] += mean;
+    }
+
+    nPendingEntries[nNextLevel]++;
+
+    if (nPendingEntries[nNextLevel] >= nDecimationFactor)
+    {
+        nPendingEntries[nNextLevel] = 0;
+        addEntry(nNextLevel, fPendingMinimum[nNextLevel], fPendingMaximum[nNextLevel], (float)(dPendingSum[nNextLevel] / nDecimationFactor));
+    }
+}
+
+
+int LevelHistory::getNumberOfLevels()
+{
+    return nNumberOfLevels;
+}
+
+
+double LevelHistory::getSecondsPerEntry(const int level)
+/*  Get time resolution of a level.
+
+    level (integer): selected level (0 is the finest)
+
+    return value (double): time covered by a single entry in seconds
+*/
+{
+    jassert(level >= 0);
+    jassert(level < nNumberOfLevels);
+
+    double dSecondsPerEntry = dSecondsPerValue;
+
+    for (int nLevel = 0; nLevel < level; nLevel++)
+    {
+        dSecondsPerEntry *= nDecimationFactor;
+    }
+
+    return dSecondsPerEntry;
+}
+
+
+double LevelHistory::getLengthInSeconds(const int level)
+/*  Get length of history that a level can hold.
+
+    level (integer): selected level (0 is the finest)
+
+    return value (double): length of history in seconds
+*/
+{
+    return getSecondsPerEntry(level) * nEntriesPerLevel;
+}
+
+
+int LevelHistory::getNumberOfEntries(const int level)
+/*  Get number of entries a level currently holds.
+
+    level (integer): selected level (0 is the finest)
+
+    return value (integer): number of entries
+*/
+{
+    jassert(level >= 0);
+    jassert(level < nNumberOfLevels);
+
+    return (int) jmin((int64) nEntriesPerLevel, nEntriesWritten[level]);
+}
+
+
+int LevelHistory::getHistory(const double seconds, const int number_of_points, float* minimum, float* maximum, float* mean)
+/*  Get the most recent part of the history, resampled to a given
+    number of points (e.g. one point per pixel).  The coarsest level
+    that still provides at least one entry per point is used, so the
+    cost depends on the number of points, but not on the length of
+    the history.  Entries that have not yet been combined into an
+    entry of the chosen level are not included.
+
+    Please note that the history may be updated on the audio thread
+    while it is being read.  Single points may then be slightly off,
+    which does no harm when drawing graphs.
+
+    seconds (double): length of history
+
+    number_of_points (integer): number of points to return
+
+    minimum (float*): array receiving the minimum level of each
+    point; oldest point first
+
+    maximum (float*): array receiving the maximum level of each
+    point; oldest point first
+
+    mean (float*): array receiving the mean level of each point;
+    oldest point first
+
+    return value (integer): number of points that hold data; these
+    are the last points of the arrays, the others are left unchanged
+*/
+{
+    jassert(seconds > 0.0);
+    jassert(number_of_points > 0);
+
+    double dSecondsPerPoint = seconds / number_of_points;
+    int nLevel = 0;
+
+    // select coarsest level with at least one entry per point ...
+    while (((nLevel + 1) < nNumberOfLevels) && (getSecondsPerEntry(nLevel + 1) <= dSecondsPerPoint))
+    {
+        nLevel++;
+    }
+
+    // ... that reaches back far enough
+    while (((nLevel + 1) < nNumberOfLevels) && (getLengthInSeconds(nLevel) < seconds))
+    {
+        nLevel++;
+    }
+
+    double dEntriesPerPoint = dSecondsPerPoint / getSecondsPerEntry(nLevel);
+    int nEntries = getNumberOfEntries(nLevel);
+    int nNewestEntry = nWritePosition[nLevel] - 1 + nEntriesPerLevel;
+    int nOffset = nLevel * nEntriesPerLevel;
+    int nValidPoints = 0;
+
+    for (int nPoint = 0; nPoint < number_of_points; nPoint++)
+    {
+        // entries are counted backwards, starting with the newest one
+        int nFirstEntry = (int) floor((number_of_points - nPoint - 1) * dEntriesPerPoint);
+        int nLastEntry = jmax(nFirstEntry, (int) ceil((number_of_points - nPoint) * dEntriesPerPoint) - 1);
+        nLastEntry = jmin(nLastEntry, nEntries - 1);
+
+        if (nFirstEntry > nLastEntry)
+        {
+            continue;
+        }
+
+        float fPointMinimum = 0.0f;
+        float fPointMaximum = 0.0f;
+        double dPointSum = 0.0;
+
+        for (int nEntry = nFirstEntry; nEntry <= nLastEntry; nEntry++)
+        {
+            int nIndex = nOffset + (nNewestEntry - nEntry) % nEntriesPerLevel;
+
+            if (nEntry == nFirstEntry)
+            {
+                fPointMinimum = fMinimum[nIndex];
+                fPointMaximum = fMaximum[nIndex];
+            }
+            else
+            {
+                fPointMinimum = jmin(fPointMinimum, fMinimum[nIndex]);
+                fPointMaximum = jmax(fPointMaximum, fMaximum[nIndex]);
+            }
+
+            dPointSum += fMean[nIndex];
+        }
+
+        minimum[nPoint] = fPointMinimum;
+        maximum[nPoint] = fPointMaximum;
+        mean[nPoint] = (float)(dPointSum / (nLastEntry - nFirstEntry + 1));
+
+        nValidPoints++;
+    }
+
+    return nValidPoints;
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
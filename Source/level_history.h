@@ -0,0 +1,84 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __LEVEL_HISTORY_H__
+#define __LEVEL_HISTORY_H__
+
+class LevelHistory;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+
+//==============================================================================
+/**
+*/
+class LevelHistory
+{
+public:
+    LevelHistory(const double seconds_per_value, const int number_of_levels, const int entries_per_level, const int decimation_factor);
+    ~LevelHistory();
+
+    void reset();
+    void addValue(const float value);
+
+    int getNumberOfLevels();
+    double getSecondsPerEntry(const int level);
+    double getLengthInSeconds(const int level);
+    int getNumberOfEntries(const int level);
+
+    int getHistory(const double seconds, const int number_of_points, float* minimum, float* maximum, float* mean);
+
+private:
+    JUCE_LEAK_DETECTOR(LevelHistory);
+
+    void addEntry(const int level, const float minimum, const float maximum, const float mean);
+
+    int nNumberOfLevels;
+    int nEntriesPerLevel;
+    int nDecimationFactor;
+    double dSecondsPerValue;
+
+    // ring buffers of all levels, one after another
+    float* fMinimum;
+    float* fMaximum;
+    float* fMean;
+
+    int* nWritePosition;
+    int64* nEntriesWritten;
+
+    // entries that have not yet been passed to the next level
+    float* fPendingMinimum;
+    float* fPendingMaximum;
+    double* dPendingSum;
+    int* nPendingEntries;
+};
+
+
+#endif  // __LEVEL_HISTORY_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
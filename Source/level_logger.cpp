@@ -0,0 +1,648 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "level_logger.h"
+
+#include <limits>
+
+
+LevelLogger::LevelLogger(const File& directory, const int channels, const int sample_rate, const int chunk_size, const int rotation_seconds, const int64 maximum_file_size, const int maximum_files)
+    : Thread("K-Meter level logger")
+/*  Constructor.  Logs meter readings once per second for unattended
+    long-term monitoring (e.g. broadcast compliance): sample peak and
+    true peak level of every channel, momentary and short-term
+    loudness (ITU-R BS.1770 mode only) and phase correlation (stereo
+    only).
+
+    Readings are collected on the audio thread and queued in a
+    preallocated lock-free queue; no memory is allocated and no files
+    are accessed on the audio thread.  A low-priority thread writes
+    the queue to binary log files (see MeasurementLog), starting a new
+    file after a given time or file size.  Memory usage does not grow
+    with uptime.
+
+    Every record carries the wall-clock time it was taken at, so log
+    files show real time even though the host may stop processing
+    audio or restart it (which creates a new logger).
+
+    directory (const File&): directory receiving the log files
+
+    channels (integer): number of audio channels
+
+    sample_rate (integer): sample rate of the audio input
+
+    chunk_size (integer): number of samples per processed chunk
+
+    rotation_seconds (integer): start a new log file after this many
+    seconds
+
+    maximum_file_size (64-bit integer): start a new log file once the
+    current one has reached this size (in bytes)
+
+    maximum_files (integer): delete the oldest log files of this
+    logger so that no more than this number of files are kept, and
+    delete log files of earlier sessions and other instances in the
+    same directory once they are older than this number of rotation
+    periods (0 keeps all files)
+
+    return value: none
+*/
+{
+    jassert(channels > 0);
+    jassert(chunk_size > 0);
+    jassert(rotation_seconds > 0);
+
+    directoryLog = directory;
+
+    nNumberOfChannels = channels;
+    nSampleRate = sample_rate;
+    nChunkSize = chunk_size;
+
+    nRotationSeconds = rotation_seconds;
+    nMaximumFileSize = maximum_file_size;
+    nMaximumFiles = maximum_files;
+
+    // several instances may log to the same directory
+    strFilePrefix = "kmeter_" + Uuid().toString().substring(0, 8) + "_";
+    pLogStream = NULL;
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        arrColumns.add("peak_" + String(nChannel + 1));
+    }
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        arrColumns.add("true_peak_" + String(nChannel + 1));
+    }
+
+    arrColumns.add("momentary");
+    arrColumns.add("short_term");
+
+    if (nNumberOfChannels == 2)
+    {
+        arrColumns.add("corr");
+    }
+
+    nNumberOfColumns = arrColumns.size();
+
+    // queue holds ten minutes of readings, so the writer may be held
+    // up by a slow disk for quite a while before readings are lost
+    int nQueueLength = 600;
+
+    pFifo = new AbstractFifo(nQueueLength);
+    pTimecodes = new int64[nQueueLength];
+    pTimes = new int64[nQueueLength];
+    pValues = new float[nQueueLength * nNumberOfColumns];
+    nDroppedRecords.set(0);
+
+    nStartTime = Time::currentTimeMillis();
+    nSamplesLogged = 0;
+    nSamplesInRecord = 0;
+
+    fPeakLevels = new float[nNumberOfChannels];
+    fTruePeakLevels = new float[nNumberOfChannels];
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        fPeakLevels[nChannel] = 0.0f;
+        fTruePeakLevels[nChannel] = 0.0f;
+    }
+
+    fPhaseCorrelationSum = 0.0f;
+    nPhaseCorrelationChunks = 0;
+
+    // the first (nTruePeakTaps - 1) samples hold the end of the
+    // previous chunk
+    fTruePeakCoefficients = new float[nTruePeakOversampling * nTruePeakTaps];
+    calculateTruePeakCoefficients();
+
+    pTruePeakBuffer = new AudioSampleBuffer(nNumberOfChannels, nTruePeakTaps - 1 + nChunkSize);
+    pTruePeakBuffer->clear();
+
+    // loudness windows of 400 ms (momentary) and 3 s (short-term),
+    // rounded to whole chunks
+    nMomentaryChunks = jmax(1, roundToInt(0.4 * nSampleRate / nChunkSize));
+    nShortTermChunks = jmax(1, roundToInt(3.0 * nSampleRate / nChunkSize));
+
+    dChunkEnergies = new double[nShortTermChunks];
+
+    for (int nChunk = 0; nChunk < nShortTermChunks; nChunk++)
+    {
+        dChunkEnergies[nChunk] = 0.0;
+    }
+
+    nLoudnessChunks = 0;
+    nCurrentChunk = 0;
+
+    startThread(1);
+}
+
+
+LevelLogger::~LevelLogger()
+{
+    // the writer checks for this at least four times per second
+    stopThread(5000);
+
+    // write remaining records; deleting the stream flushes and
+    // closes the log file
+    writeRecords();
+
+    delete pLogStream;
+    pLogStream = NULL;
+
+    // gaps in the log's timecodes show where records are missing, but
+    // nobody may look for them
+    if (nDroppedRecords.get() > 0)
+    {
+        Logger::writeToLog("[K-Meter] level logger fell behind, " + String(nDroppedRecords.get()) + " record(s) were dropped");
+    }
+
+    delete pFifo;
+    pFifo = NULL;
+
+    delete [] pTimecodes;
+    pTimecodes = NULL;
+
+    delete [] pTimes;
+    pTimes = NULL;
+
+    delete [] pValues;
+    pValues = NULL;
+
+    delete [] fPeakLevels;
+    fPeakLevels = NULL;
+
+    delete [] fTruePeakLevels;
+    fTruePeakLevels = NULL;
+
+    delete [] fTruePeakCoefficients;
+    fTruePeakCoefficients = NULL;
+
+    delete pTruePeakBuffer;
+    pTruePeakBuffer = NULL;
+
+    delete [] dChunkEnergies;
+    dChunkEnergies = NULL;
+}
+
+
+void LevelLogger::calculateTruePeakCoefficients()
+/*  Design interpolation filter for four-fold oversampling (ITU-R
+    BS.1770-3, annex 2): windowed sinc of 48 taps, split into four
+    phases of 12 taps each.
+
+    return value: none
+*/
+{
+    int nTaps = nTruePeakOversampling * nTruePeakTaps;
+    double dCentre = (nTaps - 1) / 2.0;
+
+    for (int nTap = 0; nTap < nTaps; nTap++)
+    {
+        double dPosition = (nTap - dCentre) / nTruePeakOversampling;
+        double dSinc = 1.0;
+
+        if (dPosition != 0.0)
+        {
+            dSinc = sin(double_Pi * dPosition) / (double_Pi * dPosition);
+        }
+
+        // Hann window
+        double dWindow = 0.5 - 0.5 * cos(2.0 * double_Pi * (nTap + 0.5) / nTaps);
+
+        // store coefficients sorted by phase
+        int nPhase = nTap % nTruePeakOversampling;
+        int nIndex = nTap / nTruePeakOversampling;
+
+        fTruePeakCoefficients[nPhase * nTruePeakTaps + nIndex] = (float)(dSinc * dWindow);
+    }
+}
+
+
+float LevelLogger::getTruePeakLevel(const int channel)
+/*  Determine true peak level of the chunk in the true peak buffer by
+    interpolating three samples between all input samples.
+
+    channel (integer): selected audio channel
+
+    return value (float): true peak level (linear)
+*/
+{
+    float* fSamples = pTruePeakBuffer->getSampleData(channel);
+    float fTruePeakLevel = 0.0f;
+
+    for (int nSample = nTruePeakTaps - 1; nSample < (nTruePeakTaps - 1 + nChunkSize); nSample++)
+    {
+        for (int nPhase = 0; nPhase < nTruePeakOversampling; nPhase++)
+        {
+            float* fCoefficients = fTruePeakCoefficients + nPhase * nTruePeakTaps;
+            float fOutput = 0.0f;
+
+            for (int nTap = 0; nTap < nTruePeakTaps; nTap++)
+            {
+                fOutput += fCoefficients[nTap] * fSamples[nSample - nTap];
+            }
+
+            fOutput = fabs(fOutput);
+
+            if (fOutput > fTruePeakLevel)
+            {
+                fTruePeakLevel = fOutput;
+            }
+        }
+    }
+
+    // keep end of chunk for the next one
+    for (int nSample = 0; nSample < (nTruePeakTaps - 1); nSample++)
+    {
+        fSamples[nSample] = fSamples[nChunkSize + nSample];
+    }
+
+    return fTruePeakLevel;
+}
+
+
+void LevelLogger::processBufferChunk(MeterAnalyser& meter_analyser, AudioRingBuffer& ring_buffer, const unsigned int chunk_size)
+/*  Collect readings of the latest chunk.  Call this on the audio
+    thread right after the meter analyser has processed the chunk.
+    Neither locks, allocates memory nor accesses files.
+
+    meter_analyser (MeterAnalyser&): meter analyser holding the
+    readings of the latest chunk
+
+    ring_buffer (AudioRingBuffer&): ring buffer holding the audio
+    input
+
+    chunk_size (unsigned integer): number of samples in chunk; must
+    match the chunk size passed to the constructor
+
+    return value: none
+*/
+{
+    jassert((int) chunk_size == nChunkSize);
+
+    // use the same pre-delay as the meter analyser
+    unsigned int uPreDelay = chunk_size / 2;
+    ring_buffer.copyToBuffer(*pTruePeakBuffer, nTruePeakTaps - 1, chunk_size, uPreDelay);
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        float fPeakLevel = meter_analyser.getPeakLevel(nChannel);
+
+        if (fPeakLevel > fPeakLevels[nChannel])
+        {
+            fPeakLevels[nChannel] = fPeakLevel;
+        }
+
+        // true peak level is never lower than the sample peak level
+        float fTruePeakLevel = jmax(fPeakLevel, getTruePeakLevel(nChannel));
+
+        if (fTruePeakLevel > fTruePeakLevels[nChannel])
+        {
+            fTruePeakLevels[nChannel] = fTruePeakLevel;
+        }
+    }
+
+    if (meter_analyser.getAverageAlgorithm() == KmeterPluginParameters::selAlgorithmItuBs1770)
+    {
+        // convert loudness back to weighted mean square
+        float fLoudness = meter_analyser.getAverageLevel(0);
+        dChunkEnergies[nCurrentChunk] = pow(10.0, (fLoudness + 0.691) / 10.0);
+
+        nCurrentChunk = (nCurrentChunk + 1) % nShortTermChunks;
+
+        if (nLoudnessChunks < nShortTermChunks)
+        {
+            nLoudnessChunks++;
+        }
+    }
+    else
+    {
+        nLoudnessChunks = 0;
+    }
+
+    if (nNumberOfChannels == 2)
+    {
+        fPhaseCorrelationSum += meter_analyser.getPhaseCorrelation();
+        nPhaseCorrelationChunks++;
+    }
+
+    nSamplesLogged += chunk_size;
+    nSamplesInRecord += chunk_size;
+
+    if (nSamplesInRecord >= nSampleRate)
+    {
+        addRecord();
+        nSamplesInRecord -= nSampleRate;
+    }
+}
+
+
+void LevelLogger::addRecord()
+/*  Queue readings of the past second and start collecting new ones.
+    Runs on the audio thread.
+
+    return value: none
+*/
+{
+    int nStart1, nSize1, nStart2, nSize2;
+    pFifo->prepareToWrite(1, nStart1, nSize1, nStart2, nSize2);
+
+    if (nSize1 < 1)
+    {
+        ++nDroppedRecords;
+    }
+    else
+    {
+        pTimecodes[nStart1] = nSamplesLogged;
+        pTimes[nStart1] = Time::currentTimeMillis();
+        float* fValues = pValues + nStart1 * nNumberOfColumns;
+        int nColumn = 0;
+
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            fValues[nColumn++] = MeterBallistics::level2decibel(fPeakLevels[nChannel]);
+        }
+
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            fValues[nColumn++] = MeterBallistics::level2decibel(fTruePeakLevels[nChannel]);
+        }
+
+        if (nLoudnessChunks > 0)
+        {
+            double dMomentaryEnergy = 0.0;
+            double dShortTermEnergy = 0.0;
+
+            // at start-up, the windows are only partly filled
+            int nMomentaryChunksFinal = jmin(nMomentaryChunks, nLoudnessChunks);
+
+            for (int nChunk = 1; nChunk <= nLoudnessChunks; nChunk++)
+            {
+                double dEnergy = dChunkEnergies[(nCurrentChunk - nChunk + nShortTermChunks) % nShortTermChunks];
+
+                if (nChunk <= nMomentaryChunksFinal)
+                {
+                    dMomentaryEnergy += dEnergy;
+                }
+
+                dShortTermEnergy += dEnergy;
+            }
+
+            dMomentaryEnergy /= nMomentaryChunksFinal;
+            dShortTermEnergy /= nLoudnessChunks;
+
+            float fMeterMinimumDecibel = MeterBallistics::getMeterMinimumDecibel();
+
+            fValues[nColumn++] = (dMomentaryEnergy > 0.0) ? jmax(fMeterMinimumDecibel, (float)(-0.691 + 10.0 * log10(dMomentaryEnergy))) : fMeterMinimumDecibel;
+            fValues[nColumn++] = (dShortTermEnergy > 0.0) ? jmax(fMeterMinimumDecibel, (float)(-0.691 + 10.0 * log10(dShortTermEnergy))) : fMeterMinimumDecibel;
+        }
+        else
+        {
+            // loudness is only measured in ITU-R BS.1770 mode
+            fValues[nColumn++] = std::numeric_limits<float>::quiet_NaN();
+            fValues[nColumn++] = std::numeric_limits<float>::quiet_NaN();
+        }
+
+        if (nNumberOfChannels == 2)
+        {
+            fValues[nColumn++] = (nPhaseCorrelationChunks > 0) ? (fPhaseCorrelationSum / nPhaseCorrelationChunks) : 1.0f;
+        }
+
+        pFifo->finishedWrite(1);
+    }
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        fPeakLevels[nChannel] = 0.0f;
+        fTruePeakLevels[nChannel] = 0.0f;
+    }
+
+    fPhaseCorrelationSum = 0.0f;
+    nPhaseCorrelationChunks = 0;
+}
+
+
+int64 LevelLogger::getNumberOfDroppedRecords()
+/*  Get number of records that were dropped because the writer
+    thread had fallen behind.
+
+    return value (64-bit integer): number of dropped records
+*/
+{
+    return nDroppedRecords.get();
+}
+
+
+void LevelLogger::run()
+{
+    while (!threadShouldExit())
+    {
+        writeRecords();
+        wait(250);
+    }
+}
+
+
+void LevelLogger::writeRecords()
+/*  Write queued records to disk.  Runs on the writer thread.
+
+    return value: none
+*/
+{
+    int nStart1, nSize1, nStart2, nSize2;
+    pFifo->prepareToRead(pFifo->getNumReady(), nStart1, nSize1, nStart2, nSize2);
+
+    if ((nSize1 + nSize2) == 0)
+    {
+        return;
+    }
+
+    // the queue may wrap around, so write up to two segments
+    for (int nSegment = 0; nSegment < 2; nSegment++)
+    {
+        int nStart = (nSegment == 0) ? nStart1 : nStart2;
+        int nSize = (nSegment == 0) ? nSize1 : nSize2;
+
+        while (nSize > 0)
+        {
+            int nRows = getRowsInBlock(nStart, nSize);
+
+            if ((pLogStream == NULL) || (pLogStream->getPosition() >= nMaximumFileSize) || (Time::getCurrentTime() >= timeRotation))
+            {
+                if (!openNextFile())
+                {
+                    // try again later
+                    nDroppedRecords += nRows;
+                }
+            }
+
+            if (pLogStream)
+            {
+                MeasurementLog::writeBlock(*pLogStream, pTimes[nStart], pTimecodes + nStart, pValues + nStart * nNumberOfColumns, nRows, nNumberOfColumns);
+            }
+
+            nStart += nRows;
+            nSize -= nRows;
+        }
+    }
+
+    pFifo->finishedRead(nSize1 + nSize2);
+
+    // keep log files up to date in case of a crash
+    if (pLogStream)
+    {
+        pLogStream->flush();
+    }
+}
+
+
+int LevelLogger::getRowsInBlock(const int start, const int size)
+/*  Find queued records that share a time base.  The audio thread
+    stops when the host stops processing audio, so the sample clock
+    falls behind the wall clock; records after such a gap start a new
+    block.
+
+    start (integer): index of the first record in the queue
+
+    size (integer): number of contiguous records in the queue
+
+    return value (integer): number of records in block
+*/
+{
+    int nRows = 1;
+
+    while (nRows < size)
+    {
+        int64 nElapsedSamples = pTimecodes[start + nRows] - pTimecodes[start];
+        int64 nElapsedMilliSeconds = pTimes[start + nRows] - pTimes[start];
+        int64 nDrift = nElapsedMilliSeconds - (nElapsedSamples * 1000) / nSampleRate;
+
+        if ((nDrift > nMaximumDriftMilliSeconds) || (nDrift < -nMaximumDriftMilliSeconds))
+        {
+            break;
+        }
+
+        nRows++;
+    }
+
+    return nRows;
+}
+
+
+bool LevelLogger::openNextFile()
+/*  Close current log file and start a new one.  Runs on the writer
+    thread.
+
+    return value (Boolean): false if the log file could not be opened
+*/
+{
+    delete pLogStream;
+    pLogStream = NULL;
+
+    Time timeNow = Time::getCurrentTime();
+    timeRotation = timeNow + RelativeTime::seconds(nRotationSeconds);
+
+    // file names sort by time
+    File fileLog = directoryLog.getChildFile(strFilePrefix + timeNow.formatted("%Y-%m-%d_%H-%M-%S") + ".kmlog");
+
+    directoryLog.createDirectory();
+    fileLog.deleteFile();
+
+    pLogStream = new FileOutputStream(fileLog);
+
+    if (pLogStream->failedToOpen())
+    {
+        delete pLogStream;
+        pLogStream = NULL;
+
+        return false;
+    }
+
+    MeasurementLog::writeHeader(*pLogStream, arrColumns, nSampleRate, nStartTime);
+    deleteOldFiles();
+
+    return true;
+}
+
+
+void LevelLogger::deleteOldFiles()
+/*  Delete oldest log files of this logger until no more than the
+    maximum number of files is left.  Log files of earlier sessions
+    and other instances have different prefixes, so these are deleted
+    once they have not been written to for as long as the maximum
+    number of files would cover.
+
+    return value: none
+*/
+{
+    if (nMaximumFiles <= 0)
+    {
+        return;
+    }
+
+    Array<File> arrFiles;
+    directoryLog.findChildFiles(arrFiles, File::findFiles, false, "kmeter_*.kmlog");
+
+    // files of running instances are written to at least once per
+    // rotation period
+    Time timeExpiry = Time::getCurrentTime() - RelativeTime::seconds((double) nMaximumFiles * nRotationSeconds);
+
+    // file names contain the time they were started at
+    StringArray arrFileNames;
+
+    for (int nFile = 0; nFile < arrFiles.size(); nFile++)
+    {
+        if (!arrFiles[nFile].getFileName().startsWith(strFilePrefix))
+        {
+            if (arrFiles[nFile].getLastModificationTime() < timeExpiry)
+            {
+                arrFiles[nFile].deleteFile();
+            }
+        }
+        else
+        {
+            arrFileNames.add(arrFiles[nFile].getFullPathName());
+        }
+    }
+
+    if (arrFileNames.size() <= nMaximumFiles)
+    {
+        return;
+    }
+
+    arrFileNames.sort(false);
+
+    for (int nFile = 0; nFile < (arrFileNames.size() - nMaximumFiles); nFile++)
+    {
+        File(arrFileNames[nFile]).deleteFile();
+    }
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
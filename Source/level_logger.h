@@ -0,0 +1,123 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __LEVEL_LOGGER_H__
+#define __LEVEL_LOGGER_H__
+
+class LevelLogger;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "audio_ring_buffer.h"
+#include "measurement_log.h"
+#include "meter_analyser.h"
+
+
+//==============================================================================
+/**
+*/
+class LevelLogger : public Thread
+{
+public:
+    LevelLogger(const File& directory, const int channels, const int sample_rate, const int chunk_size, const int rotation_seconds, const int64 maximum_file_size, const int maximum_files);
+    ~LevelLogger();
+
+    void processBufferChunk(MeterAnalyser& meter_analyser, AudioRingBuffer& ring_buffer, const unsigned int chunk_size);
+
+    int64 getNumberOfDroppedRecords();
+
+    void run();
+
+private:
+    JUCE_LEAK_DETECTOR(LevelLogger);
+
+    static const int nTruePeakOversampling = 4;
+    static const int nTruePeakTaps = 12;
+
+    // start a new block when sample clock and wall clock drift
+    // apart by more than this
+    static const int nMaximumDriftMilliSeconds = 500;
+
+    void calculateTruePeakCoefficients();
+    float getTruePeakLevel(const int channel);
+
+    void addRecord();
+    void writeRecords();
+    int getRowsInBlock(const int start, const int size);
+    bool openNextFile();
+    void deleteOldFiles();
+
+    File directoryLog;
+    String strFilePrefix;
+    StringArray arrColumns;
+
+    int nNumberOfChannels;
+    int nSampleRate;
+    int nChunkSize;
+    int nNumberOfColumns;
+
+    int nRotationSeconds;
+    int64 nMaximumFileSize;
+    int nMaximumFiles;
+
+    FileOutputStream* pLogStream;
+    Time timeRotation;
+
+    AbstractFifo* pFifo;
+    int64* pTimecodes;
+    int64* pTimes;
+    float* pValues;
+
+    // incremented on the audio thread and the writer thread
+    Atomic<int64> nDroppedRecords;
+
+    // wall-clock time when logging started (milliseconds since
+    // 1970), so timecodes are rebased whenever the host restarts
+    // audio processing
+    int64 nStartTime;
+    int64 nSamplesLogged;
+    int nSamplesInRecord;
+
+    float* fPeakLevels;
+    float* fTruePeakLevels;
+    float fPhaseCorrelationSum;
+    int nPhaseCorrelationChunks;
+
+    float* fTruePeakCoefficients;
+    AudioSampleBuffer* pTruePeakBuffer;
+
+    double* dChunkEnergies;
+    int nMomentaryChunks;
+    int nShortTermChunks;
+    int nLoudnessChunks;
+    int nCurrentChunk;
+};
+
+
+#endif  // __LEVEL_LOGGER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,219 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "loudness_histogram.h"
+
+
+// gating thresholds as defined in ITU-R BS.1770-3
+float LoudnessHistogram::fAbsoluteGate = -70.0f;
+float LoudnessHistogram::fRelativeGate = -10.0f;
+
+float LoudnessHistogram::fBinWidth = 0.1f;
+
+
+LoudnessHistogram::LoudnessHistogram()
+/*  Constructor.  Collects the loudness of gating blocks so that the
+    gated (integrated) loudness can be calculated once all blocks
+    have been added.
+
+    Gating blocks are not stored individually.  Instead, each bin
+    counts its blocks and sums up their mean squares, so the
+    histograms of several parts of an audio file can simply be added
+    up.  This makes the integrated loudness independent of how the
+    file has been split for analysis; the relative gate is resolved
+    to the bin width of 0.1 LU.
+
+    return value: none
+*/
+{
+    reset();
+}
+
+
+LoudnessHistogram::~LoudnessHistogram()
+{
+}
+
+
+void LoudnessHistogram::reset()
+/*  Remove all gating blocks.
+
+    return value: none
+*/
+{
+    for (int nBin = 0; nBin < KMETER_LOUDNESS_HISTOGRAM_BINS; nBin++)
+    {
+        nBlockCounts[nBin] = 0;
+        dBlockEnergies[nBin] = 0.0;
+    }
+}
+
+
+void LoudnessHistogram::addBlock(const double mean_square)
+/*  Add a gating block.
+
+    mean_square (double): weighted and summed mean square of all
+    channels (i.e. the term inside the logarithm of ITU-R BS.1770)
+
+    return value: none
+*/
+{
+    float fLoudness = energy2loudness(mean_square);
+
+    // apply absolute gate
+    if (fLoudness <= fAbsoluteGate)
+    {
+        return;
+    }
+
+    int nBin = getBin(fLoudness);
+
+    nBlockCounts[nBin]++;
+    dBlockEnergies[nBin] += mean_square;
+}
+
+
+void LoudnessHistogram::merge(const LoudnessHistogram& other)
+/*  Add gating blocks of another histogram.  Merging is associative
+    and commutative, so partial histograms may be merged in any
+    order.
+
+    other (const LoudnessHistogram&): histogram to be merged
+
+    return value: none
+*/
+{
+    for (int nBin = 0; nBin < KMETER_LOUDNESS_HISTOGRAM_BINS; nBin++)
+    {
+        nBlockCounts[nBin] += other.nBlockCounts[nBin];
+        dBlockEnergies[nBin] += other.dBlockEnergies[nBin];
+    }
+}
+
+
+int64 LoudnessHistogram::getNumberOfBlocks() const
+/*  Get number of gating blocks above the absolute gate.
+
+    return value (64-bit integer): number of gating blocks
+*/
+{
+    int64 nBlocks = 0;
+
+    for (int nBin = 0; nBin < KMETER_LOUDNESS_HISTOGRAM_BINS; nBin++)
+    {
+        nBlocks += nBlockCounts[nBin];
+    }
+
+    return nBlocks;
+}
+
+
+float LoudnessHistogram::getIntegratedLoudness() const
+/*  Calculate gated loudness according to ITU-R BS.1770-3.
+
+    return value (float): integrated loudness in LUFS, or the
+    absolute gate if no gating block has passed it
+*/
+{
+    int64 nBlocks = 0;
+    double dEnergy = 0.0;
+
+    for (int nBin = 0; nBin < KMETER_LOUDNESS_HISTOGRAM_BINS; nBin++)
+    {
+        nBlocks += nBlockCounts[nBin];
+        dEnergy += dBlockEnergies[nBin];
+    }
+
+    if (nBlocks == 0)
+    {
+        return fAbsoluteGate;
+    }
+
+    // relative gate is applied to the loudness of all blocks that
+    // have passed the absolute gate
+    float fGate = energy2loudness(dEnergy / double(nBlocks)) + fRelativeGate;
+    int nFirstBin = (fGate > fAbsoluteGate) ? getBin(fGate) : 0;
+
+    nBlocks = 0;
+    dEnergy = 0.0;
+
+    for (int nBin = nFirstBin; nBin < KMETER_LOUDNESS_HISTOGRAM_BINS; nBin++)
+    {
+        nBlocks += nBlockCounts[nBin];
+        dEnergy += dBlockEnergies[nBin];
+    }
+
+    // the bin of the relative gate holds at least the loudest block
+    jassert(nBlocks > 0);
+
+    return energy2loudness(dEnergy / double(nBlocks));
+}
+
+
+float LoudnessHistogram::getAbsoluteGate()
+{
+    return fAbsoluteGate;
+}
+
+
+float LoudnessHistogram::getRelativeGate()
+{
+    return fRelativeGate;
+}
+
+
+int LoudnessHistogram::getBin(const float fLoudness)
+{
+    int nBin = int((fLoudness - fAbsoluteGate) / fBinWidth);
+
+    // blocks louder than +10 LUFS are collected in the last bin
+    if (nBin >= KMETER_LOUDNESS_HISTOGRAM_BINS)
+    {
+        nBin = KMETER_LOUDNESS_HISTOGRAM_BINS - 1;
+    }
+    else if (nBin < 0)
+    {
+        nBin = 0;
+    }
+
+    return nBin;
+}
+
+
+float LoudnessHistogram::energy2loudness(const double dMeanSquare)
+{
+    // prevent taking the logarithm of zero
+    if (dMeanSquare <= 0.0)
+    {
+        return fAbsoluteGate - 1.0f;
+    }
+
+    return -0.691f + 10.0f * float(log10(dMeanSquare));
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
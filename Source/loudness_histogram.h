@@ -0,0 +1,76 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __LOUDNESS_HISTOGRAM_H__
+#define __LOUDNESS_HISTOGRAM_H__
+
+class LoudnessHistogram;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+
+//==============================================================================
+/**
+*/
+class LoudnessHistogram
+{
+public:
+    // gating blocks between -70 LUFS and +10 LUFS in steps of 0.1 LU
+    static const int KMETER_LOUDNESS_HISTOGRAM_BINS = 800;
+
+    LoudnessHistogram();
+    ~LoudnessHistogram();
+
+    void reset();
+    void addBlock(const double mean_square);
+    void merge(const LoudnessHistogram& other);
+
+    int64 getNumberOfBlocks() const;
+    float getIntegratedLoudness() const;
+
+    static float getAbsoluteGate();
+    static float getRelativeGate();
+
+private:
+    JUCE_LEAK_DETECTOR(LoudnessHistogram);
+
+    static float fAbsoluteGate;
+    static float fRelativeGate;
+    static float fBinWidth;
+
+    int64 nBlockCounts[KMETER_LOUDNESS_HISTOGRAM_BINS];
+    double dBlockEnergies[KMETER_LOUDNESS_HISTOGRAM_BINS];
+
+    static int getBin(const float fLoudness);
+    static float energy2loudness(const double dMeanSquare);
+};
+
+
+#endif  // __LOUDNESS_HISTOGRAM_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
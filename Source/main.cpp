@@ -32,6 +32,72 @@ START_JUCE_APPLICATION(StandaloneApplication)
 #endif
 
 
+// build command-line analyser
+#ifdef KMETER_ANALYSER
+
+#include "analyser_application.h"
+
+int main(int argc, char* argv[])
+{
+    StringArray arguments;
+
+    for (int nArgument = 1; nArgument < argc; nArgument++)
+    {
+        arguments.add(CharPointer_UTF8(argv[nArgument]));
+    }
+
+    AnalyserApplication application;
+    return application.run(arguments);
+}
+
+#endif
+
+
+// build test for merging statistics of segmented analysis
+#ifdef KMETER_STATISTICS_TEST
+
+#include "statistics_test_application.h"
+
+int main(int argc, char* argv[])
+{
+    StringArray arguments;
+
+    for (int nArgument = 1; nArgument < argc; nArgument++)
+    {
+        arguments.add(CharPointer_UTF8(argv[nArgument]));
+    }
+
+    StatisticsTestApplication application;
+    return application.run(arguments);
+}
+
+#endif
+
+
+// build headless stress test for plug-in instances
+#ifdef KMETER_STRESS_TEST
+
+#include "stress_test_application.h"
+
+int main(int argc, char* argv[])
+{
+    // the plug-in needs a message manager, but no window
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    StringArray arguments;
+
+    for (int nArgument = 1; nArgument < argc; nArgument++)
+    {
+        arguments.add(CharPointer_UTF8(argv[nArgument]));
+    }
+
+    StressTestApplication application;
+    return application.run(arguments);
+}
+
+#endif
+
+
 // build VST plugin
 #if defined (KMETER_VST_PLUGIN) || defined (KMETER_LV2_PLUGIN)
 
@@ -0,0 +1,444 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "mapped_wav_reader.h"
+
+#if JUCE_LINUX || JUCE_MAC
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+
+// destination of all sample conversions: planar 32-bit floats
+typedef AudioData::Pointer<AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::NonConst> MappedWavReaderDestination;
+
+
+static int chunkName(const char* name)
+{
+    return (int) ByteOrder::littleEndianInt(name);
+}
+
+
+MappedWavReader::MappedWavReader(const File audioFile)
+/*  Constructor.  Maps a WAV file (also BWF and RF64) into memory, so
+    that samples can be converted from the file's interleaved PCM data
+    straight into planar floats without intermediate buffers.  The
+    operating system is told that the file will be read sequentially
+    and pages are requested ahead of the read position, so that
+    analysis does not have to wait for the disk.
+
+    Use isValid() to check whether the file could be mapped; other
+    audio formats (and WAV files with unsupported sample formats) are
+    left to AudioFormatManager.
+
+    audioFile (File): audio file to be read
+
+    return value: none
+*/
+{
+    pMappedFile = NULL;
+    pConverter = NULL;
+
+    nNumberOfChannels = 0;
+    nSampleRate = 0;
+    nBitsPerSample = 0;
+    uChannelMask = 0;
+    bFloatingPoint = false;
+    nBytesPerFrame = 0;
+
+    nDataOffset = 0;
+    nLengthInSamples = 0;
+
+    nPrefetchWindow = 0;
+    nPrefetchedUntil = 0;
+
+    {
+        FileInputStream input(audioFile);
+
+        if (input.failedToOpen() || !parseHeader(input))
+        {
+            return;
+        }
+    }
+
+    pMappedFile = new MemoryMappedFile(audioFile, MemoryMappedFile::readOnly);
+
+    if (pMappedFile->getData() == NULL)
+    {
+        delete pMappedFile;
+        pMappedFile = NULL;
+
+        return;
+    }
+
+    // files may have been truncated
+    int64 nFramesInFile = ((int64) pMappedFile->getSize() - nDataOffset) / nBytesPerFrame;
+
+    if (nFramesInFile < nLengthInSamples)
+    {
+        nLengthInSamples = jmax((int64) 0, nFramesInFile);
+    }
+
+    if (bFloatingPoint)
+    {
+        pConverter = new AudioData::ConverterInstance<AudioData::Pointer<AudioData::Float32, AudioData::LittleEndian, AudioData::Interleaved, AudioData::Const>, MappedWavReaderDestination>(nNumberOfChannels, 1);
+    }
+    else if (nBitsPerSample == 16)
+    {
+        pConverter = new AudioData::ConverterInstance<AudioData::Pointer<AudioData::Int16, AudioData::LittleEndian, AudioData::Interleaved, AudioData::Const>, MappedWavReaderDestination>(nNumberOfChannels, 1);
+    }
+    else if (nBitsPerSample == 24)
+    {
+        pConverter = new AudioData::ConverterInstance<AudioData::Pointer<AudioData::Int24, AudioData::LittleEndian, AudioData::Interleaved, AudioData::Const>, MappedWavReaderDestination>(nNumberOfChannels, 1);
+    }
+    else
+    {
+        pConverter = new AudioData::ConverterInstance<AudioData::Pointer<AudioData::Int32, AudioData::LittleEndian, AudioData::Interleaved, AudioData::Const>, MappedWavReaderDestination>(nNumberOfChannels, 1);
+    }
+
+    // request 8 MB ahead of the read position
+    nPrefetchWindow = (8 * 1024 * 1024) / nBytesPerFrame;
+
+#if JUCE_LINUX || JUCE_MAC
+    madvise(pMappedFile->getData(), pMappedFile->getSize(), MADV_SEQUENTIAL);
+#endif
+}
+
+
+MappedWavReader::~MappedWavReader()
+{
+    delete pConverter;
+    pConverter = NULL;
+
+    delete pMappedFile;
+    pMappedFile = NULL;
+}
+
+
+bool MappedWavReader::parseHeader(InputStream& input)
+/*  Read format and position of audio data from WAV header.
+
+    input (InputStream&): stream positioned at the start of the file
+
+    return value (Boolean): true if the file contains PCM data in a
+    supported format
+*/
+{
+    int nRiffType = input.readInt();
+
+    if ((nRiffType != chunkName("RIFF")) && (nRiffType != chunkName("RF64")))
+    {
+        return false;
+    }
+
+    // RIFF size (RF64 stores 64-bit sizes in the "ds64" chunk)
+    input.readInt();
+
+    if (input.readInt() != chunkName("WAVE"))
+    {
+        return false;
+    }
+
+    int64 nDataSize64 = -1;
+    bool bFormatFound = false;
+
+    while (!input.isExhausted())
+    {
+        int nChunkType = input.readInt();
+        int64 nChunkSize = (uint32) input.readInt();
+        int64 nChunkEnd = input.getPosition() + nChunkSize + (nChunkSize & 1);
+
+        if (nChunkType == chunkName("ds64"))
+        {
+            // RIFF size, followed by data size
+            input.readInt64();
+            nDataSize64 = input.readInt64();
+        }
+        else if (nChunkType == chunkName("fmt "))
+        {
+            int nFormatTag = (unsigned short) input.readShort();
+            nNumberOfChannels = (unsigned short) input.readShort();
+            nSampleRate = input.readInt();
+
+            // average bytes per second
+            input.readInt();
+
+            nBytesPerFrame = (unsigned short) input.readShort();
+            nBitsPerSample = (unsigned short) input.readShort();
+
+            // WAVE_FORMAT_EXTENSIBLE: the sub-format GUID starts with
+            // the actual format tag
+            if ((nFormatTag == 0xFFFE) && (nChunkSize >= 40))
+            {
+                // size of extension and valid bits
+                input.readShort();
+                input.readShort();
+
+                // speaker positions of the channels
+                uChannelMask = (uint32) input.readInt();
+
+                nFormatTag = (unsigned short) input.readShort();
+            }
+
+            // 1 --> integer PCM, 3 --> IEEE float
+            if (nFormatTag == 1)
+            {
+                bFloatingPoint = false;
+                bFormatFound = (nBitsPerSample == 16) || (nBitsPerSample == 24) || (nBitsPerSample == 32);
+            }
+            else if (nFormatTag == 3)
+            {
+                bFloatingPoint = true;
+                bFormatFound = (nBitsPerSample == 32);
+            }
+
+            bFormatFound = bFormatFound && (nNumberOfChannels > 0) && (nSampleRate > 0) && (nBytesPerFrame == nNumberOfChannels * nBitsPerSample / 8);
+        }
+        else if (nChunkType == chunkName("data"))
+        {
+            if (!bFormatFound)
+            {
+                return false;
+            }
+
+            if ((nChunkSize == 0xFFFFFFFF) && (nDataSize64 >= 0))
+            {
+                nChunkSize = nDataSize64;
+            }
+
+            nDataOffset = input.getPosition();
+            nLengthInSamples = nChunkSize / nBytesPerFrame;
+
+            return true;
+        }
+
+        if (!input.setPosition(nChunkEnd))
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+
+bool MappedWavReader::isValid()
+{
+    return (pConverter != NULL);
+}
+
+
+int MappedWavReader::getNumberOfChannels()
+{
+    return nNumberOfChannels;
+}
+
+
+int MappedWavReader::getSampleRate()
+{
+    return nSampleRate;
+}
+
+
+int MappedWavReader::getBitsPerSample()
+{
+    return nBitsPerSample;
+}
+
+
+uint32 MappedWavReader::getChannelMask()
+/*  Get speaker positions of the channels.
+
+    return value (unsigned 32-bit integer): channel mask of
+    WAVE_FORMAT_EXTENSIBLE files; 0 if the file does not specify one
+*/
+{
+    return uChannelMask;
+}
+
+
+int64 MappedWavReader::getLengthInSamples()
+{
+    return nLengthInSamples;
+}
+
+
+void MappedWavReader::readChannel(const int channel, float* destination, const int64 start_sample, const int num_samples)
+/*  Convert samples of a single channel to floats.  Samples after the
+    end of the file read as silence.
+
+    channel (integer): selected audio channel
+
+    destination (float*): buffer receiving the samples
+
+    start_sample (64-bit integer): first sample to read
+
+    num_samples (integer): number of samples to read
+
+    return value: none
+*/
+{
+    jassert(isValid());
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+    jassert(start_sample >= 0);
+
+    int nSamplesRead = 0;
+
+    if (start_sample < nLengthInSamples)
+    {
+        nSamplesRead = (int) jmin((int64) num_samples, nLengthInSamples - start_sample);
+
+        const char* pSource = static_cast<const char*>(pMappedFile->getData()) + nDataOffset + start_sample * nBytesPerFrame;
+        pConverter->convertSamples(destination, 0, pSource, channel, nSamplesRead);
+    }
+
+    if (nSamplesRead < num_samples)
+    {
+        zeromem(destination + nSamplesRead, (num_samples - nSamplesRead) * sizeof(float));
+    }
+}
+
+
+void MappedWavReader::readToBuffer(AudioSampleBuffer& destination, const int destStartSample, const int64 start_sample, const int num_samples)
+/*  Convert samples of all channels to floats.  Like JUCE's audio
+    readers, surplus channels of the destination buffer are filled
+    with copies of the file's last channel.
+
+    destination (AudioSampleBuffer&): buffer receiving the samples
+
+    destStartSample (integer): first sample in destination buffer
+
+    start_sample (64-bit integer): first sample to read
+
+    num_samples (integer): number of samples to read
+
+    return value: none
+*/
+{
+    jassert((destStartSample + num_samples) <= destination.getNumSamples());
+
+    prefetchAhead(start_sample, num_samples);
+
+    for (int nChannel = 0; nChannel < destination.getNumChannels(); nChannel++)
+    {
+        int nSourceChannel = jmin(nChannel, nNumberOfChannels - 1);
+        readChannel(nSourceChannel, destination.getSampleData(nChannel, destStartSample), start_sample, num_samples);
+    }
+}
+
+
+void MappedWavReader::readToRingBuffer(AudioRingBuffer& ring_buffer, const int64 start_sample, const unsigned int num_samples)
+/*  Convert samples of all channels straight into a ring buffer.
+    Chunks are processed by the ring buffer as soon as they are
+    complete.
+
+    ring_buffer (AudioRingBuffer&): ring buffer receiving the samples
+
+    start_sample (64-bit integer): first sample to read
+
+    num_samples (unsigned integer): number of samples to read
+
+    return value: none
+*/
+{
+    prefetchAhead(start_sample, (int) num_samples);
+
+    unsigned int uChannels = ring_buffer.getNumberOfChannels();
+    unsigned int uSamplesLeft = num_samples;
+    int64 nPosition = start_sample;
+
+    while (uSamplesLeft > 0)
+    {
+        unsigned int uSamplesToRead = jmin(uSamplesLeft, ring_buffer.getWritableSamples());
+
+        for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
+        {
+            int nSourceChannel = jmin((int) uChannel, nNumberOfChannels - 1);
+            readChannel(nSourceChannel, ring_buffer.getWritePointer(uChannel), nPosition, (int) uSamplesToRead);
+        }
+
+        ring_buffer.advanceWritePosition(uSamplesToRead);
+
+        nPosition += uSamplesToRead;
+        uSamplesLeft -= uSamplesToRead;
+    }
+}
+
+
+void MappedWavReader::prefetch(const int64 start_sample, const int64 num_samples)
+/*  Ask the operating system to load a part of the file into memory
+    in the background (currently a no-op on Windows).
+
+    start_sample (64-bit integer): first sample to load
+
+    num_samples (64-bit integer): number of samples to load
+
+    return value: none
+*/
+{
+    if (!isValid() || (num_samples <= 0) || (start_sample >= nLengthInSamples))
+    {
+        return;
+    }
+
+#if JUCE_LINUX || JUCE_MAC
+    int64 nPageSize = (int64) getpagesize();
+
+    int64 nStart = nDataOffset + start_sample * nBytesPerFrame;
+    int64 nEnd = nDataOffset + jmin(start_sample + num_samples, nLengthInSamples) * nBytesPerFrame;
+
+    // madvise() expects page-aligned addresses
+    nStart -= nStart % nPageSize;
+
+    char* pStart = static_cast<char*>(pMappedFile->getData()) + nStart;
+    madvise(pStart, (size_t)(nEnd - nStart), MADV_WILLNEED);
+#endif
+}
+
+
+void MappedWavReader::prefetchAhead(const int64 start_sample, const int num_samples)
+{
+    // reader has jumped backwards
+    if (start_sample < (nPrefetchedUntil - nPrefetchWindow))
+    {
+        nPrefetchedUntil = start_sample;
+    }
+
+    // refill window when half of it has been read
+    if ((start_sample + num_samples + nPrefetchWindow / 2) > nPrefetchedUntil)
+    {
+        int64 nPrefetchFrom = jmax(start_sample, nPrefetchedUntil);
+        int64 nPrefetchTo = start_sample + num_samples + nPrefetchWindow;
+
+        prefetch(nPrefetchFrom, nPrefetchTo - nPrefetchFrom);
+        nPrefetchedUntil = nPrefetchTo;
+    }
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,87 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __MAPPED_WAV_READER_H__
+#define __MAPPED_WAV_READER_H__
+
+class MappedWavReader;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "audio_ring_buffer.h"
+
+
+//==============================================================================
+/**
+*/
+class MappedWavReader
+{
+public:
+    MappedWavReader(const File audioFile);
+    ~MappedWavReader();
+
+    bool isValid();
+
+    int getNumberOfChannels();
+    int getSampleRate();
+    int getBitsPerSample();
+    uint32 getChannelMask();
+    int64 getLengthInSamples();
+
+    void readChannel(const int channel, float* destination, const int64 start_sample, const int num_samples);
+    void readToBuffer(AudioSampleBuffer& destination, const int destStartSample, const int64 start_sample, const int num_samples);
+    void readToRingBuffer(AudioRingBuffer& ring_buffer, const int64 start_sample, const unsigned int num_samples);
+
+    void prefetch(const int64 start_sample, const int64 num_samples);
+
+private:
+    JUCE_LEAK_DETECTOR(MappedWavReader);
+
+    bool parseHeader(InputStream& input);
+    void prefetchAhead(const int64 start_sample, const int num_samples);
+
+    MemoryMappedFile* pMappedFile;
+    AudioData::Converter* pConverter;
+
+    int nNumberOfChannels;
+    int nSampleRate;
+    int nBitsPerSample;
+    uint32 uChannelMask;
+    bool bFloatingPoint;
+    int nBytesPerFrame;
+
+    int64 nDataOffset;
+    int64 nLengthInSamples;
+
+    int64 nPrefetchWindow;
+    int64 nPrefetchedUntil;
+};
+
+
+#endif  // __MAPPED_WAV_READER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
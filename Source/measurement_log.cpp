@@ -0,0 +1,569 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "measurement_log.h"
+
+#include <cfloat>
+
+
+MeasurementLog::MeasurementLog(const File& logFile, const StringArray& columns, const int sample_rate, const int queue_length, const bool realtime)
+/*  Constructor.  Writes meter readings to a compact binary file.
+    In real-time mode, rows are queued without locking or allocating
+    memory, so they may be added from the audio thread; a background
+    thread writes them to disk.  Otherwise, rows are written by the
+    calling thread and never dropped.
+
+    File format (all numbers little-endian):
+
+    - "KMLG", version (int32), sample rate (int32), number of columns
+      (int32), wall-clock time of timecode zero (int64, milliseconds
+      since 1970-01-01 UTC)
+
+    - column names (null-terminated UTF-8 strings)
+
+    - blocks of rows, stored column by column: number of rows (int32),
+      wall-clock time of the block's first row (int64, milliseconds
+      since 1970-01-01 UTC), timecodes in samples (one int64 per row),
+      followed by the values of every column (one float32 per row)
+
+    Rows of a block are spaced by their timecodes; a new block starts
+    a new time base, so logs may be rebased when the sample clock has
+    drifted from the wall clock.
+
+    logFile (const File&): log file; existing files are overwritten
+
+    columns (const StringArray&): names of the columns (without
+    timecode)
+
+    sample_rate (integer): sample rate of the timecodes
+
+    queue_length (integer): number of rows that may be queued before
+    rows are dropped (real-time mode) or number of rows per block
+
+    realtime (Boolean): queue rows for a background thread; set this
+    when addRow() is called from the audio thread
+
+    return value: none
+*/
+{
+    jassert(columns.size() > 0);
+    jassert(queue_length > 1);
+
+    nNumberOfColumns = columns.size();
+    nDroppedRows = 0;
+
+    // timecodes of validation logs start with the log
+    nSampleRate = sample_rate;
+    nStartTime = Time::currentTimeMillis();
+
+    bRealtime = realtime;
+    nQueueLength = queue_length;
+    nRowsInBlock = 0;
+
+    pWriterThread = NULL;
+
+    pFifo = new AbstractFifo(queue_length);
+    pTimecodes = new int64[queue_length];
+    pValues = new float[queue_length * nNumberOfColumns];
+
+    // "FileOutputStream" appends to existing files, so remove old
+    // logs first
+    logFile.deleteFile();
+    pLogStream = new FileOutputStream(logFile, 65536);
+
+    if (pLogStream->failedToOpen())
+    {
+        delete pLogStream;
+        pLogStream = NULL;
+
+        return;
+    }
+
+    writeHeader(*pLogStream, columns, nSampleRate, nStartTime);
+
+    if (!bRealtime)
+    {
+        return;
+    }
+
+    pWriterThread = new TimeSliceThread("K-Meter measurement log");
+    pWriterThread->addTimeSliceClient(this);
+    pWriterThread->startThread(3);
+}
+
+
+MeasurementLog::~MeasurementLog()
+{
+    if (pWriterThread)
+    {
+        pWriterThread->removeTimeSliceClient(this);
+        pWriterThread->stopThread(5000);
+
+        delete pWriterThread;
+        pWriterThread = NULL;
+    }
+
+    // write remaining rows; deleting the stream flushes and closes the
+    // log file
+    if (pLogStream)
+    {
+        if (bRealtime)
+        {
+            writeRows();
+        }
+        else if (nRowsInBlock > 0)
+        {
+            writeBlock(*pLogStream, getBlockTime(pTimecodes[0]), pTimecodes, pValues, nRowsInBlock, nNumberOfColumns);
+        }
+
+        delete pLogStream;
+        pLogStream = NULL;
+    }
+
+    delete pFifo;
+    pFifo = NULL;
+
+    delete [] pTimecodes;
+    pTimecodes = NULL;
+
+    delete [] pValues;
+    pValues = NULL;
+}
+
+
+bool MeasurementLog::isOpen()
+{
+    return (pLogStream != NULL);
+}
+
+
+int MeasurementLog::getNumberOfColumns()
+{
+    return nNumberOfColumns;
+}
+
+
+int64 MeasurementLog::getNumberOfDroppedRows()
+/*  Get number of rows that were dropped because the writer thread
+    had fallen behind (real-time mode only).
+
+    return value (64-bit integer): number of dropped rows
+*/
+{
+    return nDroppedRows;
+}
+
+
+bool MeasurementLog::addRow(const int64 timecode, const float* values)
+/*  Add a row of meter readings.  In real-time mode, rows are queued
+    without locking or allocating memory; otherwise, complete blocks
+    are written right away.
+
+    timecode (64-bit integer): position of the readings in samples
+
+    values (const float*): one value per column
+
+    return value (Boolean): false if the queue was full and the row
+    has been dropped
+*/
+{
+    if (pLogStream == NULL)
+    {
+        return false;
+    }
+
+    if (!bRealtime)
+    {
+        pTimecodes[nRowsInBlock] = timecode;
+        memcpy(pValues + nRowsInBlock * nNumberOfColumns, values, nNumberOfColumns * sizeof(float));
+
+        nRowsInBlock++;
+
+        if (nRowsInBlock == nQueueLength)
+        {
+            writeBlock(*pLogStream, getBlockTime(pTimecodes[0]), pTimecodes, pValues, nRowsInBlock, nNumberOfColumns);
+            nRowsInBlock = 0;
+        }
+
+        return true;
+    }
+
+    int nStart1, nSize1, nStart2, nSize2;
+    pFifo->prepareToWrite(1, nStart1, nSize1, nStart2, nSize2);
+
+    if (nSize1 < 1)
+    {
+        nDroppedRows++;
+        return false;
+    }
+
+    pTimecodes[nStart1] = timecode;
+    memcpy(pValues + nStart1 * nNumberOfColumns, values, nNumberOfColumns * sizeof(float));
+
+    pFifo->finishedWrite(1);
+    return true;
+}
+
+
+int MeasurementLog::useTimeSlice()
+/*  Called by the writer thread.
+
+    return value (integer): milliseconds until the next call
+*/
+{
+    writeRows();
+
+    // the queue holds several seconds of meter readings, so there is
+    // no need to hurry
+    return 100;
+}
+
+
+void MeasurementLog::writeRows()
+{
+    int nStart1, nSize1, nStart2, nSize2;
+    pFifo->prepareToRead(pFifo->getNumReady(), nStart1, nSize1, nStart2, nSize2);
+
+    // the queue may wrap around, so write up to two blocks
+    if (nSize1 > 0)
+    {
+        writeBlock(*pLogStream, getBlockTime(pTimecodes[nStart1]), pTimecodes + nStart1, pValues + nStart1 * nNumberOfColumns, nSize1, nNumberOfColumns);
+    }
+
+    if (nSize2 > 0)
+    {
+        writeBlock(*pLogStream, getBlockTime(pTimecodes[nStart2]), pTimecodes + nStart2, pValues + nStart2 * nNumberOfColumns, nSize2, nNumberOfColumns);
+    }
+
+    pFifo->finishedRead(nSize1 + nSize2);
+}
+
+
+int64 MeasurementLog::getBlockTime(const int64 timecode)
+/*  Get wall-clock time of a block.  Validation logs run on the
+    timecodes of their audio file, so the time is derived from the
+    start of the log.
+
+    timecode (64-bit integer): timecode of the block's first row
+
+    return value (64-bit integer): milliseconds since 1970-01-01 UTC
+*/
+{
+    return nStartTime + (timecode * 1000) / nSampleRate;
+}
+
+
+void MeasurementLog::writeHeader(OutputStream& stream, const StringArray& columns, const int sample_rate, const int64 start_time)
+/*  Write header of a binary log file.
+
+    stream (OutputStream&): stream positioned at the start of the
+    log file
+
+    columns (const StringArray&): names of the columns (without
+    timecode)
+
+    sample_rate (integer): sample rate of the timecodes
+
+    start_time (64-bit integer): wall-clock time of timecode zero in
+    milliseconds since 1970-01-01 UTC
+
+    return value: none
+*/
+{
+    stream.writeInt(ByteOrder::littleEndianInt("KMLG"));
+    stream.writeInt(nVersion);
+    stream.writeInt(sample_rate);
+    stream.writeInt(columns.size());
+    stream.writeInt64(start_time);
+
+    for (int nColumn = 0; nColumn < columns.size(); nColumn++)
+    {
+        stream.writeString(columns[nColumn]);
+    }
+}
+
+
+void MeasurementLog::writeBlock(OutputStream& stream, const int64 block_time, const int64* timecodes, const float* values, const int number_of_rows, const int number_of_columns)
+/*  Write a block of rows to a binary log file.  The rows are passed
+    one after another and written column by column.
+
+    stream (OutputStream&): stream positioned after the header or
+    the previous block
+
+    block_time (64-bit integer): wall-clock time of the first row in
+    milliseconds since 1970-01-01 UTC
+
+    timecodes (const int64*): positions of the readings in samples
+    (one per row)
+
+    values (const float*): values of all rows; every row holds one
+    value per column
+
+    number_of_rows (integer): number of rows in block
+
+    number_of_columns (integer): number of columns (as written to the
+    header)
+
+    return value: none
+*/
+{
+    jassert(number_of_rows > 0);
+
+    stream.writeInt(number_of_rows);
+    stream.writeInt64(block_time);
+
+    for (int nRow = 0; nRow < number_of_rows; nRow++)
+    {
+        stream.writeInt64(timecodes[nRow]);
+    }
+
+    for (int nColumn = 0; nColumn < number_of_columns; nColumn++)
+    {
+        for (int nRow = 0; nRow < number_of_rows; nRow++)
+        {
+            stream.writeFloat(values[nRow * number_of_columns + nColumn]);
+        }
+    }
+}
+
+
+bool MeasurementLog::convertToText(const File& logFile, const File& textFile, const bool json)
+/*  Convert a binary log file to text.  CSV files use the same layout
+    as the plug-in's CSV reports (tab-separated, timecodes as
+    "mm:ss.mmm"), followed by the wall-clock time of every row (local
+    time); JSON files hold the column names and an array of rows with
+    timecodes in seconds and wall-clock times in milliseconds since
+    1970-01-01 UTC.
+
+    logFile (const File&): binary log file
+
+    textFile (const File&): text file; existing files are overwritten
+
+    json (Boolean): write JSON instead of CSV
+
+    return value (Boolean): false if the log file could not be read
+    or the text file could not be written
+*/
+{
+    FileInputStream inputStream(logFile);
+
+    if (inputStream.failedToOpen())
+    {
+        return false;
+    }
+
+    if (inputStream.readInt() != ByteOrder::littleEndianInt("KMLG"))
+    {
+        return false;
+    }
+
+    if (inputStream.readInt() != nVersion)
+    {
+        return false;
+    }
+
+    int nSampleRate = inputStream.readInt();
+    int nColumns = inputStream.readInt();
+    int64 nStartTime = inputStream.readInt64();
+
+    if ((nSampleRate <= 0) || (nColumns <= 0))
+    {
+        return false;
+    }
+
+    StringArray arrColumns;
+
+    for (int nColumn = 0; nColumn < nColumns; nColumn++)
+    {
+        arrColumns.add(inputStream.readString());
+    }
+
+    textFile.deleteFile();
+    FileOutputStream outputStream(textFile);
+
+    if (outputStream.failedToOpen())
+    {
+        return false;
+    }
+
+    int nRowSize = sizeof(int64) + nColumns * sizeof(float);
+    bool bFirstRow = true;
+
+    // grows to the size of the largest block
+    HeapBlock<int64> arrTimecodes;
+    HeapBlock<float> arrValues;
+    int nAllocatedRows = 0;
+
+    if (json)
+    {
+        outputStream << "{\n  \"sample_rate\": " << nSampleRate << ",\n  \"start_time\": " << String(nStartTime) << ",\n  \"columns\": [\"timecode\", \"time\"";
+
+        for (int nColumn = 0; nColumn < nColumns; nColumn++)
+        {
+            outputStream << ", " << arrColumns[nColumn].quoted();
+        }
+
+        outputStream << "],\n  \"rows\": [";
+    }
+    else
+    {
+        outputStream << "\"timecode\"\t\"time\"\t";
+
+        for (int nColumn = 0; nColumn < nColumns; nColumn++)
+        {
+            outputStream << arrColumns[nColumn].quoted() << "\t";
+        }
+
+        outputStream << "\n";
+    }
+
+    // ignore an incomplete block at the end of the file (the plug-in
+    // may have crashed)
+    while ((inputStream.getTotalLength() - inputStream.getPosition()) >= (int64) sizeof(int))
+    {
+        int nRows = inputStream.readInt();
+
+        if ((nRows <= 0) || ((inputStream.getTotalLength() - inputStream.getPosition()) < (int64) sizeof(int64) + (int64) nRows * nRowSize))
+        {
+            break;
+        }
+
+        int64 nBlockTime = inputStream.readInt64();
+
+        if (nRows > nAllocatedRows)
+        {
+            arrTimecodes.malloc(nRows);
+            arrValues.malloc(nRows * nColumns);
+            nAllocatedRows = nRows;
+        }
+
+        for (int nRow = 0; nRow < nRows; nRow++)
+        {
+            arrTimecodes[nRow] = inputStream.readInt64();
+        }
+
+        for (int nValue = 0; nValue < (nRows * nColumns); nValue++)
+        {
+            arrValues[nValue] = inputStream.readFloat();
+        }
+
+        for (int nRow = 0; nRow < nRows; nRow++)
+        {
+            // rows are spaced by their timecodes
+            int64 nTime = nBlockTime + ((arrTimecodes[nRow] - arrTimecodes[0]) * 1000) / nSampleRate;
+
+            if (json)
+            {
+                outputStream << (bFirstRow ? "\n    [" : ",\n    [") << String(double(arrTimecodes[nRow]) / nSampleRate, 6) << ", " << String(nTime);
+
+                for (int nColumn = 0; nColumn < nColumns; nColumn++)
+                {
+                    outputStream << ", " << formatValueJson(arrValues[nColumn * nRows + nRow]);
+                }
+
+                outputStream << "]";
+            }
+            else
+            {
+                outputStream << "\"" << formatTime(arrTimecodes[nRow], nSampleRate) << "\"\t";
+                outputStream << "\"" << formatDateTime(nTime) << "\"\t";
+
+                for (int nColumn = 0; nColumn < nColumns; nColumn++)
+                {
+                    outputStream << formatValue(arrValues[nColumn * nRows + nRow]);
+                }
+
+                outputStream << "\n";
+            }
+
+            bFirstRow = false;
+        }
+    }
+
+    if (json)
+    {
+        outputStream << "\n  ]\n}\n";
+    }
+
+    return true;
+}
+
+
+String MeasurementLog::formatTime(const int64 timecode, const int sample_rate)
+{
+    int64 nMilliSecondsTotal = (timecode * 1000 + sample_rate / 2) / sample_rate;
+
+    int nTime = int(nMilliSecondsTotal / 1000);
+    int nMilliSeconds = int(nMilliSecondsTotal % 1000);
+
+    String strMinutes = String(nTime / 60).paddedLeft('0', 2);
+    String strSeconds = String(nTime % 60).paddedLeft('0', 2);
+    String strMilliSeconds = String(nMilliSeconds).paddedLeft('0', 3);
+
+    return strMinutes + ":" + strSeconds + "." + strMilliSeconds;
+}
+
+
+String MeasurementLog::formatDateTime(const int64 milliseconds)
+{
+    Time time(milliseconds);
+    String strMilliSeconds = String(time.getMilliseconds()).paddedLeft('0', 3);
+
+    return time.formatted("%Y-%m-%d %H:%M:%S") + "." + strMilliSeconds;
+}
+
+
+String MeasurementLog::formatValue(const float fValue)
+{
+    String strValue;
+
+    if (fValue < 0.0f)
+    {
+        strValue = String(fValue, 2);
+    }
+    else
+    {
+        strValue = "+" + String(fValue, 2);
+    }
+
+    return (strValue + "\t");
+}
+
+
+String MeasurementLog::formatValueJson(const float fValue)
+{
+    // JSON has no representation for infinity or NaN
+    if ((fValue != fValue) || (fValue > FLT_MAX) || (fValue < -FLT_MAX))
+    {
+        return "null";
+    }
+
+    return String(fValue, 2);
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
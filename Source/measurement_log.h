@@ -0,0 +1,94 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __MEASUREMENT_LOG_H__
+#define __MEASUREMENT_LOG_H__
+
+class MeasurementLog;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+
+//==============================================================================
+/**
+*/
+class MeasurementLog : public TimeSliceClient
+{
+public:
+    MeasurementLog(const File& logFile, const StringArray& columns, const int sample_rate, const int queue_length, const bool realtime);
+    ~MeasurementLog();
+
+    bool isOpen();
+    int getNumberOfColumns();
+    int64 getNumberOfDroppedRows();
+
+    bool addRow(const int64 timecode, const float* values);
+    int useTimeSlice();
+
+    static void writeHeader(OutputStream& stream, const StringArray& columns, const int sample_rate, const int64 start_time);
+    static void writeBlock(OutputStream& stream, const int64 block_time, const int64* timecodes, const float* values, const int number_of_rows, const int number_of_columns);
+    static bool convertToText(const File& logFile, const File& textFile, const bool json);
+
+private:
+    JUCE_LEAK_DETECTOR(MeasurementLog);
+
+    static const int nVersion = 3;
+
+    void writeRows();
+    int64 getBlockTime(const int64 timecode);
+
+    static String formatTime(const int64 timecode, const int sample_rate);
+    static String formatDateTime(const int64 milliseconds);
+    static String formatValue(const float fValue);
+    static String formatValueJson(const float fValue);
+
+    TimeSliceThread* pWriterThread;
+    FileOutputStream* pLogStream;
+    AbstractFifo* pFifo;
+
+    // offline: rows are collected in the queue's memory and written
+    // as soon as a block is complete
+    bool bRealtime;
+    int nQueueLength;
+    int nRowsInBlock;
+
+    // wall-clock time of timecode zero (milliseconds since 1970)
+    int nSampleRate;
+    int64 nStartTime;
+
+    int nNumberOfColumns;
+    int64* pTimecodes;
+    float* pValues;
+
+    int64 nDroppedRows;
+};
+
+
+#endif  // __MEASUREMENT_LOG_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,764 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "meter_analyser.h"
+
+
+MeterAnalyser::MeterAnalyser(const int channels, const int buffer_size, const int sample_rate, const int average_algorithm)
+/*  Constructor.
+
+    channels (integer): number of audio input channels
+
+    buffer_size (integer): size of the audio chunks passed to
+    processBufferChunk()
+
+    sample_rate (integer): sample rate of the audio input
+
+    average_algorithm (integer): algorithm for calculating average
+    meter levels; must be one of the "selAlgorithm..."  values defined
+    in "plugin_parameters.h"
+
+    return value: none
+*/
+{
+    jassert(channels > 0);
+
+    nNumberOfChannels = channels;
+    nSampleRate = sample_rate;
+    bIsStereo = (nNumberOfChannels == 2);
+
+    fPeakLevels = new float[nNumberOfChannels];
+    fRmsLevels = new float[nNumberOfChannels];
+    fAverageLevelsFiltered = new float[nNumberOfChannels];
+    nOverflows = new int[nNumberOfChannels];
+
+    bIncremental = false;
+    uChunkSize = (unsigned int) buffer_size;
+
+    fPeakLevelsIncremental = new float[nNumberOfChannels];
+    dSumsOfSquaresIncremental = new double[nNumberOfChannels];
+    nOverflowsIncremental = new int[nNumberOfChannels];
+
+    pAverageLevelFiltered = new AverageLevelFiltered(nNumberOfChannels, buffer_size, nSampleRate, average_algorithm);
+    pSpectrum = NULL;
+
+    // only the command-line analyser needs statistics (the loudness
+    // histogram alone takes about 13 kB)
+    pStatistics = NULL;
+
+    // the filter may have corrected the averaging algorithm, so make
+    // sure that the meter ballistics use the final one
+    pMeterBallistics = new MeterBallistics(nNumberOfChannels, pAverageLevelFiltered->getAlgorithm(), false, false);
+
+    reset();
+}
+
+
+MeterAnalyser::~MeterAnalyser()
+{
+    delete pAverageLevelFiltered;
+    pAverageLevelFiltered = NULL;
+
+    delete pMeterBallistics;
+    pMeterBallistics = NULL;
+
+    delete pStatistics;
+    pStatistics = NULL;
+
+    delete [] fPeakLevels;
+    fPeakLevels = NULL;
+
+    delete [] fRmsLevels;
+    fRmsLevels = NULL;
+
+    delete [] fAverageLevelsFiltered;
+    fAverageLevelsFiltered = NULL;
+
+    delete [] nOverflows;
+    nOverflows = NULL;
+
+    delete [] fPeakLevelsIncremental;
+    fPeakLevelsIncremental = NULL;
+
+    delete [] dSumsOfSquaresIncremental;
+    dSumsOfSquaresIncremental = NULL;
+
+    delete [] nOverflowsIncremental;
+    nOverflowsIncremental = NULL;
+}
+
+
+void MeterAnalyser::reset()
+/*  Reset all meter readings.
+
+    return value: none
+*/
+{
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        fPeakLevels[nChannel] = 0.0f;
+        fRmsLevels[nChannel] = 0.0f;
+        fAverageLevelsFiltered[nChannel] = MeterBallistics::getMeterMinimumDecibel();
+
+        nOverflows[nChannel] = 0;
+    }
+
+    fPhaseCorrelation = 1.0f;
+    pMeterBallistics->reset();
+
+    if (pStatistics)
+    {
+        pStatistics->reset();
+    }
+
+    resetIncremental();
+}
+
+
+void MeterAnalyser::resetIncremental()
+/*  Start a new chunk in incremental mode.
+
+    return value: none
+*/
+{
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        fPeakLevelsIncremental[nChannel] = 0.0f;
+        dSumsOfSquaresIncremental[nChannel] = 0.0;
+        nOverflowsIncremental[nChannel] = 0;
+    }
+
+    fSumOfProductIncremental = 0.0f;
+    fSumOfSquaresLeftIncremental = 0.0f;
+    fSumOfSquaresRightIncremental = 0.0f;
+
+    uSamplesInChunk = 0;
+    nStagesFiltered = 0;
+    bFilterPending = false;
+}
+
+
+void MeterAnalyser::processBufferChunk(AudioRingBuffer& ring_buffer, const unsigned int chunk_size, const bool mono)
+/*  Measure the latest chunk of a ring buffer and update meter
+    ballistics.
+
+    ring_buffer (AudioRingBuffer&): ring buffer holding the audio
+    input; has to provide a pre-delay of at least (chunk_size / 2)
+    samples
+
+    chunk_size (unsigned integer): number of samples to measure
+
+    mono (Boolean): stereo input has been mixed down to mono, so
+    copy the readings of the first channel to the second one
+
+    return value: none
+*/
+{
+    unsigned int uPreDelay = chunk_size / 2;
+
+    // length of buffer chunk in fractional seconds
+    // (1024 samples / 44100 samples/s = 23.2 ms)
+    float fProcessedSeconds = (float) chunk_size / (float) nSampleRate;
+
+    if (bIncremental)
+    {
+        // the average levels lag by one chunk in incremental mode;
+        // finish filtering the previous chunk in case the audio
+        // callbacks have not done so
+        finishIncrementalFiltering();
+    }
+    else
+    {
+        // copy ring buffer to determine average level (FIR filter
+        // already adds delay of (chunk_size / 2) samples)
+        pAverageLevelFiltered->copyFromBuffer(ring_buffer, 0, nSampleRate);
+    }
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        if (mono && (nChannel == 1))
+        {
+            fPeakLevels[nChannel] = fPeakLevels[0];
+            fRmsLevels[nChannel] = fRmsLevels[0];
+            fAverageLevelsFiltered[nChannel] = fAverageLevelsFiltered[0];
+            nOverflows[nChannel] = nOverflows[0];
+
+            // the second channel is not filtered, so its band levels
+            // would otherwise never change
+            if (pSpectrum)
+            {
+                pSpectrum->copyChannel(0, nChannel);
+            }
+        }
+        else if (bIncremental)
+        {
+            // reductions have been updated while samples were added
+            // (see processBufferSamples()); average levels have been
+            // set by finishIncrementalFiltering()
+            fPeakLevels[nChannel] = fPeakLevelsIncremental[nChannel];
+            fRmsLevels[nChannel] = (float) sqrt(dSumsOfSquaresIncremental[nChannel] / chunk_size);
+            nOverflows[nChannel] = nOverflowsIncremental[nChannel];
+        }
+        else
+        {
+            // determine peak level for chunk_size samples (use pre-delay)
+            fPeakLevels[nChannel] = ring_buffer.getMagnitude(nChannel, chunk_size, uPreDelay);
+
+            // determine peak level for chunk_size samples (use pre-delay)
+            fRmsLevels[nChannel] = ring_buffer.getRMSLevel(nChannel, chunk_size, uPreDelay);
+
+            // determine filtered average level for chunk_size samples
+            // (please note that this level has already been converted
+            // to decibels!)
+            fAverageLevelsFiltered[nChannel] = pAverageLevelFiltered->getLevel(nChannel);
+
+            // determine overflows for chunk_size samples (use pre-delay)
+            nOverflows[nChannel] = countOverflows(ring_buffer, nChannel, chunk_size, uPreDelay);
+        }
+
+        // apply meter ballistics and store values so that the editor
+        // can access them
+        pMeterBallistics->updateChannel(nChannel, fProcessedSeconds, fPeakLevels[nChannel], fRmsLevels[nChannel], fAverageLevelsFiltered[nChannel], nOverflows[nChannel]);
+
+        if (pStatistics)
+        {
+            pStatistics->addChunk(nChannel, MeterBallistics::level2decibel(fPeakLevels[nChannel]), fAverageLevelsFiltered[nChannel], nOverflows[nChannel]);
+        }
+    }
+
+    // phase correlation is only defined for stereo signals
+    if (bIsStereo)
+    {
+        fPhaseCorrelation = 1.0f;
+
+        // check whether the stereo signal has been mixed down to mono
+        if (mono)
+        {
+            fPhaseCorrelation = 1.0f;
+        }
+        // otherwise, process only levels at or above -80 dB
+        else if ((fRmsLevels[0] >= 0.0001f) || (fRmsLevels[1] >= 0.0001f))
+        {
+            float sum_of_product = 0.0f;
+            float sum_of_squares_left = 0.0f;
+            float sum_of_squares_right = 0.0f;
+
+            if (bIncremental)
+            {
+                sum_of_product = fSumOfProductIncremental;
+                sum_of_squares_left = fSumOfSquaresLeftIncremental;
+                sum_of_squares_right = fSumOfSquaresRightIncremental;
+            }
+            else
+            {
+                // determine correlation for chunk_size samples (use
+                // pre-delay)
+                for (unsigned int uSample = 0; uSample < chunk_size; uSample++)
+                {
+                    float ringbuffer_left = ring_buffer.getSample(0, uSample, uPreDelay);
+                    float ringbuffer_right = ring_buffer.getSample(1, uSample, uPreDelay);
+
+                    sum_of_product += ringbuffer_left * ringbuffer_right;
+                    sum_of_squares_left += ringbuffer_left * ringbuffer_left;
+                    sum_of_squares_right += ringbuffer_right * ringbuffer_right;
+                }
+            }
+
+            float fSumsOfSquares = sum_of_squares_left * sum_of_squares_right;
+
+            // prevent division by zero and taking the square root of
+            // a negative number
+            if (fSumsOfSquares > 0.0f)
+            {
+                fPhaseCorrelation = sum_of_product / sqrt(fSumsOfSquares);
+            }
+            else
+            {
+                // this is mathematically incorrect, but "musically"
+                // correct (i.e. signal is mono-compatible)
+                fPhaseCorrelation = 1.0f;
+            }
+
+            // only count measured correlations
+            if (pStatistics)
+            {
+                pStatistics->addPhaseCorrelation(fPhaseCorrelation);
+            }
+        }
+
+        pMeterBallistics->setPhaseCorrelation(fProcessedSeconds, fPhaseCorrelation);
+
+        float fStereoMeterValue = 0.0f;
+
+        // do not process levels below -80 dB
+        if ((fRmsLevels[0] < 0.0001f) && (fRmsLevels[1] < 0.0001f))
+        {
+            fStereoMeterValue = 0.0f;
+        }
+        else if (fRmsLevels[1] >= fRmsLevels[0])
+        {
+            fStereoMeterValue = 1.0f - fRmsLevels[0] / fRmsLevels[1];
+        }
+        else
+        {
+            fStereoMeterValue = fRmsLevels[1] / fRmsLevels[0] - 1.0f;
+        }
+
+        pMeterBallistics->setStereoMeterValue(fProcessedSeconds, fStereoMeterValue);
+    }
+
+    if (bIncremental)
+    {
+        // filter this chunk during the next audio callbacks
+        resetIncremental();
+
+        pAverageLevelFiltered->copyFromBuffer(ring_buffer, 0, nSampleRate);
+        bFilterPending = true;
+    }
+}
+
+
+void MeterAnalyser::processBufferSamples(AudioRingBuffer& ring_buffer, const unsigned int num_samples)
+/*  Spread the work of a chunk over all audio callbacks (incremental
+    mode only).  Peak and RMS levels, overflows and correlation are
+    accumulated as samples become available, and the average filter
+    of the previous chunk is run one stage (forward DFT, convolution
+    or inverse DFT) of one channel at a time.  This keeps hosts with
+    small buffers from having to process a whole chunk in a single
+    callback.
+
+    ring_buffer (AudioRingBuffer&): ring buffer holding the audio
+    input; has to provide a pre-delay of at least (chunk_size / 2)
+    samples
+
+    num_samples (unsigned integer): number of samples that have just
+    been added to the ring buffer
+
+    return value: none
+*/
+{
+    if (!bIncremental)
+    {
+        return;
+    }
+
+    // samples are measured after the same pre-delay as in
+    // processBufferChunk(), so the results do not change
+    unsigned int uPreDelay = uChunkSize / 2;
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        float fPeakLevel = fPeakLevelsIncremental[nChannel];
+        double dSumOfSquares = dSumsOfSquaresIncremental[nChannel];
+        int nOverflowsChannel = nOverflowsIncremental[nChannel];
+
+        for (unsigned int uSample = 0; uSample < num_samples; uSample++)
+        {
+            float fSampleValue = ring_buffer.getSample(nChannel, uSample, uPreDelay);
+
+            fPeakLevel = jmax(fPeakLevel, fabsf(fSampleValue));
+            dSumOfSquares += fSampleValue * fSampleValue;
+
+            // see countOverflows()
+            if ((fSampleValue < -0.9999f) || (fSampleValue > 0.9999f))
+            {
+                nOverflowsChannel++;
+            }
+        }
+
+        fPeakLevelsIncremental[nChannel] = fPeakLevel;
+        dSumsOfSquaresIncremental[nChannel] = dSumOfSquares;
+        nOverflowsIncremental[nChannel] = nOverflowsChannel;
+    }
+
+    if (bIsStereo)
+    {
+        for (unsigned int uSample = 0; uSample < num_samples; uSample++)
+        {
+            float ringbuffer_left = ring_buffer.getSample(0, uSample, uPreDelay);
+            float ringbuffer_right = ring_buffer.getSample(1, uSample, uPreDelay);
+
+            fSumOfProductIncremental += ringbuffer_left * ringbuffer_right;
+            fSumOfSquaresLeftIncremental += ringbuffer_left * ringbuffer_left;
+            fSumOfSquaresRightIncremental += ringbuffer_right * ringbuffer_right;
+        }
+    }
+
+    uSamplesInChunk += num_samples;
+
+    if (bFilterPending)
+    {
+        // run filter stages at regular intervals (with one channel
+        // and three stages, after a sixth, half and five sixths of a
+        // chunk), so that no callback has to run more than a single
+        // DFT unless the host's buffers are large
+        int nStages = nNumberOfChannels * AverageLevelFiltered::KMETER_FILTER_STAGES;
+        int nStagesDue = int((2 * nStages * uSamplesInChunk + uChunkSize) / (2 * uChunkSize));
+        nStagesDue = jmin(nStagesDue, nStages);
+
+        while (nStagesFiltered < nStagesDue)
+        {
+            filterNextStage();
+        }
+    }
+}
+
+
+void MeterAnalyser::filterNextStage()
+/*  Run next stage of the average filter (incremental mode only).
+    All stages of a channel are run before those of the next one.
+
+    return value: none
+*/
+{
+    int nChannel = nStagesFiltered / AverageLevelFiltered::KMETER_FILTER_STAGES;
+    int nStage = nStagesFiltered % AverageLevelFiltered::KMETER_FILTER_STAGES;
+
+    pAverageLevelFiltered->filterChannelStage(nChannel, nStage);
+    nStagesFiltered++;
+}
+
+
+void MeterAnalyser::finishIncrementalFiltering()
+/*  Filter all remaining channels of the previous chunk and update
+    the average levels.
+
+    return value: none
+*/
+{
+    if (!bFilterPending)
+    {
+        return;
+    }
+
+    int nStages = nNumberOfChannels * AverageLevelFiltered::KMETER_FILTER_STAGES;
+
+    while (nStagesFiltered < nStages)
+    {
+        filterNextStage();
+    }
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        fAverageLevelsFiltered[nChannel] = pAverageLevelFiltered->getFilteredLevel(nChannel);
+    }
+
+    bFilterPending = false;
+}
+
+
+void MeterAnalyser::copyFilteredToBuffer(AudioRingBuffer& destination, const unsigned int chunk_size)
+/*  Copy audio samples after average filtering (useful for debugging
+    the filters).
+
+    destination (AudioRingBuffer&): ring buffer to receive the
+    filtered audio samples
+
+    chunk_size (unsigned integer): number of samples to copy
+
+    return value: none
+*/
+{
+    pAverageLevelFiltered->copyToBuffer(destination, 0, chunk_size);
+}
+
+
+MeterBallistics* MeterAnalyser::getLevels()
+/*  Get meter ballistics.
+
+    return value (MeterBallistics*): meter ballistics holding the
+    current meter readings
+*/
+{
+    return pMeterBallistics;
+}
+
+
+int MeterAnalyser::getNumberOfChannels()
+/*  Get number of audio channels.
+
+    return value (integer): number of audio channels
+*/
+{
+    return nNumberOfChannels;
+}
+
+
+int MeterAnalyser::getSampleRate()
+/*  Get sample rate.
+
+    return value (integer): sample rate of the audio input
+*/
+{
+    return nSampleRate;
+}
+
+
+float MeterAnalyser::getPeakLevel(const int channel)
+/*  Get peak level of the last processed chunk (without meter
+    ballistics).
+
+    channel (integer): selected audio channel
+
+    return value (float): peak level (linear, not in decibels!)
+*/
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+
+    return fPeakLevels[channel];
+}
+
+
+float MeterAnalyser::getRmsLevel(const int channel)
+/*  Get unfiltered RMS level of the last processed chunk (without
+    meter ballistics).
+
+    channel (integer): selected audio channel
+
+    return value (float): RMS level (linear, not in decibels!)
+*/
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+
+    return fRmsLevels[channel];
+}
+
+
+float MeterAnalyser::getAverageLevel(const int channel)
+/*  Get filtered average level of the last processed chunk (without
+    meter ballistics).  In ITU-R BS.1770-1 mode, the loudness of all
+    channels is returned for the first channel.
+
+    channel (integer): selected audio channel
+
+    return value (float): average level in decibels
+*/
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+
+    return fAverageLevelsFiltered[channel];
+}
+
+
+int MeterAnalyser::getOverflows(const int channel)
+/*  Get number of overflows in the last processed chunk.
+
+    channel (integer): selected audio channel
+
+    return value (integer): number of overflowing samples
+*/
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+
+    return nOverflows[channel];
+}
+
+
+float MeterAnalyser::getPhaseCorrelation()
+/*  Get phase correlation of the last processed chunk (without meter
+    ballistics; stereo only).
+
+    return value (float): phase correlation (-1.0 to 1.0)
+*/
+{
+    return fPhaseCorrelation;
+}
+
+
+int MeterAnalyser::getSettlingTime()
+/*  Get number of samples it takes for the average filters to settle
+    after a reset (or before the first sample of a segment of an
+    audio file).
+
+    return value (integer): settling time in samples
+*/
+{
+    return pAverageLevelFiltered->getSettlingTime();
+}
+
+
+int MeterAnalyser::getAverageAlgorithm()
+/*  Get current averaging algorithm.
+
+    return value (integer): algorithm for calculating average meter
+    levels
+*/
+{
+    return pAverageLevelFiltered->getAlgorithm();
+}
+
+
+void MeterAnalyser::setAverageAlgorithm(const int average_algorithm)
+/*  Set averaging algorithm.
+
+    average_algorithm (integer): algorithm for calculating average
+    meter levels; must be one of the "selAlgorithm..."  values defined
+    in "plugin_parameters.h"
+
+    return value: none
+*/
+{
+    pAverageLevelFiltered->setAlgorithm(average_algorithm);
+    pMeterBallistics->setAverageAlgorithm(pAverageLevelFiltered->getAlgorithm());
+
+    // the pending chunk may have been partly filtered with the old
+    // algorithm, so drop it
+    bFilterPending = false;
+}
+
+
+bool MeterAnalyser::isIncremental()
+/*  Get processing mode.
+
+    return value (Boolean): true if work is spread over all audio
+    callbacks (see setIncremental())
+*/
+{
+    return bIncremental;
+}
+
+
+void MeterAnalyser::setIncremental(const bool incremental)
+/*  Select processing mode.  By default, all measurements of a chunk
+    are taken when it is complete.  When the host's buffers are much
+    smaller than a chunk, this results in many cheap callbacks and one
+    expensive one.  In incremental mode, measurements are spread over
+    all callbacks by calling processBufferSamples() whenever samples
+    are added to the ring buffer.  The readings are the same except
+    for rounding, but average levels are updated one chunk later.
+
+    incremental (Boolean): spread work over all audio callbacks
+
+    return value: none
+*/
+{
+    bIncremental = incremental;
+    resetIncremental();
+}
+
+
+bool MeterAnalyser::setChannelLayout(const StringArray& channel_names)
+/*  Set channel layout used for weighting channels in ITU-R BS.1770
+    mode (such as the speaker positions stored in a WAV file).
+
+    channel_names (StringArray): names of all audio channels (such as
+    "L", "R", "C", "LFE", "Ls", "Rs")
+
+    return value (Boolean): false if the number of names does not
+    match the number of channels (layout is left unchanged)
+*/
+{
+    return pAverageLevelFiltered->setChannelLayout(channel_names);
+}
+
+
+MeterStatistics* MeterAnalyser::getStatistics()
+/*  Get statistics that have been accumulated since the last reset
+    (maximum peak levels, overflows, average levels and so on).
+
+    return value (MeterStatistics pointer): accumulated statistics,
+    or NULL if statistics have not been enabled
+*/
+{
+    return pStatistics;
+}
+
+
+void MeterAnalyser::enableStatistics()
+/*  Start accumulating statistics.  These are not needed for the
+    meters, so they are only allocated on request.
+
+    return value: none
+*/
+{
+    if (pStatistics == NULL)
+    {
+        pStatistics = new MeterStatistics(nNumberOfChannels);
+    }
+}
+
+
+void MeterAnalyser::setSpectrum(Spectrum* spectrum)
+/*  Feed a spectrum analyser from the DFTs that are calculated for
+    average levels anyway.
+
+    spectrum (Spectrum pointer): spectrum analyser (or NULL to stop);
+    the caller keeps ownership
+
+    return value: none
+*/
+{
+    pSpectrum = spectrum;
+    pAverageLevelFiltered->setSpectrum(spectrum);
+}
+
+
+int MeterAnalyser::countOverflows(AudioRingBuffer& ring_buffer, const unsigned int channel, const unsigned int length, const unsigned int pre_delay)
+/*  Count overflowing samples.
+
+    ring_buffer (AudioRingBuffer&): ring buffer holding the audio
+    input
+
+    channel (unsigned integer): selected audio channel
+
+    length (unsigned integer): number of samples to check
+
+    pre_delay (unsigned integer): pre-delay in samples
+
+    return value (integer): number of overflows
+*/
+{
+    // initialise number of overflows in this buffer
+    int nOverflows = 0;
+
+    // loop through samples of buffer
+    for (unsigned int uSample = 0; uSample < length; uSample++)
+    {
+        // get current sample value
+        float fSampleValue = ring_buffer.getSample(channel, uSample, pre_delay);
+
+        // in the 16-bit domain, full scale corresponds to an absolute
+        // integer value of 32'767 or 32'768, so we'll treat absolute
+        // levels of 32'767 and above as overflows; this corresponds
+        // to a floating-point level of 32'767 / 32'768 = 0.9999694
+        // (approx. -0.001 dBFS).
+        if ((fSampleValue < -0.9999f) || (fSampleValue > 0.9999f))
+        {
+            nOverflows++;
+        }
+    }
+
+    // return number of overflows in this buffer
+    return nOverflows;
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,124 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __METER_ANALYSER_H__
+#define __METER_ANALYSER_H__
+
+#define KMETER_BUFFER_SIZE 1024
+
+class MeterAnalyser;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "audio_ring_buffer.h"
+#include "average_level_filtered.h"
+#include "meter_ballistics.h"
+#include "meter_statistics.h"
+
+
+//==============================================================================
+/**
+*/
+class MeterAnalyser
+{
+public:
+    MeterAnalyser(const int channels, const int buffer_size, const int sample_rate, const int average_algorithm);
+    ~MeterAnalyser();
+
+    void reset();
+    void processBufferChunk(AudioRingBuffer& ring_buffer, const unsigned int chunk_size, const bool mono);
+    void processBufferSamples(AudioRingBuffer& ring_buffer, const unsigned int num_samples);
+    void copyFilteredToBuffer(AudioRingBuffer& destination, const unsigned int chunk_size);
+
+    MeterBallistics* getLevels();
+    MeterStatistics* getStatistics();
+    void enableStatistics();
+    int getNumberOfChannels();
+    int getSampleRate();
+    int getSettlingTime();
+
+    float getPeakLevel(const int channel);
+    float getRmsLevel(const int channel);
+    float getAverageLevel(const int channel);
+    int getOverflows(const int channel);
+    float getPhaseCorrelation();
+
+    int getAverageAlgorithm();
+    void setAverageAlgorithm(const int average_algorithm);
+
+    bool isIncremental();
+    void setIncremental(const bool incremental);
+
+    bool setChannelLayout(const StringArray& channel_names);
+    void setSpectrum(Spectrum* spectrum);
+
+    static int countOverflows(AudioRingBuffer& ring_buffer, const unsigned int channel, const unsigned int length, const unsigned int pre_delay);
+
+private:
+    JUCE_LEAK_DETECTOR(MeterAnalyser);
+
+    void resetIncremental();
+    void filterNextStage();
+    void finishIncrementalFiltering();
+
+    AverageLevelFiltered* pAverageLevelFiltered;
+    MeterBallistics* pMeterBallistics;
+    MeterStatistics* pStatistics;
+    Spectrum* pSpectrum;
+
+    int nNumberOfChannels;
+    int nSampleRate;
+    bool bIsStereo;
+
+    float* fPeakLevels;
+    float* fRmsLevels;
+    float* fAverageLevelsFiltered;
+    int* nOverflows;
+    float fPhaseCorrelation;
+
+    // incremental mode: reductions of the current chunk are updated
+    // whenever samples are added, and the average filter of the
+    // previous chunk is run one stage of one channel at a time
+    bool bIncremental;
+    bool bFilterPending;
+    int nStagesFiltered;
+    unsigned int uChunkSize;
+    unsigned int uSamplesInChunk;
+
+    float* fPeakLevelsIncremental;
+    double* dSumsOfSquaresIncremental;
+    int* nOverflowsIncremental;
+
+    float fSumOfProductIncremental;
+    float fSumOfSquaresLeftIncremental;
+    float fSumOfSquaresRightIncremental;
+};
+
+
+#endif  // __METER_ANALYSER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -81,7 +81,6 @@ MeterBallistics::MeterBallistics(int nChannels, int AverageAlgorithm, bool bPeak
     fMaximumPeakLevels = new float[nNumberOfChannels];
     nNumberOfOverflows = new int[nNumberOfChannels];
 
-
     // select "infinite peak hold" or "falling peaks" mode
     setPeakMeterInfiniteHold(bPeakMeterInfiniteHold);
     setAverageMeterInfiniteHold(bAverageMeterInfiniteHold);
@@ -126,6 +126,14 @@ MeterBar::MeterBar(const String& componentName, int posX, int posY, int Width, i
     int nRange = 0; // bar level range (in 0.1 dB)
     int nColor = 0;
 
+    // atlas will be rendered once the segments have been placed
+    nAtlasCellWidth = 0;
+
+    for (int nColour = 0; nColour < MeterSegment::NUMBER_OF_COLOURS; nColour++)
+    {
+        nAtlasOffset[nColour] = 0;
+    }
+
     MeterArray = new MeterSegment*[nNumberOfBars];
 
     for (int n = 0; n < nNumberOfBars; n++)
@@ -199,9 +207,7 @@ MeterBar::MeterBar(const String& componentName, int posX, int posY, int Width, i
 
         nThreshold -= nRange;
         nKmeterLevel -= nRange;
-        MeterArray[n] = new MeterSegment("MeterSegment #" + String(n) + " (" + componentName + ")", nThreshold * 0.1f, nRange * 0.1f, displayPeakMeter, nColor);
-
-        addAndMakeVisible(MeterArray[n]);
+        MeterArray[n] = new MeterSegment(nThreshold * 0.1f, nRange * 0.1f, displayPeakMeter, nColor);
     }
 }
 
@@ -209,15 +215,12 @@ MeterBar::~MeterBar()
 {
     for (int n = 0; n < nNumberOfBars; n++)
     {
-        removeChildComponent(MeterArray[n]);
         delete MeterArray[n];
         MeterArray[n] = NULL;
     }
 
     delete [] MeterArray;
     MeterArray = NULL;
-
-    deleteAllChildren();
 }
 
 void MeterBar::visibilityChanged()
@@ -338,12 +341,121 @@ void MeterBar::visibilityChanged()
 
         nKmeterLevel -= nRange;
     }
+
+    renderAtlas();
+    repaint();
+}
+
+
+void MeterBar::renderAtlas()
+{
+    // all meter segments of a bar have the same width, so only their
+    // length (without border) differs; find the longest segment of
+    // every colour
+    int nCellLength[MeterSegment::NUMBER_OF_COLOURS];
+
+    for (int nColour = 0; nColour < MeterSegment::NUMBER_OF_COLOURS; nColour++)
+    {
+        nCellLength[nColour] = 0;
+    }
+
+    for (int n = 0; n < nNumberOfBars; n++)
+    {
+        const Rectangle<int>& rectSegment = MeterArray[n]->getBounds();
+        int nColour = MeterArray[n]->getColourNumber();
+        int nLength;
+
+        if (bHorizontalMeter)
+        {
+            nAtlasCellWidth = rectSegment.getHeight() - 2;
+            nLength = rectSegment.getWidth() - 2;
+        }
+        else
+        {
+            nAtlasCellWidth = rectSegment.getWidth() - 2;
+            nLength = rectSegment.getHeight() - 2;
+        }
+
+        if (nLength > nCellLength[nColour])
+        {
+            nCellLength[nColour] = nLength;
+        }
+    }
+
+    // colours are stacked along the meter's direction, brightness
+    // levels across it
+    int nAtlasLength = 0;
+
+    for (int nColour = 0; nColour < MeterSegment::NUMBER_OF_COLOURS; nColour++)
+    {
+        nAtlasOffset[nColour] = nAtlasLength;
+        nAtlasLength += nCellLength[nColour];
+    }
+
+    int nAtlasWidth = MeterSegment::NUMBER_OF_BRIGHTNESS_LEVELS * nAtlasCellWidth;
+
+    if ((nAtlasLength < 1) || (nAtlasWidth < 1))
+    {
+        imageAtlas = Image::null;
+        return;
+    }
+
+    if (bHorizontalMeter)
+    {
+        imageAtlas = Image(Image::RGB, nAtlasLength, nAtlasWidth, false);
+    }
+    else
+    {
+        imageAtlas = Image(Image::RGB, nAtlasWidth, nAtlasLength, false);
+    }
+
+    Graphics g(imageAtlas);
+
+    for (int nColour = 0; nColour < MeterSegment::NUMBER_OF_COLOURS; nColour++)
+    {
+        for (int nLevel = 0; nLevel < MeterSegment::NUMBER_OF_BRIGHTNESS_LEVELS; nLevel++)
+        {
+            g.setColour(MeterSegment::getColour(nColour, nLevel));
+
+            if (bHorizontalMeter)
+            {
+                g.fillRect(nAtlasOffset[nColour], nLevel * nAtlasCellWidth, nCellLength[nColour], nAtlasCellWidth);
+            }
+            else
+            {
+                g.fillRect(nLevel * nAtlasCellWidth, nAtlasOffset[nColour], nAtlasCellWidth, nCellLength[nColour]);
+            }
+        }
+    }
 }
 
 
 void MeterBar::paint(Graphics& g)
 {
     g.fillAll(Colours::black);
+
+    // draw all segments in one go; neighbouring segments share their
+    // borders, so keep the original order to get the same result as
+    // with one component per segment
+    Rectangle<int> rectClip = g.getClipBounds();
+
+    for (int n = 0; n < nNumberOfBars; n++)
+    {
+        if (MeterArray[n]->getBounds().intersects(rectClip))
+        {
+            int nColour = MeterArray[n]->getColourNumber();
+            int nLevel = MeterArray[n]->getBrightnessLevel();
+
+            if (bHorizontalMeter)
+            {
+                MeterArray[n]->paint(g, imageAtlas, nAtlasOffset[nColour], nLevel * nAtlasCellWidth);
+            }
+            else
+            {
+                MeterArray[n]->paint(g, imageAtlas, nLevel * nAtlasCellWidth, nAtlasOffset[nColour]);
+            }
+        }
+    }
 }
 
 void MeterBar::resized()
@@ -361,9 +473,21 @@ void MeterBar::setLevels(float peakLevel, float averageLevel, float peakLevelPea
         fPeakLevelPeak = peakLevelPeak;
         fAverageLevelPeak = averageLevelPeak;
 
+        // changed segments are adjacent, so re-painting their union
+        // hardly paints any unchanged segments
+        Rectangle<int> rectChanged;
+
         for (int n = 0; n < nNumberOfBars; n++)
         {
-            MeterArray[n]->setLevels(fPeakLevel, fAverageLevel, fPeakLevelPeak, fAverageLevelPeak);
+            if (MeterArray[n]->setLevels(fPeakLevel, fAverageLevel, fPeakLevelPeak, fAverageLevelPeak))
+            {
+                rectChanged = rectChanged.getUnion(MeterArray[n]->getBounds());
+            }
+        }
+
+        if (!rectChanged.isEmpty())
+        {
+            repaint(rectChanged);
         }
     }
 }
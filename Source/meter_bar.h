@@ -47,6 +47,8 @@ public:
 private:
     JUCE_LEAK_DETECTOR(MeterBar);
 
+    void renderAtlas();
+
     float fPeakLevel;
     float fAverageLevel;
 
@@ -72,6 +74,12 @@ private:
     int nLimitGreenBars_2;
 
     MeterSegment** MeterArray;
+
+    // pre-rendered meter segments (one cell for every combination of
+    // colour and brightness)
+    Image imageAtlas;
+    int nAtlasCellWidth;
+    int nAtlasOffset[MeterSegment::NUMBER_OF_COLOURS];
 };
 
 
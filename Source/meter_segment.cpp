@@ -26,10 +26,11 @@
 #include "meter_segment.h"
 
 
-MeterSegment::MeterSegment(const String& componentName, float fThreshold, float fRange, bool bDisplayPeakMeter, int nColor)
+MeterSegment::MeterSegment(float fThreshold, float fRange, bool bDisplayPeakMeter, int nColor)
 {
-    // set component name
-    setName(componentName);
+    // meter segments are not components, but are drawn by their meter
+    // bar; this saves hundreds of components and repaint requests
+    // per meter
 
     // display additional peak meter?
     displayPeakMeter = bDisplayPeakMeter;
@@ -47,22 +48,57 @@ MeterSegment::MeterSegment(const String& componentName, float fThreshold, float
     // show peak level marker on segment?
     nPeakMarker = PEAK_MARKER_NONE;
 
-    // initialise meter segment's brightness (0.0f is dark, 1.0f is
-    // fully lit)
-    fBrightness = 0.0f;
+    // initialise meter segment's brightness (0 is dark,
+    // NUMBER_OF_BRIGHTNESS_LEVELS - 1 is fully lit)
+    nBrightnessLevel = 0;
 
-    // set meter segment's hue from colour number
-    if (nColor == 0)
+    // set meter segment's hue from colour number (0: red, 1: yellow,
+    // 2: green, 3: blue)
+    if ((nColor >= 0) && (nColor < NUMBER_OF_COLOURS))
+    {
+        nColourNumber = nColor;
+    }
+    else
+    {
+        nColourNumber = NUMBER_OF_COLOURS - 1;
+    }
+
+    // initialise brightness and peak marker
+    setLevels(-9999.9f, -9999.9f, -9999.9f, -9999.9f);
+}
+
+
+MeterSegment::~MeterSegment()
+{
+    // nothing to do, really
+}
+
+
+Colour MeterSegment::getColour(int colour_number, int brightness_level)
+/*  Get colour of a meter segment.
+
+    colour_number (integer): colour number of meter segment (0: red,
+    1: yellow, 2: green, 3: blue)
+
+    brightness_level (integer): quantised brightness of meter segment
+    (0 to NUMBER_OF_BRIGHTNESS_LEVELS - 1)
+
+    return value (Colour): colour of meter segment
+*/
+{
+    float fHue;
+
+    if (colour_number == 0)
     {
         // meter segment is red
         fHue = 0.00f;
     }
-    else if (nColor == 1)
+    else if (colour_number == 1)
     {
         // meter segment is yellow
         fHue = 0.18f;
     }
-    else if (nColor == 2)
+    else if (colour_number == 2)
     {
         // meter segment is green
         fHue = 0.30f;
@@ -73,87 +109,116 @@ MeterSegment::MeterSegment(const String& componentName, float fThreshold, float
         fHue = 0.58f;
     }
 
-    // make sure that segment is drawn after initialisation
-    setLevels(-9999.9f, -9999.9f, -9999.9f, -9999.9f);
+    // to look well, meter segments should be left with some colour
+    // and not have maximum brightness
+    float fBrightness = 0.25f + 0.72f * brightness_level / float(NUMBER_OF_BRIGHTNESS_LEVELS - 1);
+
+    return Colour(fHue, 1.0f, fBrightness, 1.0f);
 }
 
 
-MeterSegment::~MeterSegment()
-{
-    // nothing to do, really
-}
+void MeterSegment::paint(Graphics& g, const Image& imageAtlas, int atlas_x, int atlas_y)
+/*  Draw meter segment.
 
+    g (Graphics): graphics context of meter bar
 
-void MeterSegment::paint(Graphics& g)
-{
-    // get meter segment's screen dimensions
-    int width = getWidth();
-    int height = getHeight();
+    imageAtlas (Image): meter bar's pre-rendered meter segments
 
-    // initialise meter segment's colour from hue and brightness
-    g.setColour(Colour(fHue, 1.0f, fBrightness, 1.0f));
+    atlas_x (integer): x position of segment's colour and brightness
+    in atlas
 
-    // fill meter segment with solid colour, but leave a border of one
-    // pixel for peak marker
-    g.fillRect(1, 1, width - 2, height - 2);
+    atlas_y (integer): y position of segment's colour and brightness
+    in atlas
+
+    return value: none
+*/
+{
+    // get meter segment's position within meter bar
+    int x = rectBounds.getX();
+    int y = rectBounds.getY();
+    int width = rectBounds.getWidth();
+    int height = rectBounds.getHeight();
+
+    // copy solid colour from atlas (saves a colour conversion and
+    // fill), but leave a border of one pixel for peak marker
+    g.drawImage(imageAtlas, x + 1, y + 1, width - 2, height - 2, atlas_x, atlas_y, width - 2, height - 2);
 
     // if peak marker is lit, draw a white rectangle around meter
     // segment (width: 1 pixel)
     if (nPeakMarker != PEAK_MARKER_NONE)
     {
         g.setColour(Colours::white);
-        g.drawRect(0, 0, width, height);
+        g.drawRect(x, y, width, height);
     }
 }
 
 
-void MeterSegment::visibilityChanged()
+int MeterSegment::getColourNumber()
+{
+    return nColourNumber;
+}
+
+
+int MeterSegment::getBrightnessLevel()
+{
+    return nBrightnessLevel;
+}
+
+
+const Rectangle<int>& MeterSegment::getBounds()
 {
-    // if this function did not exist, the meter segment wouldn't be
-    // drawn until the first level change!
+    return rectBounds;
 }
 
 
-void MeterSegment::resized()
+void MeterSegment::setBounds(int x, int y, int width, int height)
 {
+    rectBounds.setBounds(x, y, width, height);
 }
 
 
-void MeterSegment::setLevels(float fPeakLevel, float fAverageLevel, float fPeakLevelPeak, float fAverageLevelPeak)
+bool MeterSegment::setLevels(float fPeakLevel, float fAverageLevel, float fPeakLevelPeak, float fAverageLevelPeak)
+/*  Update brightness and peak marker.
+
+    return value (Boolean): true if the segment has to be re-painted
+*/
 {
     // store old brightness and peak marker values
-    float fBrightnessOld = fBrightness;
+    int nBrightnessLevelOld = nBrightnessLevel;
     int nPeakMarkerOld = nPeakMarker;
 
+    // brightness (0.0f is dark, 1.0f is fully lit)
+    float fBrightness;
+
     // current average level lies on or above upper threshold, so
     // fully light meter segment
     if (fAverageLevel >= fUpperThreshold)
     {
-        fBrightness = 0.97f;
+        fBrightness = 1.0f;
     }
     // peak metering is enabled and current peak level lies within
     // thresholds or on upper threshold, so fully light meter segment
     else if (displayPeakMeter && (fPeakLevel > fLowerThreshold) && (fPeakLevel <= fUpperThreshold))
     {
-        fBrightness = 0.97f;
+        fBrightness = 1.0f;
     }
     // current average level lies on or below lower threshold, so set
     // meter segment to dark
     else if (fAverageLevel <= fLowerThreshold)
     {
-        fBrightness = 0.25f;
+        fBrightness = 0.0f;
     }
     // current average level lies within thresholds, so calculate
     // brightness from current level
     else
     {
         fBrightness = (fAverageLevel - fLowerThreshold) / fThresholdRange;
-
-        // to look well, meter segments should be left with some
-        // colour and not have maximum brightness
-        fBrightness = fBrightness * 0.72f + 0.25f;
     }
 
+    // quantise brightness so that meter segments can be copied from
+    // a small atlas of pre-rendered colours
+    nBrightnessLevel = roundToInt(fBrightness * (NUMBER_OF_BRIGHTNESS_LEVELS - 1));
+
     // peak metering is enabled and meter's peak level peak lies
     // within thresholds or on upper threshold, so show peak marker on
     // segment
@@ -175,10 +240,7 @@ void MeterSegment::setLevels(float fPeakLevel, float fAverageLevel, float fPeakL
 
     // re-paint meter segment only when brightness or peak marker have
     // changed
-    if ((fBrightness != fBrightnessOld) || (nPeakMarker != nPeakMarkerOld))
-    {
-        repaint(getLocalBounds());
-    }
+    return ((nBrightnessLevel != nBrightnessLevelOld) || (nPeakMarker != nPeakMarkerOld));
 }
 
 
@@ -32,16 +32,25 @@
 //==============================================================================
 /**
 */
-class MeterSegment : public Component
+class MeterSegment
 {
 public:
-    MeterSegment(const String& componentName, float fThreshold, float fRange, bool bDisplayPeakMeter, int nColor);
+    static const int NUMBER_OF_COLOURS = 4;
+    static const int NUMBER_OF_BRIGHTNESS_LEVELS = 32;
+
+    MeterSegment(float fThreshold, float fRange, bool bDisplayPeakMeter, int nColor);
     ~MeterSegment();
 
-    void setLevels(float fPeakLevel, float fAverageLevel, float fPeakLevelPeak, float fAverageLevelPeak);
-    void paint(Graphics& g);
-    void resized();
-    void visibilityChanged();
+    static Colour getColour(int colour_number, int brightness_level);
+
+    bool setLevels(float fPeakLevel, float fAverageLevel, float fPeakLevelPeak, float fAverageLevelPeak);
+    void paint(Graphics& g, const Image& imageAtlas, int atlas_x, int atlas_y);
+
+    int getColourNumber();
+    int getBrightnessLevel();
+
+    const Rectangle<int>& getBounds();
+    void setBounds(int x, int y, int width, int height);
 
 private:
     JUCE_LEAK_DETECTOR(MeterSegment);
@@ -50,8 +59,8 @@ private:
     static const int PEAK_MARKER_PEAK = 1;
     static const int PEAK_MARKER_AVERAGE = 2;
 
-    float fHue;
-    float fBrightness;
+    int nColourNumber;
+    int nBrightnessLevel;
 
     float fLowerThreshold;
     float fUpperThreshold;
@@ -59,6 +68,9 @@ private:
 
     int nPeakMarker;
     bool displayPeakMeter;
+
+    // position within the meter bar
+    Rectangle<int> rectBounds;
 };
 
 
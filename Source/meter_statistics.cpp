@@ -0,0 +1,277 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "meter_statistics.h"
+#include "meter_ballistics.h"
+
+
+MeterStatistics::MeterStatistics(const int channels)
+/*  Constructor.  Accumulates meter readings that do not depend on
+    meter ballistics, such as maximum peak levels and the number of
+    overflows.
+
+    This is a value type: it can be copied freely, and the statistics
+    of consecutive parts of an audio file can be combined using
+    merge().
+
+    channels (integer): number of audio input channels
+
+    return value: none
+*/
+{
+    jassert(channels > 0);
+
+    nNumberOfChannels = channels;
+
+    arrNumberOfChunks.insertMultiple(0, 0, nNumberOfChannels);
+    arrMaximumPeakLevels.insertMultiple(0, 0.0f, nNumberOfChannels);
+    arrAverageEnergies.insertMultiple(0, 0.0, nNumberOfChannels);
+    arrNumberOfOverflows.insertMultiple(0, 0, nNumberOfChannels);
+
+    reset();
+}
+
+
+MeterStatistics::~MeterStatistics()
+{
+}
+
+
+void MeterStatistics::reset()
+/*  Reset all statistics.
+
+    return value: none
+*/
+{
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        arrNumberOfChunks.set(nChannel, 0);
+        arrMaximumPeakLevels.set(nChannel, MeterBallistics::getMeterMinimumDecibel());
+        arrAverageEnergies.set(nChannel, 0.0);
+        arrNumberOfOverflows.set(nChannel, 0);
+    }
+
+    nCorrelationChunks = 0;
+    dCorrelationSum = 0.0;
+
+    loudnessHistogram.reset();
+}
+
+
+void MeterStatistics::merge(const MeterStatistics& other)
+/*  Add statistics of another part of the same audio input.  Merging
+    is associative and commutative, so partial statistics may be
+    merged in any order.
+
+    other (const MeterStatistics&): statistics to be merged
+
+    return value: none
+*/
+{
+    jassert(other.nNumberOfChannels == nNumberOfChannels);
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        arrNumberOfChunks.getReference(nChannel) += other.arrNumberOfChunks[nChannel];
+
+        if (other.arrMaximumPeakLevels[nChannel] > arrMaximumPeakLevels[nChannel])
+        {
+            arrMaximumPeakLevels.set(nChannel, other.arrMaximumPeakLevels[nChannel]);
+        }
+
+        arrAverageEnergies.getReference(nChannel) += other.arrAverageEnergies[nChannel];
+        arrNumberOfOverflows.getReference(nChannel) += other.arrNumberOfOverflows[nChannel];
+    }
+
+    nCorrelationChunks += other.nCorrelationChunks;
+    dCorrelationSum += other.dCorrelationSum;
+
+    loudnessHistogram.merge(other.loudnessHistogram);
+}
+
+
+void MeterStatistics::addChunk(const int channel, const float peak_level, const float average_level, const int overflows)
+/*  Add meter readings of a buffer chunk.
+
+    channel (integer): selected audio channel
+
+    peak_level (float): peak level in decibels
+
+    average_level (float): filtered average level in decibels
+
+    overflows (integer): number of overflows in buffer chunk
+
+    return value: none
+*/
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+
+    arrNumberOfChunks.getReference(channel)++;
+
+    if (peak_level > arrMaximumPeakLevels[channel])
+    {
+        arrMaximumPeakLevels.set(channel, peak_level);
+    }
+
+    // average levels are in decibels, so convert them back to mean
+    // squares before integrating
+    arrAverageEnergies.getReference(channel) += pow(10.0, average_level / 10.0);
+
+    arrNumberOfOverflows.getReference(channel) += overflows;
+}
+
+
+void MeterStatistics::addPhaseCorrelation(const float phase_correlation)
+/*  Add phase correlation of a buffer chunk (stereo only).
+
+    phase_correlation (float): phase correlation (-1.0 to 1.0)
+
+    return value: none
+*/
+{
+    dCorrelationSum += phase_correlation;
+    nCorrelationChunks++;
+}
+
+
+void MeterStatistics::addLoudnessBlock(const double mean_square)
+/*  Add a gating block for calculating integrated loudness.
+
+    mean_square (double): weighted and summed mean square of all
+    channels
+
+    return value: none
+*/
+{
+    loudnessHistogram.addBlock(mean_square);
+}
+
+
+int MeterStatistics::getNumberOfChannels() const
+{
+    return nNumberOfChannels;
+}
+
+
+int64 MeterStatistics::getNumberOfChunks(const int channel) const
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+
+    return arrNumberOfChunks[channel];
+}
+
+
+float MeterStatistics::getMaximumPeakLevel(const int channel) const
+/*  Get overall maximum peak level.
+
+    channel (integer): selected audio channel
+
+    return value (float): maximum peak level in decibels
+*/
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+
+    return arrMaximumPeakLevels[channel];
+}
+
+
+float MeterStatistics::getAverageLevel(const int channel) const
+/*  Get overall average level (mean of all chunks' energies).
+
+    channel (integer): selected audio channel
+
+    return value (float): average level in decibels
+*/
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+
+    float fMeterMinimumDecibel = MeterBallistics::getMeterMinimumDecibel();
+
+    if (arrNumberOfChunks[channel] == 0)
+    {
+        return fMeterMinimumDecibel;
+    }
+
+    float fAverageLevel = 10.0f * float(log10(arrAverageEnergies[channel] / double(arrNumberOfChunks[channel])));
+
+    if (fAverageLevel < fMeterMinimumDecibel)
+    {
+        fAverageLevel = fMeterMinimumDecibel;
+    }
+
+    return fAverageLevel;
+}
+
+
+int64 MeterStatistics::getNumberOfOverflows(const int channel) const
+/*  Get overall number of overflows.
+
+    channel (integer): selected audio channel
+
+    return value (64-bit integer): number of overflowing samples
+*/
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+
+    return arrNumberOfOverflows[channel];
+}
+
+
+float MeterStatistics::getPhaseCorrelation() const
+/*  Get mean phase correlation (stereo only).
+
+    return value (float): phase correlation (-1.0 to 1.0); "+1.0"
+    (mono-compatible) if no correlation has been measured
+*/
+{
+    if (nCorrelationChunks == 0)
+    {
+        return 1.0f;
+    }
+
+    return float(dCorrelationSum / double(nCorrelationChunks));
+}
+
+
+int64 MeterStatistics::getNumberOfCorrelationChunks() const
+{
+    return nCorrelationChunks;
+}
+
+
+const LoudnessHistogram& MeterStatistics::getLoudnessHistogram() const
+{
+    return loudnessHistogram;
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,85 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __METER_STATISTICS_H__
+#define __METER_STATISTICS_H__
+
+class MeterStatistics;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "loudness_histogram.h"
+
+
+//==============================================================================
+/**
+*/
+class MeterStatistics
+{
+public:
+    MeterStatistics(const int channels);
+    ~MeterStatistics();
+
+    void reset();
+    void merge(const MeterStatistics& other);
+
+    void addChunk(const int channel, const float peak_level, const float average_level, const int overflows);
+    void addPhaseCorrelation(const float phase_correlation);
+    void addLoudnessBlock(const double mean_square);
+
+    int getNumberOfChannels() const;
+    int64 getNumberOfChunks(const int channel) const;
+
+    float getMaximumPeakLevel(const int channel) const;
+    float getAverageLevel(const int channel) const;
+    int64 getNumberOfOverflows(const int channel) const;
+
+    float getPhaseCorrelation() const;
+    int64 getNumberOfCorrelationChunks() const;
+
+    const LoudnessHistogram& getLoudnessHistogram() const;
+
+private:
+    JUCE_LEAK_DETECTOR(MeterStatistics);
+
+    int nNumberOfChannels;
+
+    Array<int64> arrNumberOfChunks;
+    Array<float> arrMaximumPeakLevels;
+    Array<double> arrAverageEnergies;
+    Array<int64> arrNumberOfOverflows;
+
+    int64 nCorrelationChunks;
+    double dCorrelationSum;
+
+    LoudnessHistogram loudnessHistogram;
+};
+
+
+#endif  // __METER_STATISTICS_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,308 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "numeric_label.h"
+
+
+const char NumericLabel::GLYPHS[NUMBER_OF_GLYPHS + 1] = "0123456789+-.";
+
+
+NumericLabel::NumericLabel(const String& componentName, float font_height, const Colour& colourText)
+/*  Label for numbers that is drawn from pre-rendered glyphs, so that
+    changing its value neither allocates memory nor lays out text.
+
+    componentName (String): name of component
+
+    font_height (float): height of font
+
+    colourText (Colour): colour of text
+
+    return value: none
+*/
+{
+    setName(componentName);
+
+    // this component does not have any transparent areas (increases
+    // performance on redrawing)
+    setOpaque(true);
+
+    nTextLength = 0;
+
+    colourBackground = Colours::black;
+    colourOutline = Colours::transparentBlack;
+
+    Font font(font_height);
+    nGlyphHeight = (int) ceil(font.getHeight());
+    nGlyphCellWidth = 0;
+
+    // digits usually share the same width, but signs and decimal
+    // point do not
+    for (int nGlyph = 0; nGlyph < NUMBER_OF_GLYPHS; nGlyph++)
+    {
+        nGlyphWidth[nGlyph] = font.getStringWidth(String::charToString(GLYPHS[nGlyph]));
+
+        if (nGlyphWidth[nGlyph] > nGlyphCellWidth)
+        {
+            nGlyphCellWidth = nGlyphWidth[nGlyph];
+        }
+    }
+
+    // leave some room for anti-aliasing
+    nGlyphCellWidth += 1;
+
+    // render all glyphs once
+    imageGlyphs = Image(Image::ARGB, NUMBER_OF_GLYPHS * nGlyphCellWidth, nGlyphHeight, true);
+    Graphics g(imageGlyphs);
+
+    g.setFont(font);
+    g.setColour(colourText);
+
+    for (int nGlyph = 0; nGlyph < NUMBER_OF_GLYPHS; nGlyph++)
+    {
+        g.drawSingleLineText(String::charToString(GLYPHS[nGlyph]), nGlyph * nGlyphCellWidth, roundToInt(font.getAscent()));
+    }
+}
+
+
+NumericLabel::~NumericLabel()
+{
+}
+
+
+void NumericLabel::setValue(float value, int decimal_places, bool show_plus_sign)
+/*  Display a fractional number.
+
+    value (float): number to display
+
+    decimal_places (integer): number of decimal places (0 to 6)
+
+    show_plus_sign (Boolean): prepend a plus sign to positive numbers
+    and zero
+
+    return value: none
+*/
+{
+    char strValue[MAXIMUM_LENGTH];
+    char strDigits[MAXIMUM_LENGTH];
+    int nLength = 0;
+    int nDigits = 0;
+
+    bool bNegative = (value < 0.0f);
+    double dMagnitude = fabs((double) value);
+
+    // make sure that all digits fit into the buffer (this also
+    // catches NaN)
+    if (!(dMagnitude < 1.0e9))
+    {
+        dMagnitude = 1.0e9;
+    }
+
+    decimal_places = jlimit(0, 6, decimal_places);
+    int64 nScale = 1;
+
+    for (int n = 0; n < decimal_places; n++)
+    {
+        nScale *= 10;
+    }
+
+    int64 nRounded = (int64)(dMagnitude * nScale + 0.5);
+
+    // collect digits in reverse order
+    for (int n = 0; n < decimal_places; n++)
+    {
+        strDigits[nDigits++] = (char)('0' + nRounded % 10);
+        nRounded /= 10;
+    }
+
+    if (decimal_places > 0)
+    {
+        strDigits[nDigits++] = '.';
+    }
+
+    do
+    {
+        strDigits[nDigits++] = (char)('0' + nRounded % 10);
+        nRounded /= 10;
+    }
+    while (nRounded > 0);
+
+    if (bNegative)
+    {
+        strValue[nLength++] = '-';
+    }
+    else if (show_plus_sign)
+    {
+        strValue[nLength++] = '+';
+    }
+
+    while (nDigits > 0)
+    {
+        strValue[nLength++] = strDigits[--nDigits];
+    }
+
+    setText(strValue, nLength);
+}
+
+
+void NumericLabel::setValue(int value)
+/*  Display an integer number.
+
+    value (integer): number to display
+
+    return value: none
+*/
+{
+    char strValue[MAXIMUM_LENGTH];
+    char strDigits[MAXIMUM_LENGTH];
+    int nLength = 0;
+    int nDigits = 0;
+
+    // "-value" would overflow for the smallest integer
+    int64 nMagnitude = value;
+
+    if (nMagnitude < 0)
+    {
+        strValue[nLength++] = '-';
+        nMagnitude = -nMagnitude;
+    }
+
+    // collect digits in reverse order
+    do
+    {
+        strDigits[nDigits++] = (char)('0' + nMagnitude % 10);
+        nMagnitude /= 10;
+    }
+    while (nMagnitude > 0);
+
+    while (nDigits > 0)
+    {
+        strValue[nLength++] = strDigits[--nDigits];
+    }
+
+    setText(strValue, nLength);
+}
+
+
+void NumericLabel::setText(const char* text, int length)
+{
+    jassert(length <= MAXIMUM_LENGTH);
+
+    // only re-paint label when its text has changed
+    if ((length == nTextLength) && (memcmp(text, strText, length) == 0))
+    {
+        return;
+    }
+
+    memcpy(strText, text, length);
+    nTextLength = length;
+
+    repaint();
+}
+
+
+void NumericLabel::setBackgroundColour(const Colour& colour)
+{
+    if (colour != colourBackground)
+    {
+        colourBackground = colour;
+        repaint();
+    }
+}
+
+
+void NumericLabel::setOutlineColour(const Colour& colour)
+{
+    if (colour != colourOutline)
+    {
+        colourOutline = colour;
+        repaint();
+    }
+}
+
+
+int NumericLabel::getGlyphIndex(char glyph)
+{
+    if ((glyph >= '0') && (glyph <= '9'))
+    {
+        return glyph - '0';
+    }
+    else if (glyph == '+')
+    {
+        return 10;
+    }
+    else if (glyph == '-')
+    {
+        return 11;
+    }
+    else if (glyph == '.')
+    {
+        return 12;
+    }
+    else
+    {
+        return -1;
+    }
+}
+
+
+void NumericLabel::paint(Graphics& g)
+{
+    g.fillAll(colourBackground);
+
+    int nTextWidth = 0;
+
+    for (int nPosition = 0; nPosition < nTextLength; nPosition++)
+    {
+        int nGlyph = getGlyphIndex(strText[nPosition]);
+
+        if (nGlyph >= 0)
+        {
+            nTextWidth += nGlyphWidth[nGlyph];
+        }
+    }
+
+    // text is right-justified and vertically centred
+    int x = getWidth() - HORIZONTAL_BORDER - nTextWidth;
+    int y = VERTICAL_BORDER + (getHeight() - 2 * VERTICAL_BORDER - nGlyphHeight) / 2;
+
+    for (int nPosition = 0; nPosition < nTextLength; nPosition++)
+    {
+        int nGlyph = getGlyphIndex(strText[nPosition]);
+
+        if (nGlyph >= 0)
+        {
+            g.drawImage(imageGlyphs, x, y, nGlyphWidth[nGlyph], nGlyphHeight, nGlyph * nGlyphCellWidth, 0, nGlyphWidth[nGlyph], nGlyphHeight);
+            x += nGlyphWidth[nGlyph];
+        }
+    }
+
+    g.setColour(colourOutline);
+    g.drawRect(0, 0, getWidth(), getHeight());
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,83 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __NUMERIC_LABEL_H__
+#define __NUMERIC_LABEL_H__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+
+//==============================================================================
+/**
+*/
+class NumericLabel : public Component
+{
+public:
+    NumericLabel(const String& componentName, float font_height, const Colour& colourText);
+    ~NumericLabel();
+
+    void setValue(float value, int decimal_places, bool show_plus_sign);
+    void setValue(int value);
+
+    void setBackgroundColour(const Colour& colour);
+    void setOutlineColour(const Colour& colour);
+
+    void paint(Graphics& g);
+
+private:
+    JUCE_LEAK_DETECTOR(NumericLabel);
+
+    static const int MAXIMUM_LENGTH = 24;
+    static const int NUMBER_OF_GLYPHS = 13;
+    static const char GLYPHS[NUMBER_OF_GLYPHS + 1];
+
+    // same borders as JUCE's labels
+    static const int HORIZONTAL_BORDER = 5;
+    static const int VERTICAL_BORDER = 1;
+
+    void setText(const char* text, int length);
+    int getGlyphIndex(char glyph);
+
+    char strText[MAXIMUM_LENGTH];
+    int nTextLength;
+
+    Colour colourBackground;
+    Colour colourOutline;
+
+    // pre-rendered glyphs (one cell per glyph, glyphs are left-aligned
+    // within their cells)
+    Image imageGlyphs;
+    int nGlyphCellWidth;
+    int nGlyphHeight;
+    int nGlyphWidth[NUMBER_OF_GLYPHS];
+};
+
+
+#endif  // __NUMERIC_LABEL_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
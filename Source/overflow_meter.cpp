@@ -25,19 +25,13 @@
 
 #include "overflow_meter.h"
 
-OverflowMeter::OverflowMeter(const String& componentName) : Label(componentName, "0")
+OverflowMeter::OverflowMeter(const String& componentName) : NumericLabel(componentName, 12.0f, Colours::white)
 {
     nOverflows = 0;
+    setValue(nOverflows);
 
-    // this component does not have any transparent areas (increases
-    // performance on redrawing)
-    setOpaque(true);
-
-    setFont(12.0f);
-    setJustificationType(Justification::centredRight);
-    setColour(Label::backgroundColourId, Colours::grey.darker(0.7f));
-    setColour(Label::textColourId, Colours::white);
-    setColour(Label::outlineColourId, Colours::grey.darker(0.2f));
+    setBackgroundColour(Colours::grey.darker(0.7f));
+    setOutlineColour(Colours::grey.darker(0.2f));
 }
 
 OverflowMeter::~OverflowMeter()
@@ -51,15 +45,15 @@ void OverflowMeter::setOverflows(int Overflows)
 
     if (nOverflows != nOverflowsOld)
     {
-        setText(String(nOverflows), dontSendNotification);
+        setValue(nOverflows);
 
         if (nOverflowsOld == 0)
         {
-            setColour(Label::backgroundColourId, Colours::red.darker(0.2f));
+            setBackgroundColour(Colours::red.darker(0.2f));
         }
         else if (nOverflows == 0)
         {
-            setColour(Label::backgroundColourId, Colours::grey.darker(0.7f));
+            setBackgroundColour(Colours::grey.darker(0.7f));
         }
     }
 }
@@ -27,12 +27,13 @@
 #define __OVERFLOW_METER_H__
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "numeric_label.h"
 
 
 //==============================================================================
 /**
 */
-class OverflowMeter : public Label
+class OverflowMeter : public NumericLabel
 {
 public:
     OverflowMeter(const String& componentName);
@@ -26,21 +26,14 @@
 #include "peak_label.h"
 
 
-PeakLabel::PeakLabel(const String& componentName, int nCrestFactor) : Label(componentName, "")
+PeakLabel::PeakLabel(const String& componentName, int nCrestFactor) : NumericLabel(componentName, 12.0f, Colours::white)
 {
     nMeterCrestFactor = nCrestFactor;
 
-    // this component does not have any transparent areas (increases
-    // performance on redrawing)
-    setOpaque(true);
-
     resetLevel();
 
-    setFont(12.0f);
-    setJustificationType(Justification::centredRight);
-    setColour(Label::backgroundColourId, Colours::grey.darker(0.7f));
-    setColour(Label::textColourId, Colours::white);
-    setColour(Label::outlineColourId, Colours::grey.darker(0.2f));
+    setBackgroundColour(Colours::grey.darker(0.7f));
+    setOutlineColour(Colours::grey.darker(0.2f));
 }
 
 
@@ -72,22 +65,16 @@ void PeakLabel::updateLevel(float newLevel)
     fMaximumLevel = newLevel;
     float fCorrectedLevel = fMaximumLevel + nMeterCrestFactor;
 
-    if (fCorrectedLevel < 0.0f)
-    {
-        setText(String(fCorrectedLevel, 1), dontSendNotification);
-    }
-    else
-    {
-        setText("+" + String(fCorrectedLevel, 1), dontSendNotification);
-    }
+    // positive levels are prefixed with a plus sign
+    setValue(fCorrectedLevel, 1, true);
 
     if (fMaximumLevel < -0.20f)
     {
-        setColour(Label::backgroundColourId, Colours::grey.darker(0.7f));
+        setBackgroundColour(Colours::grey.darker(0.7f));
     }
     else
     {
-        setColour(Label::backgroundColourId, Colours::red.darker(0.2f));
+        setBackgroundColour(Colours::red.darker(0.2f));
     }
 }
 
@@ -51,10 +51,46 @@ PhaseCorrelationMeter::~PhaseCorrelationMeter()
 
 
 void PhaseCorrelationMeter::paint(Graphics& g)
+{
+    // background is rendered in resized()
+    g.drawImageAt(imageBackground, 0, 0);
+
+    // needle is three pixels wide, with its sides partly transparent
+    Rectangle<int> rectNeedle = getNeedleBounds(nNeedlePosition);
+
+    if (bVerticalMeter)
+    {
+        rectNeedle.reduce(1, 0);
+    }
+    else
+    {
+        rectNeedle.reduce(0, 1);
+    }
+
+    g.setColour(Colours::red.withAlpha(0.6f));
+    g.fillRect(rectNeedle);
+
+    g.setColour(Colours::red);
+
+    if (bVerticalMeter)
+    {
+        g.fillRect(rectNeedle.getX(), nNeedlePosition, rectNeedle.getWidth(), 1);
+    }
+    else
+    {
+        g.fillRect(nNeedlePosition, rectNeedle.getY(), 1, rectNeedle.getHeight());
+    }
+}
+
+
+void PhaseCorrelationMeter::renderBackground()
 {
     int width = getWidth();
     int height = getHeight();
 
+    imageBackground = Image(Image::RGB, width, height, true);
+    Graphics g(imageBackground);
+
     if (bVerticalMeter)
     {
         int middle_of_meter = height / 2;
@@ -75,21 +111,6 @@ void PhaseCorrelationMeter::paint(Graphics& g)
         g.drawFittedText("-1", -1, 0, width_of_meter + 2, width_of_meter, Justification::centred, 1, 1.0f);
         g.drawFittedText("0", 0, middle_of_meter - width_of_meter / 2, width_of_meter, width_of_meter, Justification::centred, 1, 1.0f);
         g.drawFittedText("+1", -1, height - width, width_of_meter + 2, width_of_meter, Justification::centred, 1, 1.0f);
-
-        g.setColour(Colours::red);
-
-        for (int x = 1; x < (width_of_meter - 1); x++)
-        {
-            g.setPixel(x, nNeedlePosition);
-        }
-
-        g.setColour(Colours::red.withAlpha(0.6f));
-
-        for (int x = 1; x < (width_of_meter - 1); x++)
-        {
-            g.setPixel(x, nNeedlePosition - 1);
-            g.setPixel(x, nNeedlePosition + 1);
-        }
     }
     else
     {
@@ -111,21 +132,25 @@ void PhaseCorrelationMeter::paint(Graphics& g)
         g.drawFittedText("-1", 1, 0, height_of_meter + 2, height_of_meter, Justification::centred, 1, 1.0f);
         g.drawFittedText("0", middle_of_meter - height_of_meter / 2, 0, height_of_meter, height_of_meter, Justification::centred, 1, 1.0f);
         g.drawFittedText("+1", width - height - 4, 0, height_of_meter + 2, height_of_meter, Justification::centred, 1, 1.0f);
+    }
+}
 
-        g.setColour(Colours::red);
 
-        for (int y = 1; y < (height_of_meter - 1); y++)
-        {
-            g.setPixel(nNeedlePosition, y);
-        }
+Rectangle<int> PhaseCorrelationMeter::getNeedleBounds(int needle_position)
+/*  Get area covered by needle.
 
-        g.setColour(Colours::red.withAlpha(0.6f));
+    needle_position (integer): position of needle's centre
 
-        for (int y = 1; y < (height_of_meter - 1); y++)
-        {
-            g.setPixel(nNeedlePosition - 1, y);
-            g.setPixel(nNeedlePosition + 1, y);
-        }
+    return value (Rectangle<int>): area covered by needle
+*/
+{
+    if (bVerticalMeter)
+    {
+        return Rectangle<int>(0, needle_position - 1, getWidth(), 3);
+    }
+    else
+    {
+        return Rectangle<int>(needle_position - 1, 0, 3, getHeight());
     }
 }
 
@@ -140,6 +165,12 @@ void PhaseCorrelationMeter::resized()
     nHeight = rect.getHeight();
 
     bVerticalMeter = (nHeight > nWidth);
+
+    // background only changes with the meter's size
+    if ((nWidth > 0) && (nHeight > 0))
+    {
+        renderBackground();
+    }
 }
 
 
@@ -163,7 +194,9 @@ void PhaseCorrelationMeter::setValue(float newValue)
         return;
     }
 
-    repaint(getLocalBounds());
+    // only re-paint old and new needle
+    repaint(getNeedleBounds(nNeedlePositionOld));
+    repaint(getNeedleBounds(nNeedlePosition));
 }
 
 
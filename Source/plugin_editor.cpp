@@ -41,7 +41,6 @@ KmeterAudioProcessorEditor::KmeterAudioProcessorEditor(KmeterAudioProcessor* own
     bIsValidating = false;
 
     nInputChannels = nNumChannels;
-    nStereoInputChannels = (nNumChannels + (nNumChannels % 2)) / 2;
     nCrestFactor = 0;
 
     pSkin = new Skin(nInputChannels, nCrestFactor, -1, bHorizontalLayout);
@@ -49,6 +48,18 @@ KmeterAudioProcessorEditor::KmeterAudioProcessorEditor(KmeterAudioProcessor* own
     // The plug-in editor's size as well as the location of buttons
     // and labels will be set later on in this constructor.
 
+    // the meters are refreshed from a timer instead of every time the
+    // audio thread has processed a chunk; the frame rate is a plug-in
+    // parameter, but developers may override it by setting
+    // "KMETER_FRAME_RATE" to 15, 30 or 60
+    nFrameRateOverride = SystemStats::getEnvironmentVariable("KMETER_FRAME_RATE", "0").getIntValue();
+    nFrameRate = 30;
+
+    nFramesWithoutLevels = 0;
+    bLevelsChanged = false;
+    fStereoMeterValue = 0.0f;
+    fPhaseCorrelation = 1.0f;
+
     pProcessor = ownerFilter;
     pProcessor->addActionListener(this);
 
@@ -180,6 +191,20 @@ KmeterAudioProcessorEditor::KmeterAudioProcessorEditor(KmeterAudioProcessor* own
         phaseCorrelationMeter = NULL;
     }
 
+    // the processor only fills a goniometer buffer for stereo input
+    if (nInputChannels == 2)
+    {
+        goniometer = new Goniometer("Goniometer", nFrameRate);
+        addAndMakeVisible(goniometer);
+    }
+    else
+    {
+        goniometer = NULL;
+    }
+
+    spectrumMeter = new SpectrumMeter("Spectrum Meter");
+    addAndMakeVisible(spectrumMeter);
+
     pProcessor->addActionListenerParameters(this);
 
     kmeter = NULL;
@@ -205,6 +230,28 @@ KmeterAudioProcessorEditor::KmeterAudioProcessorEditor(KmeterAudioProcessor* own
     nIndex = KmeterPluginParameters::selMono;
     changeParameter(nIndex, pProcessor->getParameterAsInt(nIndex));
 
+    nIndex = KmeterPluginParameters::selFrameRate;
+    changeParameter(nIndex, pProcessor->getParameterAsInt(nIndex));
+
+#ifdef KMETER_OPENGL
+    // optionally render editor and meters using OpenGL (set
+    // "KMETER_OPENGL" to 1); JUCE's OpenGL renderer collects all
+    // rectangles and images of a frame into vertex buffers, and Mesa's
+    // software rasteriser (llvmpipe) can run it on machines without a
+    // GPU
+    if (SystemStats::getEnvironmentVariable("KMETER_OPENGL", "0").getIntValue() != 0)
+    {
+        pOpenGLContext = new OpenGLContext();
+        pOpenGLContext->setComponentPaintingEnabled(true);
+        pOpenGLContext->attachTo(*this);
+    }
+    // otherwise, fall back to software rendering
+    else
+    {
+        pOpenGLContext = NULL;
+    }
+#endif
+
     // force meter reload after initialisation ...
     bInitialising = false;
     bReloadMeters = true;
@@ -217,6 +264,18 @@ KmeterAudioProcessorEditor::KmeterAudioProcessorEditor(KmeterAudioProcessor* own
 
 KmeterAudioProcessorEditor::~KmeterAudioProcessorEditor()
 {
+    stopTimer();
+
+#ifdef KMETER_OPENGL
+    if (pOpenGLContext)
+    {
+        pOpenGLContext->detach();
+
+        delete pOpenGLContext;
+        pOpenGLContext = NULL;
+    }
+#endif
+
     pProcessor->removeActionListener(this);
     pProcessor->removeActionListenerParameters(this);
 
@@ -229,67 +288,15 @@ KmeterAudioProcessorEditor::~KmeterAudioProcessorEditor()
 
 void KmeterAudioProcessorEditor::resizeEditor()
 {
-    if (bHorizontalLayout)
-    {
-        if (nInputChannels <= 2)
-        {
-            nWidth = 680;
-            nButtonColumnTop = nStereoInputChannels * Kmeter::KMETER_STEREO_WIDTH + 24;
-        }
-        else
-        {
-            nWidth = 662;
+    // the skin calculates the layout for the current meter size
+    nWidth = pSkin->getWidth();
+    nHeight = pSkin->getHeight();
+    setSize(nWidth, nHeight);
 
-            if (pProcessor->getAverageAlgorithm() == KmeterPluginParameters::selAlgorithmItuBs1770)
-            {
-                nButtonColumnTop = Kmeter::KMETER_STEREO_WIDTH + 24;
-            }
-            else
-            {
-                nButtonColumnTop = nStereoInputChannels * (Kmeter::KMETER_STEREO_WIDTH + 6) + 18;
-            }
-        }
-
-        nButtonColumnLeft = 10;
-        nHeight = nButtonColumnTop + 56;
-        setSize(nWidth, nHeight);
-
-        if (nInputChannels <= 2)
-        {
-            stereoMeter->setBounds(28, 10, 13, 106);
-            phaseCorrelationMeter->setBounds(10, 10, 13, 106);
-        }
-    }
-    else
+    if (nInputChannels <= 2)
     {
-        if (nInputChannels <= 2)
-        {
-            nHeight = 648;
-            nButtonColumnLeft = nStereoInputChannels * Kmeter::KMETER_STEREO_WIDTH + 24;
-        }
-        else
-        {
-            nHeight = 630;
-
-            if (pProcessor->getAverageAlgorithm() == KmeterPluginParameters::selAlgorithmItuBs1770)
-            {
-                nButtonColumnLeft = Kmeter::KMETER_STEREO_WIDTH + 24;
-            }
-            else
-            {
-                nButtonColumnLeft = nStereoInputChannels * (Kmeter::KMETER_STEREO_WIDTH + 6) + 18;
-            }
-        }
-
-        nButtonColumnTop = 10;
-        nWidth = nButtonColumnLeft + 70;
-        setSize(nWidth, nHeight);
-
-        if (nInputChannels <= 2)
-        {
-            stereoMeter->setBounds(10, nHeight - 41, 106, 13);
-            phaseCorrelationMeter->setBounds(10, nHeight - 24, 106, 13);
-        }
+        pSkin->placeButton(Skin::MeterStereo, stereoMeter);
+        pSkin->placeButton(Skin::MeterPhaseCorrelation, phaseCorrelationMeter);
     }
 
     pSkin->placeButton(Skin::ButtonK20, ButtonK20);
@@ -315,6 +322,18 @@ void KmeterAudioProcessorEditor::resizeEditor()
     {
         pSkin->placeButton(Skin::LabelDebug, LabelDebug);
     }
+
+    if (kmeter)
+    {
+        pSkin->placeButton(Skin::MeterKmeter, kmeter);
+    }
+
+    if (goniometer)
+    {
+        pSkin->placeButton(Skin::MeterGoniometer, goniometer);
+    }
+
+    pSkin->placeButton(Skin::MeterSpectrum, spectrumMeter);
 }
 
 
@@ -334,31 +353,22 @@ void KmeterAudioProcessorEditor::actionListenerCallback(const String& message)
     // "UM" --> update meters
     else if (!message.compare("UM"))
     {
-        MeterBallistics* pMeterBallistics = pProcessor->getLevels();
+        // meters are updated on the next frame
+        bLevelsChanged = true;
 
-        if (pMeterBallistics)
+        // the refresh timer has been stopped during silence, so only
+        // restart it when there is something to show; when it has
+        // been stopped because no levels arrived, the meters may
+        // still show old levels and need to be refreshed
+        if (!isTimerRunning())
         {
-            if (kmeter)
-            {
-                kmeter->setLevels(pMeterBallistics);
-            }
-
-            if (stereoMeter)
-            {
-                stereoMeter->setValue(pMeterBallistics->getStereoMeterValue());
-            }
+            MeterBallistics* pMeterBallistics = pProcessor->getLevels();
 
-            if (phaseCorrelationMeter)
+            if (pMeterBallistics && (!isSilent(pMeterBallistics) || (nFramesWithoutLevels > 0)))
             {
-                phaseCorrelationMeter->setValue(pMeterBallistics->getPhaseCorrelation());
+                resumeRefresh();
             }
         }
-
-        if (bIsValidating && !pProcessor->isValidating())
-        {
-            bIsValidating = false;
-            ButtonValidation->setColour(TextButton::buttonColourId, Colours::grey);
-        }
     }
     // "AC" --> algorithm changed
     else if (!message.compare("AC"))
@@ -374,7 +384,8 @@ void KmeterAudioProcessorEditor::actionListenerCallback(const String& message)
     // "V-" --> validation stopped
     else if (!message.compare("V-"))
     {
-        // do nothing till you hear from me... :)
+        bIsValidating = false;
+        ButtonValidation->setColour(TextButton::buttonColourId, Colours::grey);
     }
     else
     {
@@ -383,6 +394,117 @@ void KmeterAudioProcessorEditor::actionListenerCallback(const String& message)
 }
 
 
+void KmeterAudioProcessorEditor::timerCallback()
+{
+    // the goniometer fades out old points on every frame
+    if (goniometer)
+    {
+        goniometer->update(pProcessor->getGoniometerBuffer());
+    }
+
+    // nothing has been processed since the last frame (such as when
+    // the host's transport has been stopped)
+    if (!bLevelsChanged)
+    {
+        nFramesWithoutLevels++;
+
+        // stop refreshing after one second without levels, but let
+        // the goniometer fade out first
+        if ((nFramesWithoutLevels >= nFrameRate) && ((goniometer == NULL) || goniometer->isDark()))
+        {
+            stopTimer();
+        }
+
+        return;
+    }
+
+    bLevelsChanged = false;
+    nFramesWithoutLevels = 0;
+    MeterBallistics* pMeterBallistics = pProcessor->getLevels();
+
+    if (pMeterBallistics)
+    {
+        if (kmeter)
+        {
+            kmeter->setLevels(pMeterBallistics);
+        }
+
+        if (stereoMeter)
+        {
+            stereoMeter->setValue(pMeterBallistics->getStereoMeterValue());
+        }
+
+        if (phaseCorrelationMeter)
+        {
+            phaseCorrelationMeter->setValue(pMeterBallistics->getPhaseCorrelation());
+        }
+
+        spectrumMeter->update(pProcessor->getSpectrum());
+
+        // stop refreshing altogether once all meters have fallen to
+        // their floor and nothing else has changed since the last
+        // frame
+        if (isSilent(pMeterBallistics) && spectrumMeter->isOnFloor() && ((goniometer == NULL) || goniometer->isDark()))
+        {
+            stopTimer();
+        }
+
+        fStereoMeterValue = pMeterBallistics->getStereoMeterValue();
+        fPhaseCorrelation = pMeterBallistics->getPhaseCorrelation();
+    }
+}
+
+
+void KmeterAudioProcessorEditor::resumeRefresh()
+/*  Refresh meters on next frame and (re-)start refresh timer.
+
+    return value: none
+*/
+{
+    bLevelsChanged = true;
+
+    if (!isTimerRunning())
+    {
+        startTimer(1000 / nFrameRate);
+    }
+}
+
+
+bool KmeterAudioProcessorEditor::isSilent(MeterBallistics* pMeterBallistics)
+/*  Check whether displaying the current levels would not change any
+    meter, so that refreshing can stop during silence.
+
+    pMeterBallistics (MeterBallistics*): current meter levels
+
+    return value (Boolean): true if all levels lie on the meter's
+    floor and stereo meter and phase correlation meter have not
+    changed since the last frame
+*/
+{
+    float fMeterMinimumDecibel = MeterBallistics::getMeterMinimumDecibel();
+
+    for (int nChannel = 0; nChannel < pMeterBallistics->getNumberOfChannels(); nChannel++)
+    {
+        if ((pMeterBallistics->getPeakMeterLevel(nChannel) > fMeterMinimumDecibel) || (pMeterBallistics->getAverageMeterLevel(nChannel) > fMeterMinimumDecibel))
+        {
+            return false;
+        }
+
+        if ((pMeterBallistics->getPeakMeterPeakLevel(nChannel) > fMeterMinimumDecibel) || (pMeterBallistics->getAverageMeterPeakLevel(nChannel) > fMeterMinimumDecibel))
+        {
+            return false;
+        }
+    }
+
+    if ((pMeterBallistics->getStereoMeterValue() != fStereoMeterValue) || (pMeterBallistics->getPhaseCorrelation() != fPhaseCorrelation))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
 void KmeterAudioProcessorEditor::changeParameter(int nIndex)
 {
     if (pProcessor->isParameterMarked(nIndex))
@@ -450,6 +572,8 @@ void KmeterAudioProcessorEditor::changeParameter(int nIndex, int nValue)
 
         if (nInputChannels > 2)
         {
+            // the layout of surround meters depends on the algorithm
+            pSkin->updateSkin(nInputChannels, nCrestFactor, pProcessor->getAverageAlgorithm(), bHorizontalLayout);
             resizeEditor();
         }
 
@@ -490,6 +614,27 @@ void KmeterAudioProcessorEditor::changeParameter(int nIndex, int nValue)
     case KmeterPluginParameters::selMono:
         ButtonMono->setToggleState(nValue != 0, dontSendNotification);
         break;
+
+    case KmeterPluginParameters::selFrameRate:
+        nFrameRate = (nFrameRateOverride > 0) ? nFrameRateOverride : nValue;
+
+        if ((nFrameRate != 15) && (nFrameRate != 60))
+        {
+            nFrameRate = 30;
+        }
+
+        if (goniometer)
+        {
+            goniometer->setFrameRate(nFrameRate);
+        }
+
+        // apply new frame rate to running timer
+        if (isTimerRunning())
+        {
+            startTimer(1000 / nFrameRate);
+        }
+
+        break;
     }
 
     // prevent meter reload during initialisation
@@ -527,14 +672,7 @@ void KmeterAudioProcessorEditor::reloadMeters()
                 strUnit = String("LK");
             }
 
-            if (bHorizontalLayout)
-            {
-                kmeter = new Kmeter("K-Meter", 48, 10, nCrestFactor, 1, strUnit, isSurround, ButtonExpanded->getToggleState(), true, ButtonDisplayPeakMeter->getToggleState(), 4);
-            }
-            else
-            {
-                kmeter = new Kmeter("K-Meter", 10, 10, nCrestFactor, 1, strUnit, isSurround, ButtonExpanded->getToggleState(), false, ButtonDisplayPeakMeter->getToggleState(), 4);
-            }
+            kmeter = new Kmeter("K-Meter", nCrestFactor, 1, strUnit, isSurround, ButtonExpanded->getToggleState(), bHorizontalLayout, ButtonDisplayPeakMeter->getToggleState(), pSkin->getSegmentHeight());
         }
         else
         {
@@ -549,17 +687,14 @@ void KmeterAudioProcessorEditor::reloadMeters()
                 strUnit = String("dB");
             }
 
-            if (bHorizontalLayout)
-            {
-                kmeter = new Kmeter("K-Meter", 48, 10, nCrestFactor, nInputChannels, strUnit, isSurround, ButtonExpanded->getToggleState(), true, ButtonDisplayPeakMeter->getToggleState(), 4);
-            }
-            else
-            {
-                kmeter = new Kmeter("K-Meter", 10, 10, nCrestFactor, nInputChannels, strUnit, isSurround, ButtonExpanded->getToggleState(), false, ButtonDisplayPeakMeter->getToggleState(), 4);
-            }
+            kmeter = new Kmeter("K-Meter", nCrestFactor, nInputChannels, strUnit, isSurround, ButtonExpanded->getToggleState(), bHorizontalLayout, ButtonDisplayPeakMeter->getToggleState(), pSkin->getSegmentHeight());
         }
 
         addAndMakeVisible(kmeter);
+        pSkin->placeButton(Skin::MeterKmeter, kmeter);
+
+        // show current levels on re-loaded meters
+        resumeRefresh();
     }
 }
 
@@ -620,6 +755,9 @@ void KmeterAudioProcessorEditor::buttonClicked(Button* button)
         {
             pMeterBallistics->reset();
         }
+
+        // show reset levels even when the meters are idle
+        resumeRefresh();
     }
     else if (button == ButtonMono)
     {
@@ -677,6 +815,30 @@ void KmeterAudioProcessorEditor::updateAverageAlgorithm(bool reload_meters)
 
 void KmeterAudioProcessorEditor::resized()
 {
+    // the editor sets its own size while it is being set up
+    if (bInitialising)
+    {
+        return;
+    }
+
+    // meters only grow by whole pixels per segment, so meters and
+    // their cached images are only re-created when the segment height
+    // changes
+    int nSegmentHeight = pSkin->getSegmentHeightForSize(getWidth(), getHeight());
+
+    if (nSegmentHeight != pSkin->getSegmentHeight())
+    {
+        pSkin->setSegmentHeight(nSegmentHeight);
+
+        bReloadMeters = true;
+        reloadMeters();
+    }
+
+    // snap editor to the size of the new layout
+    if ((getWidth() != pSkin->getWidth()) || (getHeight() != pSkin->getHeight()))
+    {
+        resizeEditor();
+    }
 }
 
 
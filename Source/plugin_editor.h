@@ -28,8 +28,10 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "plugin_processor.h"
+#include "goniometer.h"
 #include "kmeter.h"
 #include "skin.h"
+#include "spectrum_meter.h"
 #include "stereo_meter.h"
 #include "phase_correlation_meter.h"
 #include "window_about.h"
@@ -39,7 +41,7 @@
 //==============================================================================
 /**
 */
-class KmeterAudioProcessorEditor : public AudioProcessorEditor, public ButtonListener, public ActionListener
+class KmeterAudioProcessorEditor : public AudioProcessorEditor, public ButtonListener, public ActionListener, public Timer
 {
 public:
     KmeterAudioProcessorEditor(KmeterAudioProcessor* ownerFilter, int nNumChannels);
@@ -49,6 +51,7 @@ public:
     void actionListenerCallback(const String& message);
     void changeParameter(int nIndex);
     void changeParameter(int nIndex, int nValue);
+    void timerCallback();
 
     //==============================================================================
     // This is just a standard Juce paint method...
@@ -62,25 +65,40 @@ private:
     void resizeEditor();
     void updateAverageAlgorithm(bool reload_meters);
 
+    void resumeRefresh();
+    bool isSilent(MeterBallistics* pMeterBallistics);
+
     bool bReloadMeters;
     bool bHorizontalLayout;
     bool bIsValidating;
     bool bInitialising;
 
+    // meters are refreshed at most "nFrameRate" times per second and
+    // only when new levels have arrived
+    int nFrameRate;
+    int nFrameRateOverride;
+    int nFramesWithoutLevels;
+    bool bLevelsChanged;
+    float fStereoMeterValue;
+    float fPhaseCorrelation;
+
     int nCrestFactor;
     int nInputChannels;
-    int nStereoInputChannels;
-    int nButtonColumnLeft;
-    int nButtonColumnTop;
     int nHeight;
     int nWidth;
 
     Skin* pSkin;
 
+#ifdef KMETER_OPENGL
+    OpenGLContext* pOpenGLContext;
+#endif
+
     KmeterAudioProcessor* pProcessor;
     Kmeter* kmeter;
     StereoMeter* stereoMeter;
     PhaseCorrelationMeter* phaseCorrelationMeter;
+    Goniometer* goniometer;
+    SpectrumMeter* spectrumMeter;
 
     TextButton* ButtonNormal;
     TextButton* ButtonK12;
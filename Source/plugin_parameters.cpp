@@ -43,6 +43,12 @@ KmeterPluginParameters::KmeterPluginParameters()
     nParam[selInfiniteHold] = 0;
     nParam[selMono] = 0;
 
+    // meters are refreshed 30 times per second by default
+    nParam[selFrameRate] = 30;
+
+    // long-term level logging is switched off by default
+    nParam[selLevelLog] = 0;
+
     nParam[selValidationSelectedChannel] = -1;
     nParam[selValidationAverageMeterLevel] = 1;
     nParam[selValidationPeakMeterLevel] = 1;
@@ -51,6 +57,8 @@ KmeterPluginParameters::KmeterPluginParameters()
     nParam[selValidationPhaseCorrelation] = 1;
 
     nParam[selValidationCSVFormat] = 0;
+    nParam[selValidationBinaryLog] = 0;
+    nParam[selValidationRenderOffline] = 0;
 
     strValidationFile = String::empty;
 
@@ -139,6 +147,17 @@ void KmeterPluginParameters::setParameterFromInt(int nIndex, int nValue)
                 nParam[nIndex] = 20;
             }
         }
+        else if (nIndex == selFrameRate)
+        {
+            if ((nValue == 15) || (nValue == 60))
+            {
+                nParam[nIndex] = nValue;
+            }
+            else
+            {
+                nParam[nIndex] = 30;
+            }
+        }
         else if (nIndex == selValidationSelectedChannel)
         {
             nParam[nIndex] = nValue;
@@ -236,6 +255,14 @@ const String KmeterPluginParameters::getParameterName(int nIndex)
         return "Mono Input";
         break;
 
+    case selFrameRate:
+        return "Frame Rate";
+        break;
+
+    case selLevelLog:
+        return "Level Log";
+        break;
+
     case selValidationFileName:
         return "Validation: file name";
         break;
@@ -268,6 +295,14 @@ const String KmeterPluginParameters::getParameterName(int nIndex)
         return "Validation: CSV output format";
         break;
 
+    case selValidationBinaryLog:
+        return "Validation: binary log";
+        break;
+
+    case selValidationRenderOffline:
+        return "Validation: render offline";
+        break;
+
     default:
         return "invalid";
         break;
@@ -320,6 +355,10 @@ const String KmeterPluginParameters::getParameterText(int nIndex)
             return "Vertical";
         }
     }
+    else if (nIndex == selFrameRate)
+    {
+        return String(nParam[nIndex]) + " fps";
+    }
     else if (nIndex == selValidationFileName)
     {
         File fileValidation = File(strValidationFile);
@@ -382,6 +421,24 @@ float KmeterPluginParameters::translateParameterToFloat(int nIndex, int nValue)
     {
         return (float) nValue;
     }
+    else if (nIndex == selFrameRate)
+    {
+        // 0.0f: 15 fps
+        // 0.5f: 30 fps
+        // 1.0f: 60 fps
+        if (nValue <= 15)
+        {
+            return 0.0f;
+        }
+        else if (nValue <= 30)
+        {
+            return 0.5f;
+        }
+        else
+        {
+            return 1.0f;
+        }
+    }
     else if (nIndex == selValidationSelectedChannel)
     {
         // 0.00f: dump all channels
@@ -431,6 +488,21 @@ int KmeterPluginParameters::translateParameterToInt(int nIndex, float fValue)
         int nRoundedValue = int(fValue + 0.5f);
         return nRoundedValue;
     }
+    else if (nIndex == selFrameRate)
+    {
+        if (fValue < 0.25f)
+        {
+            return 15;
+        }
+        else if (fValue < 0.75f)
+        {
+            return 30;
+        }
+        else
+        {
+            return 60;
+        }
+    }
     else if (nIndex == selValidationSelectedChannel)
     {
         // 0.00f: dump all channels
@@ -471,6 +543,8 @@ XmlElement KmeterPluginParameters::storeAsXml()
     xml.setAttribute("Peak", getParameterAsInt(selPeak));
     xml.setAttribute("Hold", getParameterAsInt(selInfiniteHold));
     xml.setAttribute("Mono", getParameterAsInt(selMono));
+    xml.setAttribute("FrameRate", getParameterAsInt(selFrameRate));
+    xml.setAttribute("LevelLog", getParameterAsInt(selLevelLog));
 
     xml.setAttribute("ValidationFile", strValidationFile);
     xml.setAttribute("ValidationSelectedChannel", getParameterAsInt(selValidationSelectedChannel));
@@ -480,6 +554,8 @@ XmlElement KmeterPluginParameters::storeAsXml()
     xml.setAttribute("ValidationStereoMeterValue", getParameterAsInt(selValidationStereoMeterValue));
     xml.setAttribute("ValidationPhaseCorrelation", getParameterAsInt(selValidationPhaseCorrelation));
     xml.setAttribute("ValidationCSVFormat", getParameterAsInt(selValidationCSVFormat));
+    xml.setAttribute("ValidationBinaryLog", getParameterAsInt(selValidationBinaryLog));
+    xml.setAttribute("ValidationRenderOffline", getParameterAsInt(selValidationRenderOffline));
 
     return xml;
 }
@@ -517,6 +593,8 @@ void KmeterPluginParameters::loadFromXml(XmlElement* xml)
         setParameterFromInt(selPeak, xml->getIntAttribute("Peak", getParameterAsInt(selPeak)));
         setParameterFromInt(selInfiniteHold, xml->getIntAttribute("Hold", getParameterAsInt(selInfiniteHold)));
         setParameterFromInt(selMono, xml->getIntAttribute("Mono", getParameterAsInt(selMono)));
+        setParameterFromInt(selFrameRate, xml->getIntAttribute("FrameRate", getParameterAsInt(selFrameRate)));
+        setParameterFromInt(selLevelLog, xml->getIntAttribute("LevelLog", getParameterAsInt(selLevelLog)));
 
         File fileValidation = File(xml->getStringAttribute("ValidationFile", strValidationFile));
         setValidationFile(fileValidation);
@@ -528,6 +606,8 @@ void KmeterPluginParameters::loadFromXml(XmlElement* xml)
         setParameterFromInt(selValidationStereoMeterValue, xml->getIntAttribute("ValidationStereoMeterValue", getParameterAsInt(selValidationStereoMeterValue)));
         setParameterFromInt(selValidationPhaseCorrelation, xml->getIntAttribute("ValidationPhaseCorrelation", getParameterAsInt(selValidationPhaseCorrelation)));
         setParameterFromInt(selValidationCSVFormat, xml->getIntAttribute("ValidationCSVFormat", getParameterAsInt(selValidationCSVFormat)));
+        setParameterFromInt(selValidationBinaryLog, xml->getIntAttribute("ValidationBinaryLog", getParameterAsInt(selValidationBinaryLog)));
+        setParameterFromInt(selValidationRenderOffline, xml->getIntAttribute("ValidationRenderOffline", getParameterAsInt(selValidationRenderOffline)));
     }
 }
 
@@ -74,6 +74,8 @@ public:
         selPeak,
         selInfiniteHold,
         selMono,
+        selFrameRate,
+        selLevelLog,
 
         nNumParametersRevealed,
 
@@ -85,6 +87,8 @@ public:
         selValidationStereoMeterValue,
         selValidationPhaseCorrelation,
         selValidationCSVFormat,
+        selValidationBinaryLog,
+        selValidationRenderOffline,
 
         nNumParameters,
 
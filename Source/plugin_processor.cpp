@@ -39,34 +39,36 @@ KmeterAudioProcessor::KmeterAudioProcessor()
 
     bSampleRateIsValid = false;
     audioFilePlayer = NULL;
+    audioFileRenderer = NULL;
 
     pRingBufferInput = NULL;
     pRingBufferOutput = NULL;
 
     nNumInputChannels = 0;
-    pMeterBallistics = NULL;
+    pMeterAnalyser = NULL;
+    pLevelLogger = NULL;
+    pGoniometerBuffer = NULL;
+    pSpectrum = NULL;
+
+    pPeakLevelHistory = NULL;
+    pAverageLevelHistory = NULL;
 
     setLatencySamples(KMETER_BUFFER_SIZE);
 
-    pAverageLevelFiltered = NULL;
     pPluginParameters = new KmeterPluginParameters();
 
+    // the level logger is started and stopped on the message thread
+    pPluginParameters->addActionListener(this);
+
     // depends on "KmeterPluginParameters"!
     nAverageAlgorithm = getParameterAsInt(KmeterPluginParameters::selAverageAlgorithm);
-
-    fProcessedSeconds = 0.0f;
-
-    fPeakLevels = NULL;
-    fRmsLevels = NULL;
-    fAverageLevelsFiltered = NULL;
-
-    nOverflows = NULL;
 }
 
 
 KmeterAudioProcessor::~KmeterAudioProcessor()
 {
     removeAllActionListeners();
+    pPluginParameters->removeActionListener(this);
 
     // call function "releaseResources()" by force to make sure all
     // allocated memory is freed
@@ -77,6 +79,9 @@ KmeterAudioProcessor::~KmeterAudioProcessor()
 
     delete audioFilePlayer;
     audioFilePlayer = NULL;
+
+    delete audioFileRenderer;
+    audioFileRenderer = NULL;
 }
 
 
@@ -92,6 +97,22 @@ void KmeterAudioProcessor::removeActionListenerParameters(ActionListener* listen
 }
 
 
+void KmeterAudioProcessor::actionListenerCallback(const String& message)
+{
+    // "PC" --> parameter changed, followed by a hash and the
+    // parameter's ID
+    if (message.startsWith("PC#"))
+    {
+        int nIndex = message.substring(3).getIntValue();
+
+        if (nIndex == KmeterPluginParameters::selLevelLog)
+        {
+            updateLevelLogger(false);
+        }
+    }
+}
+
+
 //==============================================================================
 
 const String KmeterAudioProcessor::getName() const
@@ -218,7 +239,9 @@ void KmeterAudioProcessor::changeParameter(int index, int nValue)
     }
     else if (index == KmeterPluginParameters::selCrestFactor)
     {
-        if (isValidating())
+        // offline validation uses the crest factor it was started
+        // with
+        if (isValidating() && audioFilePlayer)
         {
             audioFilePlayer->setCrestFactor(nValue);
         }
@@ -376,24 +399,17 @@ void KmeterAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
     isStereo = (nNumInputChannels == 2);
     DBG("[K-Meter] number of input channels: " + String(nNumInputChannels));
 
-    pMeterBallistics = new MeterBallistics(nNumInputChannels, nAverageAlgorithm, false, false);
+    pMeterAnalyser = new MeterAnalyser(nNumInputChannels, KMETER_BUFFER_SIZE, (int) sampleRate, nAverageAlgorithm);
+    setAverageAlgorithmFinal(pMeterAnalyser->getAverageAlgorithm());
 
-    fPeakLevels = new float[nNumInputChannels];
-    fRmsLevels = new float[nNumInputChannels];
-    fAverageLevelsFiltered = new float[nNumInputChannels];
+    // small host buffers would make every n-th audio callback process
+    // a whole chunk, so spread the work over all callbacks
+    pMeterAnalyser->setIncremental((samplesPerBlock < KMETER_BUFFER_SIZE) && !DEBUG_FILTER);
 
-    nOverflows = new int[nNumInputChannels];
-
-    for (int nChannel = 0; nChannel < nNumInputChannels; nChannel++)
-    {
-        fPeakLevels[nChannel] = 0.0f;
-        fRmsLevels[nChannel] = 0.0f;
-        fAverageLevelsFiltered[nChannel] = MeterBallistics::getMeterMinimumDecibel();
-
-        nOverflows[nChannel] = 0;
-    }
-
-    pAverageLevelFiltered = new AverageLevelFiltered(this, nNumInputChannels, KMETER_BUFFER_SIZE, (int) sampleRate, nAverageAlgorithm);
+    // the spectrum analyser re-uses the DFTs of the average level
+    // filter, so it costs next to nothing
+    pSpectrum = new Spectrum(nNumInputChannels, KMETER_BUFFER_SIZE, (int) sampleRate);
+    pMeterAnalyser->setSpectrum(pSpectrum);
 
     // make sure that ring buffer can hold at least KMETER_BUFFER_SIZE
     // samples and is large enough to receive a full block of audio
@@ -404,6 +420,81 @@ void KmeterAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
     pRingBufferInput->setCallbackClass(this);
 
     pRingBufferOutput = new AudioRingBuffer("Output ring buffer", nNumInputChannels, uRingBufferSize, KMETER_BUFFER_SIZE, KMETER_BUFFER_SIZE);
+
+    // keep level history for about 16 days (at 48 kHz) in eight
+    // resolutions from 21 ms to 6 minutes; this takes about 400 kB
+    // per history
+    double dSecondsPerChunk = KMETER_BUFFER_SIZE / sampleRate;
+
+    pPeakLevelHistory = new LevelHistory(dSecondsPerChunk, 8, 4096, 4);
+    pAverageLevelHistory = new LevelHistory(dSecondsPerChunk, 8, 4096, 4);
+
+    // the goniometer is only shown for stereo audio
+    if (isStereo)
+    {
+        pGoniometerBuffer = new GoniometerBuffer((int) sampleRate);
+    }
+
+    // logging restarts with the current sample rate and number of
+    // channels
+    updateLevelLogger(true);
+}
+
+
+void KmeterAudioProcessor::updateLevelLogger(const bool restart)
+/*  Start or stop unattended long-term logging (e.g. for broadcast
+    compliance) according to the "Level Log" parameter.  Log files
+    are written to "K-Meter logs" in the user's documents directory;
+    developers may point "KMETER_LEVEL_LOG" to another directory.  A
+    new log file is started every hour or 16 MB, and files are kept
+    for a week.
+
+    restart (Boolean): start a new logger even if one is running
+
+    return value: none
+*/
+{
+    // the logger is started once audio processing has been prepared
+    if (!bSampleRateIsValid || (pMeterAnalyser == NULL))
+    {
+        return;
+    }
+
+    bool bLevelLog = getParameterAsBool(KmeterPluginParameters::selLevelLog);
+
+    if ((bLevelLog == (pLevelLogger != NULL)) && !restart)
+    {
+        return;
+    }
+
+    LevelLogger* pLevelLoggerNew = NULL;
+
+    if (bLevelLog)
+    {
+        File directoryLog = File::getSpecialLocation(File::userDocumentsDirectory).getChildFile("K-Meter logs");
+        String strLogDirectory = SystemStats::getEnvironmentVariable("KMETER_LEVEL_LOG", String::empty);
+
+        if (strLogDirectory.isNotEmpty())
+        {
+            directoryLog = File::getCurrentWorkingDirectory().getChildFile(strLogDirectory);
+        }
+
+        pLevelLoggerNew = new LevelLogger(directoryLog, nNumInputChannels, (int) getSampleRate(), KMETER_BUFFER_SIZE, 3600, 16 * 1024 * 1024, 24 * 7);
+    }
+
+    LevelLogger* pLevelLoggerOld = NULL;
+
+    // swap loggers between audio callbacks
+    {
+        const ScopedLock sl(getCallbackLock());
+
+        pLevelLoggerOld = pLevelLogger;
+        pLevelLogger = pLevelLoggerNew;
+    }
+
+    // writes remaining readings to disk
+    delete pLevelLoggerOld;
+    pLevelLoggerOld = NULL;
 }
 
 
@@ -419,32 +510,36 @@ void KmeterAudioProcessor::releaseResources()
         return;
     }
 
-    delete pAverageLevelFiltered;
-    pAverageLevelFiltered = NULL;
+    // writes remaining readings to disk
+    delete pLevelLogger;
+    pLevelLogger = NULL;
 
-    delete pMeterBallistics;
-    pMeterBallistics = NULL;
+    delete pGoniometerBuffer;
+    pGoniometerBuffer = NULL;
 
-    delete pRingBufferOutput;
-    pRingBufferOutput = NULL;
+    delete pPeakLevelHistory;
+    pPeakLevelHistory = NULL;
 
-    delete pRingBufferInput;
-    pRingBufferInput = NULL;
+    delete pAverageLevelHistory;
+    pAverageLevelHistory = NULL;
 
-    delete [] fPeakLevels;
-    fPeakLevels = NULL;
+    delete pMeterAnalyser;
+    pMeterAnalyser = NULL;
 
-    delete [] fRmsLevels;
-    fRmsLevels = NULL;
+    delete pSpectrum;
+    pSpectrum = NULL;
 
-    delete [] fAverageLevelsFiltered;
-    fAverageLevelsFiltered = NULL;
+    delete pRingBufferOutput;
+    pRingBufferOutput = NULL;
 
-    delete [] nOverflows;
-    nOverflows = NULL;
+    delete pRingBufferInput;
+    pRingBufferInput = NULL;
 
     delete audioFilePlayer;
     audioFilePlayer = NULL;
+
+    delete audioFileRenderer;
+    audioFileRenderer = NULL;
 }
 
 
@@ -492,6 +587,13 @@ void KmeterAudioProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& m
     if (audioFilePlayer)
     {
         audioFilePlayer->fillBufferChunk(&buffer);
+
+        // the player must not be deleted on the audio thread, so let
+        // the message thread stop validation
+        if (!audioFilePlayer->isPlaying())
+        {
+            triggerAsyncUpdate();
+        }
     }
 
     bool bMono = getParameterAsBool(KmeterPluginParameters::selMono);
@@ -509,6 +611,11 @@ void KmeterAudioProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& m
         }
     }
 
+    if (pGoniometerBuffer)
+    {
+        pGoniometerBuffer->addSamples(buffer, 0, nNumSamples);
+    }
+
     pRingBufferInput->addSamples(buffer, 0, nNumSamples);
 
     nSamplesInBuffer += nNumSamples;
@@ -520,113 +627,34 @@ void KmeterAudioProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& m
 
 void KmeterAudioProcessor::processBufferChunk(AudioSampleBuffer& buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples)
 {
-    unsigned int uPreDelay = uChunkSize / 2;
     bool bMono = getParameterAsBool(KmeterPluginParameters::selMono);
 
-    // length of buffer chunk in fractional seconds
-    // (1024 samples / 44100 samples/s = 23.2 ms)
-    fProcessedSeconds = (float) uChunkSize / (float) getSampleRate();
-
-    // copy ring buffer to determine average level (FIR filter already
-    // adds delay of (uChunkSize / 2) samples)
-    pAverageLevelFiltered->copyFromBuffer(*pRingBufferInput, 0, (int) getSampleRate());
+    // determine levels and apply meter ballistics
+    pMeterAnalyser->processBufferChunk(*pRingBufferInput, uChunkSize, bMono);
 
-    for (int nChannel = 0; nChannel < nNumInputChannels; nChannel++)
+    if (pLevelLogger)
     {
-        if (bMono && (nChannel == 1))
-        {
-            fPeakLevels[nChannel] = fPeakLevels[0];
-            fRmsLevels[nChannel] = fRmsLevels[0];
-            fAverageLevelsFiltered[nChannel] = fAverageLevelsFiltered[0];
-            nOverflows[nChannel] = nOverflows[0];
-        }
-        else
-        {
-            // determine peak level for uChunkSize samples (use pre-delay)
-            fPeakLevels[nChannel] = pRingBufferInput->getMagnitude(nChannel, uChunkSize, uPreDelay);
-
-            // determine peak level for uChunkSize samples (use pre-delay)
-            fRmsLevels[nChannel] = pRingBufferInput->getRMSLevel(nChannel, uChunkSize, uPreDelay);
-
-            // determine filtered average level for uChunkSize samples
-            // (please note that this level has already been converted
-            // to decibels!)
-            fAverageLevelsFiltered[nChannel] = pAverageLevelFiltered->getLevel(nChannel);
-
-            // determine overflows for uChunkSize samples (use pre-delay)
-            nOverflows[nChannel] = countOverflows(pRingBufferInput, nChannel, uChunkSize, uPreDelay);
-        }
-
-        // apply meter ballistics and store values so that the editor
-        // can access them
-        pMeterBallistics->updateChannel(nChannel, fProcessedSeconds, fPeakLevels[nChannel], fRmsLevels[nChannel], fAverageLevelsFiltered[nChannel], nOverflows[nChannel]);
+        pLevelLogger->processBufferChunk(*pMeterAnalyser, *pRingBufferInput, uChunkSize);
     }
 
-    // phase correlation is only defined for stereo signals
-    if (isStereo)
-    {
-        float fPhaseCorrelation = 1.0f;
+    // in ITU-R BS.1770 mode, the first channel holds the loudness of
+    // all channels
+    float fPeakLevel = 0.0f;
+    float fAverageLevel = pMeterAnalyser->getAverageLevel(0);
 
-        // check whether the stereo signal has been mixed down to mono
-        if (bMono)
-        {
-            fPhaseCorrelation = 1.0f;
-        }
-        // otherwise, process only levels at or above -80 dB
-        else if ((fRmsLevels[0] >= 0.0001f) || (fRmsLevels[1] >= 0.0001f))
-        {
-            float sum_of_product = 0.0f;
-            float sum_of_squares_left = 0.0f;
-            float sum_of_squares_right = 0.0f;
-
-            // determine correlation for uChunkSize samples (use pre-delay)
-            for (unsigned int uSample = 0; uSample < uChunkSize; uSample++)
-            {
-                float ringbuffer_left = pRingBufferInput->getSample(0, uSample, uPreDelay);
-                float ringbuffer_right = pRingBufferInput->getSample(1, uSample, uPreDelay);
-
-                sum_of_product += ringbuffer_left * ringbuffer_right;
-                sum_of_squares_left += ringbuffer_left * ringbuffer_left;
-                sum_of_squares_right += ringbuffer_right * ringbuffer_right;
-            }
-
-            float fSumsOfSquares = sum_of_squares_left * sum_of_squares_right;
-
-            // prevent division by zero and taking the square root of
-            // a negative number
-            if (fSumsOfSquares > 0.0f)
-            {
-                fPhaseCorrelation = sum_of_product / sqrt(fSumsOfSquares);
-            }
-            else
-            {
-                // this is mathematically incorrect, but "musically"
-                // correct (i.e. signal is mono-compatible)
-                fPhaseCorrelation = 1.0f;
-            }
-        }
-
-        pMeterBallistics->setPhaseCorrelation(fProcessedSeconds, fPhaseCorrelation);
-
-        float fStereoMeterValue = 0.0f;
+    for (int nChannel = 0; nChannel < nNumInputChannels; nChannel++)
+    {
+        fPeakLevel = jmax(fPeakLevel, pMeterAnalyser->getPeakLevel(nChannel));
 
-        // do not process levels below -80 dB
-        if ((fRmsLevels[0] < 0.0001f) && (fRmsLevels[1] < 0.0001f))
-        {
-            fStereoMeterValue = 0.0f;
-        }
-        else if (fRmsLevels[1] >= fRmsLevels[0])
+        if (pMeterAnalyser->getAverageAlgorithm() != KmeterPluginParameters::selAlgorithmItuBs1770)
         {
-            fStereoMeterValue = 1.0f - fRmsLevels[0] / fRmsLevels[1];
+            fAverageLevel = jmax(fAverageLevel, pMeterAnalyser->getAverageLevel(nChannel));
         }
-        else
-        {
-            fStereoMeterValue = fRmsLevels[1] / fRmsLevels[0] - 1.0f;
-        }
-
-        pMeterBallistics->setStereoMeterValue(fProcessedSeconds, fStereoMeterValue);
     }
 
+    pPeakLevelHistory->addValue(MeterBallistics::level2decibel(fPeakLevel));
+    pAverageLevelHistory->addValue(fAverageLevel);
+
     // "UM" --> update meters
     sendActionMessage("UM");
 
@@ -635,7 +663,7 @@ void KmeterAudioProcessor::processBufferChunk(AudioSampleBuffer& buffer, const u
     // before committing your changes.
     if (DEBUG_FILTER)
     {
-        pAverageLevelFiltered->copyToBuffer(*pRingBufferOutput, 0, uChunkSize);
+        pMeterAnalyser->copyFilteredToBuffer(*pRingBufferOutput, uChunkSize);
     }
     else
     {
@@ -646,14 +674,51 @@ void KmeterAudioProcessor::processBufferChunk(AudioSampleBuffer& buffer, const u
 }
 
 
-void KmeterAudioProcessor::startValidation(File fileAudio, int nSelectedChannel, bool bReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel, bool bMaximumPeakLevel, bool bStereoMeterValue, bool bPhaseCorrelation)
+void KmeterAudioProcessor::processBufferSamples(const unsigned int uNumSamples)
 {
-    // reset all meters before we start the validation
-    pMeterBallistics->reset();
+    // accumulate levels and filter the previous chunk (incremental
+    // mode only)
+    pMeterAnalyser->processBufferSamples(*pRingBufferInput, uNumSamples);
+}
+
 
+void KmeterAudioProcessor::startValidation(File fileAudio, int nSelectedChannel, bool bReportCSV, bool bBinaryLog, bool bAverageMeterLevel, bool bPeakMeterLevel, bool bMaximumPeakLevel, bool bStereoMeterValue, bool bPhaseCorrelation, bool bRenderOffline)
+{
     int nCrestFactor = getParameterAsInt(KmeterPluginParameters::selCrestFactor);
-    audioFilePlayer = new AudioFilePlayer(fileAudio, (int) getSampleRate(), pMeterBallistics, nCrestFactor);
-    audioFilePlayer->setReporters(nSelectedChannel, bReportCSV, bAverageMeterLevel, bPeakMeterLevel, bMaximumPeakLevel, bStereoMeterValue, bPhaseCorrelation);
+
+    if (bRenderOffline)
+    {
+        // render audio file on a separate thread using its own meters
+        // and write the report next to the audio file
+        File fileReport = fileAudio.withFileExtension(bReportCSV ? "validation.csv" : "validation.txt");
+
+        if (bBinaryLog)
+        {
+            fileReport = fileAudio.withFileExtension("validation.kmlog");
+        }
+
+        bool bMono = getParameterAsBool(KmeterPluginParameters::selMono);
+
+        audioFileRenderer = new AudioFileRenderer(fileAudio, fileReport, nNumInputChannels, KMETER_BUFFER_SIZE, nAverageAlgorithm, nCrestFactor, bMono);
+        audioFileRenderer->setReporters(nSelectedChannel, bReportCSV, bBinaryLog, bAverageMeterLevel, bPeakMeterLevel, bMaximumPeakLevel, bStereoMeterValue, bPhaseCorrelation);
+        audioFileRenderer->setCallbackClass(this);
+        audioFileRenderer->startThread();
+    }
+    else
+    {
+        // reset all meters before we start the validation
+        pMeterAnalyser->getLevels()->reset();
+
+        audioFilePlayer = new AudioFilePlayer(fileAudio, (int) getSampleRate(), pMeterAnalyser->getLevels(), nCrestFactor, true);
+        audioFilePlayer->setReporters(nSelectedChannel, bReportCSV, bAverageMeterLevel, bPeakMeterLevel, bMaximumPeakLevel, bStereoMeterValue, bPhaseCorrelation);
+
+        // formatting text on the audio thread is slow, so write a
+        // binary log instead (kmeter_analyser converts it to text)
+        if (bBinaryLog)
+        {
+            audioFilePlayer->setMeasurementLog(fileAudio.withFileExtension("validation.kmlog"), true);
+        }
+    }
 
     // refresh editor; "V+" --> validation started
     sendActionMessage("V+");
@@ -661,66 +726,131 @@ void KmeterAudioProcessor::startValidation(File fileAudio, int nSelectedChannel,
 
 
 void KmeterAudioProcessor::stopValidation()
+/*  Stop validation and delete player and renderer.  Must be called
+    on the message thread.
+
+    return value: none
+*/
 {
-    delete audioFilePlayer;
-    audioFilePlayer = NULL;
+    AudioFilePlayer* audioFilePlayerOld = NULL;
+
+    // remove player between audio callbacks
+    {
+        const ScopedLock sl(getCallbackLock());
+
+        audioFilePlayerOld = audioFilePlayer;
+        audioFilePlayer = NULL;
+    }
+
+    delete audioFilePlayerOld;
+    audioFilePlayerOld = NULL;
+
+    // waits for the rendering thread to exit
+    delete audioFileRenderer;
+    audioFileRenderer = NULL;
+
+    // neither player nor renderer can report completion anymore, so
+    // drop notifications that have not been handled yet
+    cancelPendingUpdate();
 
     // refresh editor; "V-" --> validation stopped
     sendActionMessage("V-");
 }
 
 
-bool KmeterAudioProcessor::isValidating()
+bool KmeterAudioProcessor::isValidating() const
+/*  Check whether validation is in progress.  Validation ends when
+    the player or renderer has reported completion on the message
+    thread (see handleAsyncUpdate()) or when it is stopped.
+
+    return value (Boolean): true while validating
+*/
+{
+    return (audioFilePlayer != NULL) || (audioFileRenderer != NULL);
+}
+
+
+void KmeterAudioProcessor::renderingFinished()
+/*  Called on the rendering thread when offline validation has
+    finished.
+
+    return value: none
+*/
+{
+    triggerAsyncUpdate();
+}
+
+
+void KmeterAudioProcessor::handleAsyncUpdate()
+/*  Called on the message thread when the player or renderer has
+    reached the end of the audio file.
+
+    return value: none
+*/
 {
-    if (audioFilePlayer == NULL)
+    if (isValidating())
     {
-        return false;
+        stopValidation();
     }
-    else
+}
+
+
+MeterBallistics* KmeterAudioProcessor::getLevels()
+{
+    if (pMeterAnalyser == NULL)
     {
-        if (audioFilePlayer->isPlaying())
-        {
-            return true;
-        }
-        else
-        {
-            stopValidation();
-            return false;
-        }
+        return NULL;
     }
+
+    return pMeterAnalyser->getLevels();
 }
 
 
-int KmeterAudioProcessor::countOverflows(AudioRingBuffer* ring_buffer, const unsigned int channel, const unsigned int length, const unsigned int pre_delay)
+LevelHistory* KmeterAudioProcessor::getPeakLevelHistory()
+/*  Get history of peak levels (highest level of all channels, in
+    dBFS and without meter ballistics).
+
+    return value (LevelHistory*): level history; NULL if audio
+    processing has not been started
+*/
 {
-    // initialise number of overflows in this buffer
-    int nOverflows = 0;
+    return pPeakLevelHistory;
+}
 
-    // loop through samples of buffer
-    for (unsigned int uSample = 0; uSample < length; uSample++)
-    {
-        // get current sample value
-        float fSampleValue = ring_buffer->getSample(channel, uSample, pre_delay);
 
-        // in the 16-bit domain, full scale corresponds to an absolute
-        // integer value of 32'767 or 32'768, so we'll treat absolute
-        // levels of 32'767 and above as overflows; this corresponds
-        // to a floating-point level of 32'767 / 32'768 = 0.9999694
-        // (approx. -0.001 dBFS).
-        if ((fSampleValue < -0.9999f) || (fSampleValue > 0.9999f))
-        {
-            nOverflows++;
-        }
-    }
+LevelHistory* KmeterAudioProcessor::getAverageLevelHistory()
+/*  Get history of average levels (loudness in ITU-R BS.1770 mode,
+    otherwise highest average level of all channels; in dBFS and
+    without meter ballistics).
 
-    // return number of overflows in this buffer
-    return nOverflows;
+    return value (LevelHistory*): level history; NULL if audio
+    processing has not been started
+*/
+{
+    return pAverageLevelHistory;
 }
 
 
-MeterBallistics* KmeterAudioProcessor::getLevels()
+GoniometerBuffer* KmeterAudioProcessor::getGoniometerBuffer()
+/*  Get decimated and rotated stereo samples for the goniometer.
+
+    return value (GoniometerBuffer*): goniometer buffer; NULL if audio
+    processing has not been started or audio is not stereo
+*/
 {
-    return pMeterBallistics;
+    return pGoniometerBuffer;
+}
+
+
+Spectrum* KmeterAudioProcessor::getSpectrum()
+/*  Get smoothed band levels of the input (K-weighted in ITU-R
+    BS.1770 mode).
+
+    return value (Spectrum*): spectrum analyser; NULL if audio
+    processing has not been started
+*/
+{
+    return pSpectrum;
 }
 
 
@@ -734,7 +864,17 @@ void KmeterAudioProcessor::setAverageAlgorithm(const int average_algorithm)
 {
     if (average_algorithm != nAverageAlgorithm)
     {
-        pAverageLevelFiltered->setAlgorithm(average_algorithm);
+        // meters have not been set up yet, so the algorithm will be
+        // checked in "prepareToPlay()"
+        if (pMeterAnalyser == NULL)
+        {
+            setAverageAlgorithmFinal(average_algorithm);
+        }
+        else
+        {
+            pMeterAnalyser->setAverageAlgorithm(average_algorithm);
+            setAverageAlgorithmFinal(pMeterAnalyser->getAverageAlgorithm());
+        }
     }
 }
 
@@ -742,7 +882,6 @@ void KmeterAudioProcessor::setAverageAlgorithm(const int average_algorithm)
 void KmeterAudioProcessor::setAverageAlgorithmFinal(const int average_algorithm)
 {
     nAverageAlgorithm = average_algorithm;
-    pMeterBallistics->setAverageAlgorithm(nAverageAlgorithm);
 
     //  the level averaging alghorithm has been changed, so update the
     // "RMS" and "ITU-R" buttons to make sure that the correct button
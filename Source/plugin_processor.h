@@ -26,7 +26,6 @@
 #ifndef __KMETER_PLUGINPROCESSOR_H__
 #define __KMETER_PLUGINPROCESSOR_H__
 
-#define KMETER_BUFFER_SIZE 1024
 #define DEBUG_FILTER 0
 
 class KmeterAudioProcessor;
@@ -34,13 +33,18 @@ class MeterBallistics;
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "audio_file_player.h"
+#include "audio_file_renderer.h"
 #include "audio_ring_buffer.h"
-#include "average_level_filtered.h"
+#include "goniometer_buffer.h"
+#include "level_history.h"
+#include "level_logger.h"
+#include "spectrum.h"
+#include "meter_analyser.h"
 #include "meter_ballistics.h"
 #include "plugin_parameters.h"
 
 //============================================================================
-class KmeterAudioProcessor  : public AudioProcessor, public ActionBroadcaster
+class KmeterAudioProcessor  : public AudioProcessor, public ActionBroadcaster, public ActionListener, public AsyncUpdater, public AudioFileRendererCallback, public AudioRingBufferCallback
 {
 public:
     //==========================================================================
@@ -50,6 +54,7 @@ public:
 
     void addActionListenerParameters(ActionListener* listener) throw();
     void removeActionListenerParameters(ActionListener* listener) throw();
+    void actionListenerCallback(const String& message);
 
     //==========================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock);
@@ -57,9 +62,12 @@ public:
 
     void processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMessages);
 
-    void startValidation(File fileAudio, int nSelectedChannel, bool bReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel, bool bMaximumPeakLevel, bool bStereoMeterValue, bool bPhaseCorrelation);
+    void startValidation(File fileAudio, int nSelectedChannel, bool bReportCSV, bool bBinaryLog, bool bAverageMeterLevel, bool bPeakMeterLevel, bool bMaximumPeakLevel, bool bStereoMeterValue, bool bPhaseCorrelation, bool bRenderOffline);
     void stopValidation();
-    bool isValidating();
+    bool isValidating() const;
+
+    void renderingFinished();
+    void handleAsyncUpdate();
 
     //==========================================================================
     AudioProcessorEditor* createEditor();
@@ -102,7 +110,12 @@ public:
     double getTailLengthSeconds() const;
 
     MeterBallistics* getLevels();
+    LevelHistory* getPeakLevelHistory();
+    LevelHistory* getAverageLevelHistory();
+    GoniometerBuffer* getGoniometerBuffer();
+    Spectrum* getSpectrum();
     void processBufferChunk(AudioSampleBuffer& buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples);
+    void processBufferSamples(const unsigned int uNumSamples);
 
     int getAverageAlgorithm();
     void setAverageAlgorithm(const int average_algorithm);
@@ -126,13 +139,22 @@ public:
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KmeterAudioProcessor);
 
+    void updateLevelLogger(const bool restart);
+
     AudioFilePlayer* audioFilePlayer;
+    AudioFileRenderer* audioFileRenderer;
 
     AudioRingBuffer* pRingBufferInput;
     AudioRingBuffer* pRingBufferOutput;
 
-    AverageLevelFiltered* pAverageLevelFiltered;
-    MeterBallistics* pMeterBallistics;
+    MeterAnalyser* pMeterAnalyser;
+    LevelLogger* pLevelLogger;
+
+    GoniometerBuffer* pGoniometerBuffer;
+    Spectrum* pSpectrum;
+
+    LevelHistory* pPeakLevelHistory;
+    LevelHistory* pAverageLevelHistory;
 
     KmeterPluginParameters* pPluginParameters;
 
@@ -142,14 +164,6 @@ private:
 
     int nAverageAlgorithm;
     int nSamplesInBuffer;
-    float fProcessedSeconds;
-
-    float* fPeakLevels;
-    float* fRmsLevels;
-    float* fAverageLevelsFiltered;
-
-    int* nOverflows;
-    int countOverflows(AudioRingBuffer* ring_buffer, const unsigned int channel, const unsigned int length, const unsigned int pre_delay);
 };
 
 AudioProcessor* JUCE_CALLTYPE createPluginFilter();
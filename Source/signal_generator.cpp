@@ -0,0 +1,394 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "signal_generator.h"
+
+
+SignalGenerator::SignalGenerator(const int signal, const int sample_rate, const int64 seed)
+/*  Constructor.  Generates deterministic test signals, so that
+    benchmarks and accuracy tests can create any amount of input
+    without decoding audio files.  Once the generator has been
+    constructed, it does not allocate any memory.
+
+    signal (integer): signal to be generated; must be one of the
+    "signal..."  values defined in "signal_generator.h"
+
+    sample_rate (integer): sample rate in Hz
+
+    seed (64-bit integer): seed for random number generator; the same
+    seed always results in the same signal
+
+    return value: none
+*/
+{
+    jassert((signal >= 0) && (signal < nNumSignals));
+    jassert(sample_rate > 0);
+
+    nSignal = signal;
+    nSampleRate = sample_rate;
+    nSeed = seed;
+
+    setLevel(-20.0f);
+    setCorrelation(1.0f);
+    setFrequency(1000.0);
+    setSweep(20.0, 20000.0, 10.0);
+
+    fPinkNoiseGain = 1.0f;
+
+    if (nSignal == signalPinkNoise)
+    {
+        calculatePinkNoiseFilters();
+    }
+
+    reset();
+}
+
+
+SignalGenerator::~SignalGenerator()
+{
+}
+
+
+void SignalGenerator::reset()
+/*  Restart signal from the beginning.
+
+    return value: none
+*/
+{
+    random.setSeed(nSeed);
+
+    dPhase = 0.0;
+    nSamplesGenerated = 0;
+
+    for (int nState = 0; nState < 7; nState++)
+    {
+        dPinkState[nState] = 0.0;
+    }
+
+    biquadHighPass.x1 = biquadHighPass.x2 = 0.0;
+    biquadHighPass.y1 = biquadHighPass.y2 = 0.0;
+
+    biquadLowPass.x1 = biquadLowPass.x2 = 0.0;
+    biquadLowPass.y1 = biquadLowPass.y2 = 0.0;
+}
+
+
+int SignalGenerator::getSignal()
+{
+    return nSignal;
+}
+
+
+int SignalGenerator::getSampleRate()
+{
+    return nSampleRate;
+}
+
+
+void SignalGenerator::setLevel(const float level)
+/*  Set signal level.
+
+    level (float): level in dBFS; this is the peak level of sines and
+    the RMS level of noise (-20 dBFS is 0 dB on the K-20 scale); clipped
+    sines are generated at this level and then clipped to 0 dBFS, and
+    inter-sample peaks exceed the sample peak level by 3 dB
+
+    return value: none
+*/
+{
+    fLevel = level;
+    fAmplitude = float(pow(10.0, fLevel / 20.0));
+}
+
+
+void SignalGenerator::setFrequency(const double frequency)
+/*  Set frequency of sines (ignored for sweeps, noise and inter-sample
+    peaks).
+
+    frequency (double): frequency in Hz
+
+    return value: none
+*/
+{
+    jassert((frequency > 0.0) && (frequency < nSampleRate / 2.0));
+
+    dFrequency = frequency;
+}
+
+
+void SignalGenerator::setSweep(const double start_frequency, const double end_frequency, const double seconds)
+/*  Set parameters of logarithmic sine sweep.  The sweep starts again
+    once it has reached its end frequency.
+
+    start_frequency (double): start frequency in Hz
+
+    end_frequency (double): end frequency in Hz
+
+    seconds (double): duration of sweep
+
+    return value: none
+*/
+{
+    jassert(start_frequency > 0.0);
+    jassert(end_frequency > 0.0);
+    jassert(seconds > 0.0);
+
+    dSweepStartFrequency = start_frequency;
+    dSweepEndFrequency = jmin(end_frequency, nSampleRate / 2.0);
+    dSweepSeconds = seconds;
+}
+
+
+void SignalGenerator::setCorrelation(const float correlation)
+/*  Set phase correlation of correlated sines.  The right channel is
+    phase-shifted against the left one by arccos(correlation).
+
+    correlation (float): phase correlation (-1.0 to +1.0)
+
+    return value: none
+*/
+{
+    fCorrelation = jlimit(-1.0f, 1.0f, correlation);
+    dPhaseOffset = acos(fCorrelation) / (2.0 * double_Pi);
+}
+
+
+void SignalGenerator::fillBuffer(AudioSampleBuffer& buffer, const int startSample, const int numSamples)
+/*  Write generated samples to a buffer.  Correlated sines are written
+    to the first two channels; all other channels (and all channels of
+    other signals) receive the same samples.
+
+    buffer (AudioSampleBuffer&): destination buffer
+
+    startSample (integer): first sample to be written
+
+    numSamples (integer): number of samples to be written
+
+    return value: none
+*/
+{
+    jassert((startSample + numSamples) <= buffer.getNumSamples());
+
+    int nNumberOfChannels = buffer.getNumChannels();
+
+    for (int nSample = startSample; nSample < (startSample + numSamples); nSample++)
+    {
+        float fSampleLeft = 0.0f;
+        float fSampleRight = 0.0f;
+
+        switch (nSignal)
+        {
+        case signalSine:
+            fSampleLeft = fAmplitude * float(sin(2.0 * double_Pi * dPhase));
+            dPhase += dFrequency / nSampleRate;
+            break;
+
+        case signalSineSweep:
+            fSampleLeft = fAmplitude * float(sin(2.0 * double_Pi * dPhase));
+            dPhase += getNextPhaseIncrement();
+            break;
+
+        case signalWhiteNoise:
+            // uniform distribution has an RMS level of 1 / sqrt(3)
+            fSampleLeft = fAmplitude * 1.7320508f * (2.0f * random.nextFloat() - 1.0f);
+            break;
+
+        case signalPinkNoise:
+            fSampleLeft = fAmplitude * getNextPinkNoiseSample();
+            break;
+
+        case signalCorrelatedSines:
+            fSampleLeft = fAmplitude * float(sin(2.0 * double_Pi * dPhase));
+            fSampleRight = fAmplitude * float(sin(2.0 * double_Pi * (dPhase + dPhaseOffset)));
+            dPhase += dFrequency / nSampleRate;
+            break;
+
+        case signalClippedSine:
+            fSampleLeft = jlimit(-1.0f, 1.0f, fAmplitude * float(sin(2.0 * double_Pi * dPhase)));
+            dPhase += dFrequency / nSampleRate;
+            break;
+
+        case signalIntersamplePeaks:
+            // a quarter of the sample rate, shifted by 45 degrees:
+            // all samples lie at +/- 0.707 of the true peak
+            fSampleLeft = fAmplitude * float(M_SQRT2 * sin(2.0 * double_Pi * (dPhase + 0.125)));
+            dPhase += 0.25;
+            break;
+
+        default:
+            jassertfalse;
+            break;
+        }
+
+        if (nSignal != signalCorrelatedSines)
+        {
+            fSampleRight = fSampleLeft;
+        }
+
+        // keep phase small to retain precision
+        if (dPhase >= 1.0)
+        {
+            dPhase -= floor(dPhase);
+        }
+
+        nSamplesGenerated++;
+
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            *buffer.getSampleData(nChannel, nSample) = (nChannel == 1) ? fSampleRight : fSampleLeft;
+        }
+    }
+}
+
+
+double SignalGenerator::getNextPhaseIncrement()
+/*  Calculate phase increment of logarithmic sine sweep for the
+    current sample.
+
+    return value (double): phase increment in cycles
+*/
+{
+    int64 nSweepLength = jmax((int64) 1, (int64)(dSweepSeconds * nSampleRate));
+    double dPosition = double(nSamplesGenerated % nSweepLength) / double(nSweepLength);
+
+    double dCurrentFrequency = dSweepStartFrequency * pow(dSweepEndFrequency / dSweepStartFrequency, dPosition);
+
+    return dCurrentFrequency / nSampleRate;
+}
+
+
+float SignalGenerator::getNextPinkNoiseSample()
+/*  Generate band-limited pink noise (500 Hz to 2 kHz, like the
+    calibration signal of the K-System) with an RMS level of 0 dBFS.
+
+    return value (float): next sample
+*/
+{
+    double dWhite = 2.0 * random.nextDouble() - 1.0;
+
+    // Paul Kellet's refined pink noise filter (accurate to within
+    // +/- 0.05 dB above 9.2 Hz at 44.1 kHz)
+    dPinkState[0] = 0.99886 * dPinkState[0] + dWhite * 0.0555179;
+    dPinkState[1] = 0.99332 * dPinkState[1] + dWhite * 0.0750759;
+    dPinkState[2] = 0.96900 * dPinkState[2] + dWhite * 0.1538520;
+    dPinkState[3] = 0.86650 * dPinkState[3] + dWhite * 0.3104856;
+    dPinkState[4] = 0.55000 * dPinkState[4] + dWhite * 0.5329522;
+    dPinkState[5] = -0.7616 * dPinkState[5] - dWhite * 0.0168980;
+
+    double dPink = dPinkState[0] + dPinkState[1] + dPinkState[2] + dPinkState[3] + dPinkState[4] + dPinkState[5] + dPinkState[6] + dWhite * 0.5362;
+    dPinkState[6] = dWhite * 0.115926;
+
+    dPink = processBiquad(biquadHighPass, dPink);
+    dPink = processBiquad(biquadLowPass, dPink);
+
+    return fPinkNoiseGain * float(dPink);
+}
+
+
+void SignalGenerator::calculatePinkNoiseFilters()
+/*  Calculate band-pass filters for pink noise and normalise its RMS
+    level.  The gain is measured on ten seconds of noise generated
+    from the current seed, so it is reproducible as well.
+
+    return value: none
+*/
+{
+    calculateBiquad(biquadHighPass, 500.0, true);
+    calculateBiquad(biquadLowPass, 2000.0, false);
+
+    fPinkNoiseGain = 1.0f;
+    reset();
+
+    int nSamples = 10 * nSampleRate;
+    double dSumOfSquares = 0.0;
+
+    for (int nSample = 0; nSample < nSamples; nSample++)
+    {
+        double dSample = getNextPinkNoiseSample();
+        dSumOfSquares += dSample * dSample;
+    }
+
+    double dRms = sqrt(dSumOfSquares / nSamples);
+
+    if (dRms > 0.0)
+    {
+        fPinkNoiseGain = float(1.0 / dRms);
+    }
+}
+
+
+void SignalGenerator::calculateBiquad(Biquad& biquad, const double cutoff, const bool high_pass)
+/*  Calculate coefficients of a second-order Butterworth filter
+    (Robert Bristow-Johnson's "Audio EQ Cookbook").
+
+    biquad (Biquad&): filter to be updated
+
+    cutoff (double): cut-off frequency in Hz
+
+    high_pass (Boolean): create high-pass filter instead of low-pass
+    filter
+
+    return value: none
+*/
+{
+    double dOmega = 2.0 * double_Pi * cutoff / nSampleRate;
+    double dCosine = cos(dOmega);
+    double dAlpha = sin(dOmega) / (2.0 * M_SQRT1_2);
+    double dNormalise = 1.0 + dAlpha;
+
+    if (high_pass)
+    {
+        biquad.b0 = (1.0 + dCosine) / 2.0 / dNormalise;
+        biquad.b1 = -(1.0 + dCosine) / dNormalise;
+    }
+    else
+    {
+        biquad.b0 = (1.0 - dCosine) / 2.0 / dNormalise;
+        biquad.b1 = (1.0 - dCosine) / dNormalise;
+    }
+
+    biquad.b2 = biquad.b0;
+    biquad.a1 = -2.0 * dCosine / dNormalise;
+    biquad.a2 = (1.0 - dAlpha) / dNormalise;
+}
+
+
+double SignalGenerator::processBiquad(Biquad& biquad, const double input)
+{
+    double dOutput = biquad.b0 * input + biquad.b1 * biquad.x1 + biquad.b2 * biquad.x2 - biquad.a1 * biquad.y1 - biquad.a2 * biquad.y2;
+
+    biquad.x2 = biquad.x1;
+    biquad.x1 = input;
+
+    biquad.y2 = biquad.y1;
+    biquad.y1 = dOutput;
+
+    return dOutput;
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
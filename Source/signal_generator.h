@@ -0,0 +1,118 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __SIGNAL_GENERATOR_H__
+#define __SIGNAL_GENERATOR_H__
+
+class SignalGenerator;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+
+//==============================================================================
+/**
+*/
+class SignalGenerator
+{
+public:
+    SignalGenerator(const int signal, const int sample_rate, const int64 seed);
+    ~SignalGenerator();
+
+    void reset();
+
+    int getSignal();
+    int getSampleRate();
+
+    void setLevel(const float level);
+    void setFrequency(const double frequency);
+    void setSweep(const double start_frequency, const double end_frequency, const double seconds);
+    void setCorrelation(const float correlation);
+
+    void fillBuffer(AudioSampleBuffer& buffer, const int startSample, const int numSamples);
+
+    enum Signals  // public namespace!
+    {
+        signalSine = 0,
+        signalSineSweep,
+        signalWhiteNoise,
+        signalPinkNoise,
+        signalCorrelatedSines,
+        signalClippedSine,
+        signalIntersamplePeaks,
+
+        nNumSignals,
+    };
+
+private:
+    JUCE_LEAK_DETECTOR(SignalGenerator);
+
+    // second-order IIR filter (direct form I)
+    struct Biquad
+    {
+        double b0, b1, b2, a1, a2;
+        double x1, x2, y1, y2;
+    };
+
+    void calculatePinkNoiseFilters();
+    void calculateBiquad(Biquad& biquad, const double cutoff, const bool high_pass);
+    double processBiquad(Biquad& biquad, const double input);
+
+    double getNextPhaseIncrement();
+    float getNextPinkNoiseSample();
+
+    int nSignal;
+    int nSampleRate;
+    int64 nSeed;
+
+    Random random;
+
+    float fLevel;
+    float fAmplitude;
+    float fCorrelation;
+    double dPhaseOffset;
+    double dFrequency;
+
+    double dSweepStartFrequency;
+    double dSweepEndFrequency;
+    double dSweepSeconds;
+
+    double dPhase;
+    int64 nSamplesGenerated;
+
+    // Paul Kellet's pink noise filter
+    double dPinkState[7];
+    float fPinkNoiseGain;
+
+    Biquad biquadHighPass;
+    Biquad biquadLowPass;
+};
+
+
+#endif  // __SIGNAL_GENERATOR_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
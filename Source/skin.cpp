@@ -28,6 +28,7 @@
 
 Skin::Skin(int number_of_channels, int crest_factor, int average_algorithm, bool horizontal_layout)
 {
+    nSegmentHeight = getDefaultSegmentHeight();
     updateSkin(number_of_channels, crest_factor, average_algorithm, horizontal_layout);
 }
 
@@ -51,12 +52,12 @@ void Skin::updateSkin(int number_of_channels, int crest_factor, int average_algo
     {
         if (nNumberOfChannels <= 2)
         {
-            nWidth = 680;
+            nWidth = 134 * nSegmentHeight + 144;
             nButtonColumnTop = nStereoInputChannels * Kmeter::KMETER_STEREO_WIDTH + 24;
         }
         else
         {
-            nWidth = 662;
+            nWidth = 134 * nSegmentHeight + 126;
 
             if (nAverageAlgorithm == KmeterPluginParameters::selAlgorithmItuBs1770)
             {
@@ -75,12 +76,12 @@ void Skin::updateSkin(int number_of_channels, int crest_factor, int average_algo
     {
         if (nNumberOfChannels <= 2)
         {
-            nHeight = 648;
+            nHeight = 134 * nSegmentHeight + 112;
             nButtonColumnLeft = nStereoInputChannels * Kmeter::KMETER_STEREO_WIDTH + 24;
         }
         else
         {
-            nHeight = 630;
+            nHeight = 134 * nSegmentHeight + 94;
 
             if (nAverageAlgorithm == KmeterPluginParameters::selAlgorithmItuBs1770)
             {
@@ -98,6 +99,83 @@ void Skin::updateSkin(int number_of_channels, int crest_factor, int average_algo
 }
 
 
+int Skin::getWidth()
+{
+    return nWidth;
+}
+
+
+int Skin::getHeight()
+{
+    return nHeight;
+}
+
+
+int Skin::getSegmentHeight()
+{
+    return nSegmentHeight;
+}
+
+
+void Skin::setSegmentHeight(int segment_height)
+/*  Set size of meters and re-calculate layout.
+
+    segment_height (integer): pixels per meter segment
+
+    return value: none
+*/
+{
+    nSegmentHeight = jlimit(MINIMUM_SEGMENT_HEIGHT, MAXIMUM_SEGMENT_HEIGHT, segment_height);
+    updateSkin(nNumberOfChannels, nCrestFactor, nAverageAlgorithm, bHorizontalLayout);
+}
+
+
+int Skin::getSegmentHeightForSize(int width, int height)
+/*  Find largest segment height whose layout fits into the given size.
+    Only the meters' length changes with the segment height, so
+    segments stay aligned to pixels and their number never changes.
+
+    width (integer): available width in pixels
+
+    height (integer): available height in pixels
+
+    return value (integer): pixels per meter segment
+*/
+{
+    int nSegmentHeightNew;
+
+    if (bHorizontalLayout)
+    {
+        int nMarginWidth = nWidth - 134 * nSegmentHeight;
+        nSegmentHeightNew = (width - nMarginWidth) / 134;
+    }
+    else
+    {
+        int nMarginHeight = nHeight - 134 * nSegmentHeight;
+        nSegmentHeightNew = (height - nMarginHeight) / 134;
+    }
+
+    return jlimit(MINIMUM_SEGMENT_HEIGHT, MAXIMUM_SEGMENT_HEIGHT, nSegmentHeightNew);
+}
+
+
+int Skin::getDefaultSegmentHeight()
+/*  Get initial segment height for the main display.  The original
+    layout is kept for displays of up to 1200 pixels in height; the
+    meters of high-resolution displays (such as in control rooms)
+    grow in proportion.  As JUCE reports retina displays in logical
+    pixels, these keep the original layout.
+
+    return value (integer): pixels per meter segment
+*/
+{
+    int nDisplayHeight = Desktop::getInstance().getDisplays().getMainDisplay().userArea.getHeight();
+    int nSegmentHeightDisplay = (MINIMUM_SEGMENT_HEIGHT * nDisplayHeight) / 1200;
+
+    return jlimit(MINIMUM_SEGMENT_HEIGHT, MAXIMUM_SEGMENT_HEIGHT, nSegmentHeightDisplay);
+}
+
+
 void Skin::placeButton(int nButtonID, Component* pButton)
 {
     jassert(pButton != NULL);
@@ -165,6 +243,39 @@ void Skin::placeButton(int nButtonID, Component* pButton)
         case LabelDebug:
             setBoundsButtonColumn(pButton, 198, 25, 60, 16);
             break;
+
+        // the K-Meter sizes itself, so only its position is set
+        case MeterKmeter:
+            pButton->setTopLeftPosition(48, 10);
+            break;
+
+        case MeterStereo:
+            pButton->setBounds(28, 10, 13, 106);
+            break;
+
+        case MeterPhaseCorrelation:
+            pButton->setBounds(10, 10, 13, 106);
+            break;
+
+        case MeterGoniometer:
+            setBoundsButtonColumn(pButton, 498, 0, 45, 45);
+            break;
+
+        case MeterSpectrum:
+
+            // only stereo layouts have a goniometer (surround layouts
+            // also have less width); the spectrum fills the gap up to
+            // the validation button and grows with the meters
+            if (nNumberOfChannels == 2)
+            {
+                setBoundsButtonColumn(pButton, 549, 0, nWidth - 635, 45);
+            }
+            else
+            {
+                setBoundsButtonColumn(pButton, 498, 0, nWidth - 584, 45);
+            }
+
+            break;
         }
     }
     else
@@ -230,6 +341,38 @@ void Skin::placeButton(int nButtonID, Component* pButton)
         case LabelDebug:
             setBoundsButtonColumn(pButton, 0, nHeight - 102, 60, 16);
             break;
+
+        // the K-Meter sizes itself, so only its position is set
+        case MeterKmeter:
+            pButton->setTopLeftPosition(10, 10);
+            break;
+
+        case MeterStereo:
+            pButton->setBounds(10, nHeight - 41, 106, 13);
+            break;
+
+        case MeterPhaseCorrelation:
+            pButton->setBounds(10, nHeight - 24, 106, 13);
+            break;
+
+        case MeterGoniometer:
+            setBoundsButtonColumn(pButton, 0, 360, 60, 60);
+            break;
+
+        case MeterSpectrum:
+
+            // only stereo layouts have a goniometer; otherwise, the
+            // spectrum takes its space
+            if (nNumberOfChannels == 2)
+            {
+                setBoundsButtonColumn(pButton, 0, 430, 60, 90);
+            }
+            else
+            {
+                setBoundsButtonColumn(pButton, 0, 360, 60, 160);
+            }
+
+            break;
         }
     }
 }
@@ -57,14 +57,31 @@ public:
         ButtonAbout,
 
         LabelDebug,
+        MeterKmeter,
+        MeterStereo,
+        MeterPhaseCorrelation,
+        MeterGoniometer,
+        MeterSpectrum,
     };
 
+    // pixels per meter segment (the meters are 134 segments long)
+    static const int MINIMUM_SEGMENT_HEIGHT = 4;
+    static const int MAXIMUM_SEGMENT_HEIGHT = 16;
+
     Skin(int number_of_channels, int crest_factor, int average_algorithm, bool horizontal_layout);
     ~Skin();
 
     void updateSkin(int number_of_channels, int crest_factor, int average_algorithm, bool horizontal_layout);
     void placeButton(int nButtonID, Component* pButton);
 
+    int getWidth();
+    int getHeight();
+
+    int getSegmentHeight();
+    void setSegmentHeight(int segment_height);
+    int getSegmentHeightForSize(int width, int height);
+    static int getDefaultSegmentHeight();
+
 private:
     JUCE_LEAK_DETECTOR(Skin);
 
@@ -76,6 +93,7 @@ private:
     int nAverageAlgorithm;
     bool bHorizontalLayout;
 
+    int nSegmentHeight;
     int nWidth;
     int nHeight;
     int nButtonColumnLeft;
@@ -0,0 +1,238 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "spectrum.h"
+#include "meter_ballistics.h"
+
+
+Spectrum::Spectrum(const int channels, const int buffer_size, const int sample_rate)
+/*  Smoothed levels of half-octave bands, calculated from the spectra
+    that AverageLevelFiltered computes anyway.
+
+    channels (integer): number of audio channels
+
+    buffer_size (integer): number of samples per transform (the
+    transform itself is zero-padded to twice this size)
+
+    sample_rate (integer): sample rate of audio
+
+    return value: none
+*/
+{
+    jassert(channels > 0);
+
+    nNumberOfChannels = channels;
+    nBufferSize = buffer_size;
+
+    fMeanSquares = new float[nNumberOfChannels * MAXIMUM_NUMBER_OF_BANDS];
+
+    // bands fall by 20 dB in 0.5 seconds
+    float fSecondsPerSpectrum = nBufferSize / float(sample_rate);
+    fReleaseCoefficient = powf(0.01f, fSecondsPerSpectrum / 0.5f);
+
+    // the transform is zero-padded to twice the buffer size
+    int nFftSize = 2 * nBufferSize;
+    int nNumberOfBins = nFftSize / 2 + 1;
+    float fHertzPerBin = sample_rate / float(nFftSize);
+
+    // band edges lie a quarter octave below and above centre; the
+    // lowest band starts above DC
+    float fQuarterOctave = powf(2.0f, 0.25f);
+    int nFirst = (int) floorf(getBandFrequency(0) / fQuarterOctave / fHertzPerBin) + 1;
+
+    nNumberOfBands = 0;
+
+    for (int nBand = 0; nBand < MAXIMUM_NUMBER_OF_BANDS; nBand++)
+    {
+        // every bin belongs to exactly one band
+        int nLast = (int) floorf(getBandFrequency(nBand) * fQuarterOctave / fHertzPerBin);
+        nLast = jmin(nLast, nNumberOfBins - 1);
+
+        // low bands may not contain a single bin; rather than showing
+        // the same bin twice, merge them with the next band
+        if (nLast < nFirst)
+        {
+            continue;
+        }
+
+        nFirstBin[nNumberOfBands] = nFirst;
+        nLastBin[nNumberOfBands] = nLast;
+        nNumberOfBands++;
+
+        nFirst = nLast + 1;
+    }
+
+    jassert(nNumberOfBands > 0);
+
+    reset();
+}
+
+
+Spectrum::~Spectrum()
+{
+    delete [] fMeanSquares;
+    fMeanSquares = NULL;
+}
+
+
+void Spectrum::reset()
+{
+    for (int n = 0; n < nNumberOfChannels * MAXIMUM_NUMBER_OF_BANDS; n++)
+    {
+        fMeanSquares[n] = 0.0f;
+    }
+}
+
+
+int Spectrum::getNumberOfBands()
+/*  Get number of bands after merging bands that are narrower than
+    the frequency resolution.
+
+    return value (integer): number of bands
+*/
+{
+    return nNumberOfBands;
+}
+
+
+float Spectrum::getBandFrequency(const int band)
+/*  Get nominal centre frequency of a half-octave band (before
+    merging).
+
+    band (integer): selected band
+
+    return value (float): centre frequency in Hertz
+*/
+{
+    return 20.0f * powf(2.0f, band / 2.0f);
+}
+
+
+void Spectrum::addSpectrum(const int channel, const fftwf_complex* bins)
+/*  Update band levels of a channel.
+
+    channel (integer): selected audio channel
+
+    bins (fftwf_complex pointer): positive half of the channel's
+    spectrum (twice the buffer size, zero-padded, no window)
+
+    return value: none
+*/
+{
+    jassert(channel >= 0);
+    jassert(channel < nNumberOfChannels);
+
+    float* fMeanSquaresChannel = fMeanSquares + channel * MAXIMUM_NUMBER_OF_BANDS;
+
+    // by Parseval's theorem, the squared magnitudes of the positive
+    // half of the zero-padded spectrum add up to the buffer size
+    // squared times the mean square of the signal
+    float fNorm = float(nBufferSize) * float(nBufferSize);
+
+    for (int nBand = 0; nBand < nNumberOfBands; nBand++)
+    {
+        float fSum = 0.0f;
+
+        for (int nBin = nFirstBin[nBand]; nBin <= nLastBin[nBand]; nBin++)
+        {
+            fSum += bins[nBin][0] * bins[nBin][0] + bins[nBin][1] * bins[nBin][1];
+        }
+
+        float fMeanSquare = fSum / fNorm;
+
+        // rise instantly, but fall slowly
+        if (fMeanSquare >= fMeanSquaresChannel[nBand])
+        {
+            fMeanSquaresChannel[nBand] = fMeanSquare;
+        }
+        else
+        {
+            fMeanSquaresChannel[nBand] = fReleaseCoefficient * (fMeanSquaresChannel[nBand] - fMeanSquare) + fMeanSquare;
+        }
+    }
+}
+
+
+void Spectrum::copyChannel(const int source_channel, const int destination_channel)
+/*  Copy band levels from one channel to another.  Use this for
+    channels that are not filtered, such as the second channel of a
+    stereo signal that has been mixed down to mono.
+
+    source_channel (integer): channel to copy from
+
+    destination_channel (integer): channel to copy to
+
+    return value: none
+*/
+{
+    jassert(source_channel >= 0);
+    jassert(source_channel < nNumberOfChannels);
+    jassert(destination_channel >= 0);
+    jassert(destination_channel < nNumberOfChannels);
+
+    float* fMeanSquaresSource = fMeanSquares + source_channel * MAXIMUM_NUMBER_OF_BANDS;
+    float* fMeanSquaresDestination = fMeanSquares + destination_channel * MAXIMUM_NUMBER_OF_BANDS;
+
+    for (int nBand = 0; nBand < nNumberOfBands; nBand++)
+    {
+        fMeanSquaresDestination[nBand] = fMeanSquaresSource[nBand];
+    }
+}
+
+
+float Spectrum::getBandLevel(const int first_band, const int last_band)
+/*  Get smoothed level of adjacent bands, averaged over all channels.
+
+    first_band (integer): lowest selected band
+
+    last_band (integer): highest selected band
+
+    return value (float): combined level of bands in decibels
+*/
+{
+    jassert(first_band >= 0);
+    jassert(first_band <= last_band);
+    jassert(last_band < nNumberOfBands);
+
+    float fMeanSquare = 0.0f;
+
+    // bands do not share bins, so their mean squares add up
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        for (int nBand = first_band; nBand <= last_band; nBand++)
+        {
+            fMeanSquare += fMeanSquares[nChannel * MAXIMUM_NUMBER_OF_BANDS + nBand];
+        }
+    }
+
+    fMeanSquare /= float(nNumberOfChannels);
+
+    return MeterBallistics::level2decibel(sqrtf(fMeanSquare));
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
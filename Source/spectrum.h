@@ -0,0 +1,77 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __SPECTRUM_H__
+#define __SPECTRUM_H__
+
+class Spectrum;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "fftw3/api/fftw3.h"
+
+
+//==============================================================================
+/**
+*/
+class Spectrum
+{
+public:
+    // half-octave bands from 20 Hz to 20 kHz (bands that are
+    // narrower than the frequency resolution are merged)
+    static const int MAXIMUM_NUMBER_OF_BANDS = 21;
+
+    Spectrum(const int channels, const int buffer_size, const int sample_rate);
+    ~Spectrum();
+
+    void reset();
+    void addSpectrum(const int channel, const fftwf_complex* bins);
+    void copyChannel(const int source_channel, const int destination_channel);
+
+    int getNumberOfBands();
+    float getBandLevel(const int first_band, const int last_band);
+    static float getBandFrequency(const int band);
+
+private:
+    JUCE_LEAK_DETECTOR(Spectrum);
+
+    int nNumberOfChannels;
+    int nBufferSize;
+    int nNumberOfBands;
+
+    // smoothed mean squares of all bands, one channel after another
+    float* fMeanSquares;
+    float fReleaseCoefficient;
+
+    int nFirstBin[MAXIMUM_NUMBER_OF_BANDS];
+    int nLastBin[MAXIMUM_NUMBER_OF_BANDS];
+};
+
+
+#endif  // __SPECTRUM_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
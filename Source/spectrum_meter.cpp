@@ -0,0 +1,248 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "spectrum_meter.h"
+
+
+SpectrumMeter::SpectrumMeter(const String& componentName)
+{
+    setName(componentName);
+
+    // this component does not have any transparent areas (increases
+    // performance on redrawing)
+    setOpaque(true);
+
+    bVerticalBands = true;
+
+    nNumberOfBands = Spectrum::MAXIMUM_NUMBER_OF_BANDS;
+    nBandsPerBar = 1;
+    nNumberOfBars = nNumberOfBands;
+
+    nBarSize = 0;
+    nBarOffset = 0;
+    nMaximumLength = 0;
+
+    for (int nBar = 0; nBar < Spectrum::MAXIMUM_NUMBER_OF_BANDS; nBar++)
+    {
+        nBarLength[nBar] = 0;
+    }
+}
+
+
+SpectrumMeter::~SpectrumMeter()
+{
+}
+
+
+void SpectrumMeter::update(Spectrum* pSpectrum)
+/*  Update bar lengths and re-paint the bars that have changed.
+
+    pSpectrum (Spectrum*): spectrum analyser (may be NULL)
+
+    return value: none
+*/
+{
+    // the number of bands depends on the sample rate
+    if (pSpectrum && (pSpectrum->getNumberOfBands() != nNumberOfBands))
+    {
+        nNumberOfBands = pSpectrum->getNumberOfBands();
+        calculateBars();
+        repaint();
+    }
+
+    Rectangle<int> rectDirty;
+
+    for (int nBar = 0; nBar < nNumberOfBars; nBar++)
+    {
+        int nLength = 0;
+
+        if (pSpectrum)
+        {
+            int nFirstBand = nBar * nBandsPerBar;
+            int nLastBand = jmin(nFirstBand + nBandsPerBar, nNumberOfBands) - 1;
+
+            float fLevel = pSpectrum->getBandLevel(nFirstBand, nLastBand);
+            nLength = roundToInt((fLevel - MINIMUM_DECIBEL) / -MINIMUM_DECIBEL * nMaximumLength);
+            nLength = jlimit(0, nMaximumLength, nLength);
+        }
+
+        if (nLength != nBarLength[nBar])
+        {
+            // the longer of both bars covers the shorter one
+            int nDirtyLength = jmax(nLength, nBarLength[nBar]);
+            rectDirty = rectDirty.getUnion(getBarBounds(nBar, nDirtyLength));
+
+            nBarLength[nBar] = nLength;
+        }
+    }
+
+    if (!rectDirty.isEmpty())
+    {
+        repaint(rectDirty);
+    }
+}
+
+
+bool SpectrumMeter::isOnFloor()
+/*  Check whether all bars have fallen to their floor.
+
+    return value (Boolean): true if no bars are shown
+*/
+{
+    for (int nBar = 0; nBar < nNumberOfBars; nBar++)
+    {
+        if (nBarLength[nBar] > 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+void SpectrumMeter::paint(Graphics& g)
+{
+    g.drawImageAt(imageBackground, 0, 0);
+    g.setColour(Colour(0.45f, 0.8f, 0.9f, 1.0f));
+
+    for (int nBar = 0; nBar < nNumberOfBars; nBar++)
+    {
+        if (nBarLength[nBar] > 0)
+        {
+            g.fillRect(getBarBounds(nBar, nBarLength[nBar]));
+        }
+    }
+}
+
+
+void SpectrumMeter::resized()
+{
+    int width = getWidth();
+    int height = getHeight();
+
+    bVerticalBands = (height >= width);
+
+    // leave one pixel for the border and one for spacing
+    nMaximumLength = (bVerticalBands ? width : height) - 4;
+
+    calculateBars();
+    renderBackground();
+}
+
+
+void SpectrumMeter::calculateBars()
+/*  Distribute bands over bars, merging adjacent bands as long as the
+    bars would be too narrow to tell apart.
+
+    return value: none
+*/
+{
+    // leave one pixel for the border and one for spacing
+    int nBarExtent = (bVerticalBands ? getHeight() : getWidth()) - 4;
+
+    nBandsPerBar = 1;
+    nNumberOfBars = nNumberOfBands;
+
+    while ((nNumberOfBars > 1) && (nBarExtent / nNumberOfBars < MINIMUM_BAR_SIZE))
+    {
+        nBandsPerBar++;
+        nNumberOfBars = (nNumberOfBands + nBandsPerBar - 1) / nBandsPerBar;
+    }
+
+    nBarSize = jmax(1, nBarExtent / nNumberOfBars);
+    nBarOffset = 2 + (nBarExtent - nBarSize * nNumberOfBars) / 2;
+
+    for (int nBar = 0; nBar < Spectrum::MAXIMUM_NUMBER_OF_BANDS; nBar++)
+    {
+        nBarLength[nBar] = 0;
+    }
+}
+
+
+Rectangle<int> SpectrumMeter::getBarBounds(const int bar, const int length)
+/*  Get bounds of a bar.
+
+    bar (integer): selected bar
+
+    length (integer): length of bar in pixels
+
+    return value (Rectangle<int>): bounds of bar
+*/
+{
+    // leave a gap between bars if there is room for it
+    int nGap = (nBarSize > 2) ? 1 : 0;
+    int nPosition = nBarOffset + bar * nBarSize;
+
+    if (bVerticalBands)
+    {
+        // lowest band at the bottom, bars grow to the right
+        int y = getHeight() - nPosition - nBarSize;
+        return Rectangle<int>(2, y, length, nBarSize - nGap);
+    }
+    else
+    {
+        // lowest band on the left, bars grow upwards
+        int y = getHeight() - 2 - length;
+        return Rectangle<int>(nPosition, y, nBarSize - nGap, length);
+    }
+}
+
+
+void SpectrumMeter::renderBackground()
+{
+    int width = getWidth();
+    int height = getHeight();
+
+    imageBackground = Image(Image::RGB, width, height, true);
+    Graphics g(imageBackground);
+
+    g.fillAll(Colours::black);
+
+    // grid lines at -80, -60, -40 and -20 dB
+    g.setColour(Colours::white.withAlpha(0.15f));
+
+    for (int nDecibel = MINIMUM_DECIBEL + 10; nDecibel < 0; nDecibel += 20)
+    {
+        int nLength = roundToInt(float(nDecibel - MINIMUM_DECIBEL) / -MINIMUM_DECIBEL * nMaximumLength);
+
+        if (bVerticalBands)
+        {
+            g.drawVerticalLine(2 + nLength, 1.0f, height - 1.0f);
+        }
+        else
+        {
+            g.drawHorizontalLine(height - 2 - nLength, 1.0f, width - 1.0f);
+        }
+    }
+
+    g.setColour(Colours::darkgrey.darker(0.3f));
+    g.drawRect(0, 0, width, height, 1);
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,86 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __SPECTRUM_METER_H__
+#define __SPECTRUM_METER_H__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "spectrum.h"
+
+
+//==============================================================================
+/**
+*/
+class SpectrumMeter : public Component
+{
+public:
+    SpectrumMeter(const String& componentName);
+    ~SpectrumMeter();
+
+    void update(Spectrum* pSpectrum);
+    bool isOnFloor();
+
+    void paint(Graphics& g);
+    void resized();
+
+private:
+    JUCE_LEAK_DETECTOR(SpectrumMeter);
+
+    // lowest band level that is displayed (in decibels)
+    static const int MINIMUM_DECIBEL = -90;
+
+    // adjacent bands are merged into a single bar when bars would
+    // otherwise become narrower than this (in pixels)
+    static const int MINIMUM_BAR_SIZE = 3;
+
+    void calculateBars();
+    void renderBackground();
+    Rectangle<int> getBarBounds(const int bar, const int length);
+
+    // frequency runs upwards when the meter is higher than wide, and
+    // to the right otherwise
+    bool bVerticalBands;
+
+    int nNumberOfBands;
+    int nBandsPerBar;
+    int nNumberOfBars;
+
+    int nBarSize;
+    int nBarOffset;
+    int nMaximumLength;
+
+    int nBarLength[Spectrum::MAXIMUM_NUMBER_OF_BANDS];
+
+    // cached border and level grid
+    Image imageBackground;
+};
+
+
+#endif  // __SPECTRUM_METER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
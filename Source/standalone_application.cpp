@@ -52,7 +52,9 @@ void StandaloneApplication::initialise(const String& commandLineParameters)
 
     filterWindow->setTitleBarButtonsRequired(DocumentWindow::allButtons, false);
     filterWindow->setVisible(true);
-    filterWindow->setResizable(false, true);
+
+    // the editor snaps to the nearest meter size when resized
+    filterWindow->setResizable(true, true);
 }
 
 void StandaloneApplication::shutdown()
@@ -0,0 +1,408 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "statistics_test_application.h"
+
+
+// number of channels of the generated test files
+static const int arrTestChannels[] = {1, 2, 6};
+
+// averaging algorithms to be tested
+static const int arrTestAlgorithms[] = {KmeterPluginParameters::selAlgorithmItuBs1770, KmeterPluginParameters::selAlgorithmRms};
+
+
+StatisticsTestApplication::StatisticsTestApplication()
+/*  Constructor.  Checks that splitting audio files into segments
+    does not change the results of the analyser: every file is
+    analysed as a whole and in segments, and the merged statistics
+    of the segments (in order and in reverse order) must match those
+    of the whole file.
+
+    return value: none
+*/
+{
+    nNumberOfThreads = SystemStats::getNumCpus();
+
+    // use short segments so that even short files are split
+    nSegmentLength = 5;
+    nSampleRate = 48000;
+}
+
+
+StatisticsTestApplication::~StatisticsTestApplication()
+{
+}
+
+
+int StatisticsTestApplication::run(const StringArray& arguments)
+/*  Generate test files, analyse them (and all files passed on the
+    command line) using both averaging algorithms and print a
+    report.
+
+    arguments (StringArray): command line arguments (without the name
+    of the executable)
+
+    return value (integer): exit code (0 when all tests have passed)
+*/
+{
+    if (!parseArguments(arguments))
+    {
+        printUsage();
+        return 2;
+    }
+
+    File directoryTemp = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("kmeter_statistics_test", String::empty);
+
+    if (!directoryTemp.createDirectory())
+    {
+        ConsoleOutput::printMessage("Could not create directory \"" + directoryTemp.getFullPathName() + "\"");
+        return 1;
+    }
+
+    Array<File> arrTestFiles;
+
+    for (int nIndex = 0; nIndex < numElementsInArray(arrTestChannels); nIndex++)
+    {
+        arrTestFiles.add(generateTestFile(directoryTemp, arrTestChannels[nIndex]));
+    }
+
+    arrTestFiles.addArray(arrAudioFiles);
+
+    ThreadPool threadPool(nNumberOfThreads);
+    int nNumberOfTests = 0;
+    int nNumberOfFailures = 0;
+
+    for (int nFile = 0; nFile < arrTestFiles.size(); nFile++)
+    {
+        for (int nIndex = 0; nIndex < numElementsInArray(arrTestAlgorithms); nIndex++)
+        {
+            nNumberOfTests++;
+
+            if (!testFile(arrTestFiles[nFile], arrTestAlgorithms[nIndex], threadPool))
+            {
+                nNumberOfFailures++;
+            }
+        }
+    }
+
+    directoryTemp.deleteRecursively();
+
+    if (nNumberOfFailures == 0)
+    {
+        ConsoleOutput::printMessage("Summary:      all " + String(nNumberOfTests) + " tests passed");
+        return 0;
+    }
+    else
+    {
+        ConsoleOutput::printMessage("Summary:      " + String(nNumberOfFailures) + " of " + String(nNumberOfTests) + " tests FAILED");
+        return 1;
+    }
+}
+
+
+File StatisticsTestApplication::generateTestFile(const File& directory, const int number_of_channels)
+/*  Write a test file that exercises all parts of the statistics:
+    noise and sines at various levels, clipped sines (overflows),
+    correlated sines (phase correlation) and silence (gating of the
+    loudness histogram).  The passages do not line up with the
+    segments, and the channels differ in level.
+
+    directory (const File&): directory to write the file to
+
+    number_of_channels (integer): number of audio channels
+
+    return value (File): test file; a file that could not be written
+    does not exist and will fail the test
+*/
+{
+    // signal, level in dBFS
+    const int nNumberOfPassages = 8;
+    const int arrSignals[nNumberOfPassages] = {SignalGenerator::signalPinkNoise, SignalGenerator::signalCorrelatedSines, SignalGenerator::signalPinkNoise, SignalGenerator::signalClippedSine, SignalGenerator::signalSine, SignalGenerator::signalSineSweep, SignalGenerator::signalWhiteNoise, SignalGenerator::signalIntersamplePeaks};
+    const float arrLevels[nNumberOfPassages] = {-20.0f, -10.0f, -40.0f, 3.0f, -100.0f, -18.0f, -30.0f, -6.0f};
+
+    // three seconds per passage, so that passages and segments
+    // overlap in varying ways
+    const int nPassageLength = 3 * nSampleRate;
+
+    File fileAudio = directory.getChildFile("test_" + String(number_of_channels) + "_channels.wav");
+    AudioSampleBuffer buffer(number_of_channels, nNumberOfPassages * nPassageLength);
+
+    for (int nPassage = 0; nPassage < nNumberOfPassages; nPassage++)
+    {
+        // fixed seed, so that all runs analyse the same signal
+        SignalGenerator signalGenerator(arrSignals[nPassage], nSampleRate, nPassage + 1);
+
+        signalGenerator.setLevel(arrLevels[nPassage]);
+        signalGenerator.setCorrelation(0.5f);
+        signalGenerator.setSweep(20.0, 20000.0, 3.0);
+        signalGenerator.fillBuffer(buffer, nPassage * nPassageLength, nPassageLength);
+    }
+
+    // lower the level by 3 dB per channel
+    for (int nChannel = 1; nChannel < number_of_channels; nChannel++)
+    {
+        buffer.applyGain(nChannel, 0, buffer.getNumSamples(), float(pow(10.0, -3.0 * nChannel / 20.0)));
+    }
+
+    ScopedPointer<FileOutputStream> outputStream(fileAudio.createOutputStream());
+
+    if (outputStream == NULL)
+    {
+        return fileAudio;
+    }
+
+    WavAudioFormat wavAudioFormat;
+    ScopedPointer<AudioFormatWriter> writer(wavAudioFormat.createWriterFor(outputStream, nSampleRate, number_of_channels, 24, StringPairArray(), 0));
+
+    if (writer == NULL)
+    {
+        outputStream = NULL;
+        fileAudio.deleteFile();
+
+        return fileAudio;
+    }
+
+    // the writer now owns the stream
+    outputStream.release();
+    writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+
+    return fileAudio;
+}
+
+
+bool StatisticsTestApplication::testFile(const File& fileAudio, const int average_algorithm, ThreadPool& threadPool)
+/*  Analyse an audio file as a whole and in segments, merge the
+    statistics of the segments in order and in reverse order and
+    compare them with those of the whole file.
+
+    fileAudio (const File&): audio file to be analysed
+
+    average_algorithm (integer): algorithm for calculating average
+    meter levels; must be one of the "selAlgorithm..."  values defined
+    in "plugin_parameters.h"
+
+    threadPool (ThreadPool&): thread pool that runs the jobs
+
+    return value (Boolean): true if the test has passed
+*/
+{
+    OwnedArray<AnalyserJob> arrWholeFile;
+    OwnedArray<AnalyserJob> arrSegments;
+
+    AnalyserJob::addJobs(fileAudio, average_algorithm, 0, threadPool, arrWholeFile);
+    AnalyserJob::addJobs(fileAudio, average_algorithm, nSegmentLength, threadPool, arrSegments);
+
+    threadPool.waitForJobToFinish(arrWholeFile[0], -1);
+    bool bFailed = arrWholeFile[0]->hasFailed();
+
+    for (int nJob = 0; nJob < arrSegments.size(); nJob++)
+    {
+        threadPool.waitForJobToFinish(arrSegments[nJob], -1);
+        bFailed = bFailed || arrSegments[nJob]->hasFailed();
+    }
+
+    String strAlgorithm = (average_algorithm == KmeterPluginParameters::selAlgorithmRms) ? "RMS" : "ITU-R BS.1770-1";
+
+    ConsoleOutput::printMessage("File:         \"" + fileAudio.getFullPathName() + "\"");
+    ConsoleOutput::printMessage("Algorithm:    " + strAlgorithm);
+
+    if (bFailed)
+    {
+        ConsoleOutput::printMessage("Result:       FAILED (could not analyse file)\n");
+        return false;
+    }
+
+    const MeterStatistics& statisticsWholeFile = *arrWholeFile[0]->getStatistics();
+
+    MeterStatistics statisticsInOrder(*arrSegments.getFirst()->getStatistics());
+    MeterStatistics statisticsReversed(*arrSegments.getLast()->getStatistics());
+
+    for (int nJob = 1; nJob < arrSegments.size(); nJob++)
+    {
+        statisticsInOrder.merge(*arrSegments[nJob]->getStatistics());
+        statisticsReversed.merge(*arrSegments[arrSegments.size() - 1 - nJob]->getStatistics());
+    }
+
+    String strDifferences;
+    compareStatistics(statisticsWholeFile, statisticsInOrder, "in order", strDifferences);
+    compareStatistics(statisticsWholeFile, statisticsReversed, "reversed", strDifferences);
+
+    ConsoleOutput::printMessage("Segments:     " + String(arrSegments.size()));
+
+    if (strDifferences.isEmpty())
+    {
+        ConsoleOutput::printMessage("Result:       passed\n");
+        return true;
+    }
+    else
+    {
+        ConsoleOutput::printMessage(strDifferences + "Result:       FAILED\n");
+        return false;
+    }
+}
+
+
+void StatisticsTestApplication::compareStatistics(const MeterStatistics& expected, const MeterStatistics& merged, const String& strMergeOrder, String& strDifferences)
+/*  Compare statistics of a whole file with merged statistics of its
+    segments.  Peak levels and overflows must match exactly; levels
+    that depend on filters may differ by rounding errors only.
+
+    expected (const MeterStatistics&): statistics of whole file
+
+    merged (const MeterStatistics&): merged statistics of segments
+
+    strMergeOrder (const String&): description of merge order
+
+    strDifferences (String&): differences are appended to this string
+
+    return value: none
+*/
+{
+    // maximum difference of average levels in decibels
+    const float fTolerance = 0.001f;
+    String strPrefix = "Difference:   " + strMergeOrder + ", ";
+
+    for (int nChannel = 0; nChannel < expected.getNumberOfChannels(); nChannel++)
+    {
+        String strChannel = "ch. " + String(nChannel + 1) + ": ";
+
+        if (merged.getNumberOfChunks(nChannel) != expected.getNumberOfChunks(nChannel))
+        {
+            strDifferences += strPrefix + strChannel + "chunks " + String(merged.getNumberOfChunks(nChannel)) + " instead of " + String(expected.getNumberOfChunks(nChannel)) + "\n";
+        }
+
+        if (merged.getMaximumPeakLevel(nChannel) != expected.getMaximumPeakLevel(nChannel))
+        {
+            strDifferences += strPrefix + strChannel + "max. peak " + String(merged.getMaximumPeakLevel(nChannel)) + " instead of " + String(expected.getMaximumPeakLevel(nChannel)) + "\n";
+        }
+
+        if (merged.getNumberOfOverflows(nChannel) != expected.getNumberOfOverflows(nChannel))
+        {
+            strDifferences += strPrefix + strChannel + "overflows " + String(merged.getNumberOfOverflows(nChannel)) + " instead of " + String(expected.getNumberOfOverflows(nChannel)) + "\n";
+        }
+
+        if (fabs(merged.getAverageLevel(nChannel) - expected.getAverageLevel(nChannel)) > fTolerance)
+        {
+            strDifferences += strPrefix + strChannel + "average " + String(merged.getAverageLevel(nChannel)) + " instead of " + String(expected.getAverageLevel(nChannel)) + "\n";
+        }
+    }
+
+    if (merged.getNumberOfCorrelationChunks() != expected.getNumberOfCorrelationChunks())
+    {
+        strDifferences += strPrefix + "correlation chunks " + String(merged.getNumberOfCorrelationChunks()) + " instead of " + String(expected.getNumberOfCorrelationChunks()) + "\n";
+    }
+
+    if (fabs(merged.getPhaseCorrelation() - expected.getPhaseCorrelation()) > fTolerance)
+    {
+        strDifferences += strPrefix + "correlation " + String(merged.getPhaseCorrelation()) + " instead of " + String(expected.getPhaseCorrelation()) + "\n";
+    }
+
+    const LoudnessHistogram& histogramExpected = expected.getLoudnessHistogram();
+    const LoudnessHistogram& histogramMerged = merged.getLoudnessHistogram();
+
+    if (histogramMerged.getNumberOfBlocks() != histogramExpected.getNumberOfBlocks())
+    {
+        strDifferences += strPrefix + "gating blocks " + String(histogramMerged.getNumberOfBlocks()) + " instead of " + String(histogramExpected.getNumberOfBlocks()) + "\n";
+    }
+
+    if (fabs(histogramMerged.getIntegratedLoudness() - histogramExpected.getIntegratedLoudness()) > fTolerance)
+    {
+        strDifferences += strPrefix + "loudness " + String(histogramMerged.getIntegratedLoudness()) + " instead of " + String(histogramExpected.getIntegratedLoudness()) + "\n";
+    }
+}
+
+
+bool StatisticsTestApplication::parseArguments(const StringArray& arguments)
+/*  Parse command line arguments.
+
+    arguments (StringArray): command line arguments
+
+    return value (Boolean): false if the arguments are invalid
+*/
+{
+    for (int nArgument = 0; nArgument < arguments.size(); nArgument++)
+    {
+        String strArgument = arguments[nArgument];
+        String strValue = strArgument.fromFirstOccurrenceOf("=", false, false);
+
+        if (strArgument.startsWith("--threads="))
+        {
+            nNumberOfThreads = strValue.getIntValue();
+
+            if (nNumberOfThreads < 1)
+            {
+                return false;
+            }
+        }
+        else if (strArgument.startsWith("--segment="))
+        {
+            nSegmentLength = strValue.getIntValue();
+
+            if (nSegmentLength < 1)
+            {
+                return false;
+            }
+        }
+        else if (strArgument.startsWith("-"))
+        {
+            return false;
+        }
+        else
+        {
+            File fileInput = File::getCurrentWorkingDirectory().getChildFile(strArgument);
+
+            if (fileInput.existsAsFile())
+            {
+                arrAudioFiles.add(fileInput);
+            }
+            else
+            {
+                ConsoleOutput::printMessage("File not found: \"" + strArgument + "\"\n");
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+void StatisticsTestApplication::printUsage()
+{
+    ConsoleOutput::printMessage(String(ProjectInfo::projectName) + " statistics test " + ProjectInfo::versionString);
+    ConsoleOutput::printMessage(String::empty);
+    ConsoleOutput::printMessage("Usage: kmeter_statistics_test [options] [file ...]");
+    ConsoleOutput::printMessage(String::empty);
+    ConsoleOutput::printMessage("Checks that segmented analysis matches analysis of whole files, using");
+    ConsoleOutput::printMessage("generated test files and all files passed on the command line.");
+    ConsoleOutput::printMessage(String::empty);
+    ConsoleOutput::printMessage("  --threads=N    use N threads (default: number of CPUs)");
+    ConsoleOutput::printMessage("  --segment=S    split files into segments of S seconds (default: 5)");
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
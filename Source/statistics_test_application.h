@@ -0,0 +1,74 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __STATISTICS_TEST_APPLICATION_H__
+#define __STATISTICS_TEST_APPLICATION_H__
+
+class StatisticsTestApplication;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "analyser_job.h"
+#include "console_output.h"
+#include "meter_statistics.h"
+#include "plugin_parameters.h"
+#include "signal_generator.h"
+
+
+//==============================================================================
+/**
+*/
+class StatisticsTestApplication
+{
+public:
+    StatisticsTestApplication();
+    ~StatisticsTestApplication();
+
+    int run(const StringArray& arguments);
+
+private:
+    JUCE_LEAK_DETECTOR(StatisticsTestApplication);
+
+    File generateTestFile(const File& directory, const int number_of_channels);
+    bool testFile(const File& fileAudio, const int average_algorithm, ThreadPool& threadPool);
+    void compareStatistics(const MeterStatistics& expected, const MeterStatistics& merged, const String& strMergeOrder, String& strDifferences);
+
+    bool parseArguments(const StringArray& arguments);
+    void printUsage();
+
+
+    int nNumberOfThreads;
+    int nSegmentLength;
+    int nSampleRate;
+
+    Array<File> arrAudioFiles;
+};
+
+
+#endif  // __STATISTICS_TEST_APPLICATION_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -51,10 +51,46 @@ StereoMeter::~StereoMeter()
 
 
 void StereoMeter::paint(Graphics& g)
+{
+    // background is rendered in resized()
+    g.drawImageAt(imageBackground, 0, 0);
+
+    // needle is three pixels wide, with its sides partly transparent
+    Rectangle<int> rectNeedle = getNeedleBounds(nNeedlePosition);
+
+    if (bVerticalMeter)
+    {
+        rectNeedle.reduce(1, 0);
+    }
+    else
+    {
+        rectNeedle.reduce(0, 1);
+    }
+
+    g.setColour(Colours::red.withAlpha(0.6f));
+    g.fillRect(rectNeedle);
+
+    g.setColour(Colours::red);
+
+    if (bVerticalMeter)
+    {
+        g.fillRect(rectNeedle.getX(), nNeedlePosition, rectNeedle.getWidth(), 1);
+    }
+    else
+    {
+        g.fillRect(nNeedlePosition, rectNeedle.getY(), 1, rectNeedle.getHeight());
+    }
+}
+
+
+void StereoMeter::renderBackground()
 {
     int width = getWidth();
     int height = getHeight();
 
+    imageBackground = Image(Image::RGB, width, height, true);
+    Graphics g(imageBackground);
+
     if (bVerticalMeter)
     {
         int middle_of_meter = height / 2;
@@ -91,21 +127,6 @@ void StereoMeter::paint(Graphics& g)
         g.setFont(11.0f);
         g.drawFittedText("L", 0, 0, width, width, Justification::centred, 1, 1.0f);
         g.drawFittedText("R", 0, height - width, width, width, Justification::centred, 1, 1.0f);
-
-        g.setColour(Colours::red);
-
-        for (int x = 1; x < (width - 1); x++)
-        {
-            g.setPixel(x, nNeedlePosition);
-        }
-
-        g.setColour(Colours::red.withAlpha(0.6f));
-
-        for (int x = 1; x < (width - 1); x++)
-        {
-            g.setPixel(x, nNeedlePosition - 1);
-            g.setPixel(x, nNeedlePosition + 1);
-        }
     }
     else
     {
@@ -143,21 +164,25 @@ void StereoMeter::paint(Graphics& g)
         g.setFont(11.0f);
         g.drawFittedText("L", 0, 0, height, height, Justification::centred, 1, 1.0f);
         g.drawFittedText("R", width - height + 1, 0, height, height, Justification::centred, 1, 1.0f);
+    }
+}
 
-        g.setColour(Colours::red);
 
-        for (int y = 1; y < (height - 1); y++)
-        {
-            g.setPixel(nNeedlePosition, y);
-        }
+Rectangle<int> StereoMeter::getNeedleBounds(int needle_position)
+/*  Get area covered by needle.
 
-        g.setColour(Colours::red.withAlpha(0.6f));
+    needle_position (integer): position of needle's centre
 
-        for (int y = 1; y < (height - 1); y++)
-        {
-            g.setPixel(nNeedlePosition - 1, y);
-            g.setPixel(nNeedlePosition + 1, y);
-        }
+    return value (Rectangle<int>): area covered by needle
+*/
+{
+    if (bVerticalMeter)
+    {
+        return Rectangle<int>(0, needle_position - 1, getWidth(), 3);
+    }
+    else
+    {
+        return Rectangle<int>(needle_position - 1, 0, 3, getHeight());
     }
 }
 
@@ -172,6 +197,12 @@ void StereoMeter::resized()
     nHeight = rect.getHeight();
 
     bVerticalMeter = (nHeight > nWidth);
+
+    // background only changes with the meter's size
+    if ((nWidth > 0) && (nHeight > 0))
+    {
+        renderBackground();
+    }
 }
 
 
@@ -195,7 +226,9 @@ void StereoMeter::setValue(float newValue)
         return;
     }
 
-    repaint(getLocalBounds());
+    // only re-paint old and new needle
+    repaint(getNeedleBounds(nNeedlePositionOld));
+    repaint(getNeedleBounds(nNeedlePosition));
 }
 
 
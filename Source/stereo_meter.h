@@ -45,6 +45,9 @@ public:
 private:
     JUCE_LEAK_DETECTOR(StereoMeter);
 
+    void renderBackground();
+    Rectangle<int> getNeedleBounds(int needle_position);
+
     float fValue;
     int nNeedlePosition;
 
@@ -54,6 +57,9 @@ private:
     int nHeight;
 
     bool bVerticalMeter;
+
+    // cached background, markers and labels
+    Image imageBackground;
 };
 
 
@@ -0,0 +1,333 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "stress_test_application.h"
+
+
+// host block sizes to be tested (unless specified on the command
+// line)
+static const int arrDefaultBlockSizes[] = {32, 64, 128, 256, 512, 1024, 2048, 4096};
+
+
+StressTestApplication::StressTestApplication()
+/*  Constructor.  Drives many plug-in instances without editors, just
+    like a host running a very large session, and reports how the
+    processing cost scales with the number of instances and the block
+    size.
+
+    return value: none
+*/
+{
+
+    nNumberOfInstances = 100;
+    nNumberOfChannels = JucePlugin_MaxNumInputChannels;
+    nSampleRate = 48000;
+    nSecondsPerBlockSize = 10;
+}
+
+
+StressTestApplication::~StressTestApplication()
+{
+}
+
+
+int StressTestApplication::run(const StringArray& arguments)
+/*  Run the stress test for all block sizes.
+
+    arguments (StringArray): command line arguments (without the name
+    of the executable)
+
+    return value (integer): exit code (0 on success)
+*/
+{
+    if (!parseArguments(arguments))
+    {
+        printUsage();
+        return 2;
+    }
+
+    ConsoleOutput::printMessage("Instances:    " + String(nNumberOfInstances));
+    ConsoleOutput::printMessage("Channels:     " + String(nNumberOfChannels));
+    ConsoleOutput::printMessage("Sample rate:  " + String(nSampleRate) + " Hz");
+    ConsoleOutput::printMessage("Duration:     " + String(nSecondsPerBlockSize) + " s per block size\n");
+
+    for (int nBlockSize = 0; nBlockSize < arrBlockSizes.size(); nBlockSize++)
+    {
+        runBlockSize(arrBlockSizes[nBlockSize]);
+    }
+
+    return 0;
+}
+
+
+void StressTestApplication::runBlockSize(const int block_size)
+/*  Instantiate all plug-ins, process synthetic audio in blocks of the
+    given size and print a report.  Every block of audio is passed to
+    all instances in turn, like a host does in a single audio
+    callback.
+
+    block_size (integer): number of samples per block
+
+    return value: none
+*/
+{
+    OwnedArray<AudioProcessor> arrProcessors;
+
+    int64 nMemoryBefore = getResidentMemory();
+    int64 nTicksInstantiate = 0;
+    int64 nTicksPrepare = 0;
+
+    for (int nInstance = 0; nInstance < nNumberOfInstances; nInstance++)
+    {
+        int64 nTicksStart = Time::getHighResolutionTicks();
+
+        AudioProcessor* pProcessor = createPluginFilter();
+
+        int64 nTicksCreated = Time::getHighResolutionTicks();
+
+        pProcessor->setPlayConfigDetails(nNumberOfChannels, nNumberOfChannels, nSampleRate, block_size);
+        pProcessor->prepareToPlay(nSampleRate, block_size);
+
+        int64 nTicksPrepared = Time::getHighResolutionTicks();
+
+        nTicksInstantiate += nTicksCreated - nTicksStart;
+        nTicksPrepare += nTicksPrepared - nTicksCreated;
+
+        arrProcessors.add(pProcessor);
+    }
+
+    int64 nMemoryAfter = getResidentMemory();
+
+    // loop one second of pink noise (rounded to full blocks), so
+    // that the input does not have to be generated while processing
+    int nNoiseLength = jmax(1, nSampleRate / block_size) * block_size;
+
+    AudioSampleBuffer noiseBuffer(nNumberOfChannels, nNoiseLength);
+
+    // fixed seed, so that all runs process the same signal
+    SignalGenerator signalGenerator(SignalGenerator::signalPinkNoise, nSampleRate, 1);
+    signalGenerator.fillBuffer(noiseBuffer, 0, nNoiseLength);
+
+    AudioSampleBuffer processBuffer(nNumberOfChannels, block_size);
+    MidiBuffer midiMessages;
+
+    int nBlocks = jmax(1, (nSecondsPerBlockSize * nSampleRate) / block_size);
+    int nNoisePosition = 0;
+
+    int64 nTicksProcessing = 0;
+    int64 nTicksWorstCallback = 0;
+    int64 nTicksWorstInstance = 0;
+
+    for (int nBlock = 0; nBlock < nBlocks; nBlock++)
+    {
+        int64 nTicksCallback = 0;
+
+        for (int nInstance = 0; nInstance < arrProcessors.size(); nInstance++)
+        {
+            // the plug-in delays its input, so refill the buffer for
+            // every instance (not part of the measurement)
+            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+            {
+                processBuffer.copyFrom(nChannel, 0, noiseBuffer, nChannel, nNoisePosition, block_size);
+            }
+
+            int64 nTicksStart = Time::getHighResolutionTicks();
+
+            arrProcessors[nInstance]->processBlock(processBuffer, midiMessages);
+
+            int64 nTicksInstance = Time::getHighResolutionTicks() - nTicksStart;
+
+            nTicksCallback += nTicksInstance;
+            nTicksWorstInstance = jmax(nTicksWorstInstance, nTicksInstance);
+        }
+
+        nTicksProcessing += nTicksCallback;
+        nTicksWorstCallback = jmax(nTicksWorstCallback, nTicksCallback);
+
+        nNoisePosition = (nNoisePosition + block_size) % nNoiseLength;
+    }
+
+    double dSecondsProcessed = double(nBlocks) * block_size / nSampleRate;
+    double dSecondsPerBlock = double(block_size) / nSampleRate;
+
+    // load of a single CPU core (may exceed 100 %)
+    double dCpuLoad = Time::highResolutionTicksToSeconds(nTicksProcessing) / dSecondsProcessed;
+    double dWorstCallback = Time::highResolutionTicksToSeconds(nTicksWorstCallback);
+
+    ConsoleOutput::printMessage("Block size:   " + String(block_size) + " samples (" + String(dSecondsPerBlock * 1000.0, 2) + " ms)");
+    ConsoleOutput::printMessage("Instantiate:  " + String(Time::highResolutionTicksToSeconds(nTicksInstantiate) * 1000.0 / nNumberOfInstances, 3) + " ms per instance");
+    ConsoleOutput::printMessage("Prepare:      " + String(Time::highResolutionTicksToSeconds(nTicksPrepare) * 1000.0 / nNumberOfInstances, 3) + " ms per instance");
+
+    if ((nMemoryBefore < 0) || (nMemoryAfter < 0))
+    {
+        ConsoleOutput::printMessage("Memory:       not available");
+    }
+    else
+    {
+        ConsoleOutput::printMessage("Memory:       " + String((nMemoryAfter - nMemoryBefore) / 1024.0 / nNumberOfInstances, 1) + " kB per instance");
+    }
+
+    ConsoleOutput::printMessage("CPU load:     " + String(dCpuLoad * 100.0, 1) + " % of one core");
+
+    if (dCpuLoad > 0.0)
+    {
+        ConsoleOutput::printMessage("Capacity:     " + String(roundToInt(nNumberOfInstances / dCpuLoad)) + " instances per core");
+    }
+
+    ConsoleOutput::printMessage("Worst block:  " + String(dWorstCallback * 1000.0, 3) + " ms (" + String(dWorstCallback / dSecondsPerBlock * 100.0, 1) + " % of block duration)");
+    ConsoleOutput::printMessage("Worst call:   " + String(Time::highResolutionTicksToSeconds(nTicksWorstInstance) * 1.0e6, 1) + " us (single instance)\n");
+
+    // plug-ins release their resources when they are deleted
+    arrProcessors.clear();
+}
+
+
+int64 StressTestApplication::getResidentMemory()
+/*  Get memory currently used by this process.
+
+    return value (64-bit integer): resident set size in bytes, or -1
+    if it cannot be determined on this platform
+*/
+{
+#if (defined (LINUX) || defined (__linux__))
+    StringArray arrLines;
+    arrLines.addLines(File("/proc/self/status").loadFileAsString());
+
+    for (int nLine = 0; nLine < arrLines.size(); nLine++)
+    {
+        // "VmRSS:     12345 kB"
+        if (arrLines[nLine].startsWith("VmRSS:"))
+        {
+            return arrLines[nLine].fromFirstOccurrenceOf(":", false, false).trim().getLargeIntValue() * 1024;
+        }
+    }
+#endif
+
+    return -1;
+}
+
+
+bool StressTestApplication::parseArguments(const StringArray& arguments)
+/*  Parse command line arguments.
+
+    arguments (StringArray): command line arguments
+
+    return value (Boolean): false if the arguments are invalid
+*/
+{
+    for (int nArgument = 0; nArgument < arguments.size(); nArgument++)
+    {
+        String strArgument = arguments[nArgument];
+        String strValue = strArgument.fromFirstOccurrenceOf("=", false, false);
+
+        if (strArgument.startsWith("--instances="))
+        {
+            nNumberOfInstances = strValue.getIntValue();
+
+            if (nNumberOfInstances < 1)
+            {
+                return false;
+            }
+        }
+        else if (strArgument.startsWith("--channels="))
+        {
+            nNumberOfChannels = strValue.getIntValue();
+
+            if ((nNumberOfChannels < 1) || (nNumberOfChannels > JucePlugin_MaxNumInputChannels))
+            {
+                return false;
+            }
+        }
+        else if (strArgument.startsWith("--rate="))
+        {
+            nSampleRate = strValue.getIntValue();
+
+            // range supported by the plug-in
+            if ((nSampleRate < 44100) || (nSampleRate > 192000))
+            {
+                return false;
+            }
+        }
+        else if (strArgument.startsWith("--seconds="))
+        {
+            nSecondsPerBlockSize = strValue.getIntValue();
+
+            if (nSecondsPerBlockSize < 1)
+            {
+                return false;
+            }
+        }
+        else if (strArgument.startsWith("--blocks="))
+        {
+            StringArray arrValues;
+            arrValues.addTokens(strValue, ",", String::empty);
+
+            for (int nValue = 0; nValue < arrValues.size(); nValue++)
+            {
+                int nBlockSize = arrValues[nValue].getIntValue();
+
+                if (nBlockSize < 1)
+                {
+                    return false;
+                }
+
+                arrBlockSizes.add(nBlockSize);
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if (arrBlockSizes.size() == 0)
+    {
+        for (int nBlockSize = 0; nBlockSize < numElementsInArray(arrDefaultBlockSizes); nBlockSize++)
+        {
+            arrBlockSizes.add(arrDefaultBlockSizes[nBlockSize]);
+        }
+    }
+
+    return true;
+}
+
+
+void StressTestApplication::printUsage()
+{
+    ConsoleOutput::printMessage(String(ProjectInfo::projectName) + " stress test " + ProjectInfo::versionString);
+    ConsoleOutput::printMessage(String::empty);
+    ConsoleOutput::printMessage("Usage: kmeter_stress_test [options]");
+    ConsoleOutput::printMessage(String::empty);
+    ConsoleOutput::printMessage("  --instances=N  number of plug-in instances (default: 100)");
+    ConsoleOutput::printMessage("  --channels=C   number of audio channels (default: " + String(JucePlugin_MaxNumInputChannels) + ")");
+    ConsoleOutput::printMessage("  --rate=R       sample rate in Hz (default: 48000)");
+    ConsoleOutput::printMessage("  --seconds=S    seconds of audio per block size (default: 10)");
+    ConsoleOutput::printMessage("  --blocks=B,... block sizes in samples (default: 32 to 4096)");
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,72 @@
+/* ----------------------------------------------------------------------------
+
+   K-Meter
+   =======
+   Implementation of a K-System meter according to Bob Katz' specifications
+
+   Copyright (c) 2010-2013 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __STRESS_TEST_APPLICATION_H__
+#define __STRESS_TEST_APPLICATION_H__
+
+class StressTestApplication;
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "console_output.h"
+#include "plugin_processor.h"
+#include "signal_generator.h"
+
+
+//==============================================================================
+/**
+*/
+class StressTestApplication
+{
+public:
+    StressTestApplication();
+    ~StressTestApplication();
+
+    int run(const StringArray& arguments);
+
+private:
+    JUCE_LEAK_DETECTOR(StressTestApplication);
+
+    void runBlockSize(const int block_size);
+    int64 getResidentMemory();
+
+    bool parseArguments(const StringArray& arguments);
+    void printUsage();
+
+
+    int nNumberOfInstances;
+    int nNumberOfChannels;
+    int nSampleRate;
+    int nSecondsPerBlockSize;
+
+    Array<int> arrBlockSizes;
+};
+
+
+#endif  // __STRESS_TEST_APPLICATION_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -100,6 +100,19 @@ WindowValidation::WindowValidation(int nWidth, int nHeight, bool horizontal_layo
     ButtonDumpCSV->setToggleState(pProcessor->getParameterAsBool(KmeterPluginParameters::selValidationCSVFormat), dontSendNotification);
     contentComponent->addAndMakeVisible(ButtonDumpCSV);
 
+    // write meter readings to a binary log file instead of text
+    // (kmeter_analyser converts it to CSV or JSON)
+    ButtonBinaryLog = new ToggleButton("Binary log (*.kmlog)");
+    ButtonBinaryLog->setColour(ToggleButton::textColourId, Colours::white);
+    ButtonBinaryLog->setToggleState(pProcessor->getParameterAsBool(KmeterPluginParameters::selValidationBinaryLog), dontSendNotification);
+    contentComponent->addAndMakeVisible(ButtonBinaryLog);
+
+    // render audio file as fast as possible and write report to a file
+    ButtonRenderOffline = new ToggleButton("Offline");
+    ButtonRenderOffline->setColour(ToggleButton::textColourId, Colours::white);
+    ButtonRenderOffline->setToggleState(pProcessor->getParameterAsBool(KmeterPluginParameters::selValidationRenderOffline), dontSendNotification);
+    contentComponent->addAndMakeVisible(ButtonRenderOffline);
+
     SliderDumpSelectedChannel->setValue(pProcessor->getParameterAsInt(KmeterPluginParameters::selValidationSelectedChannel), dontSendNotification);
     contentComponent->addAndMakeVisible(SliderDumpSelectedChannel);
 
@@ -161,7 +174,9 @@ WindowValidation::WindowValidation(int nWidth, int nHeight, bool horizontal_layo
 
         LabelDumpSelectedChannel->setBounds(nWidth - 362, nHeight - 118, 75, 20);
         SliderDumpSelectedChannel->setBounds(nWidth - 296, nHeight - 118, 70, 20);
-        ButtonDumpCSV->setBounds(nWidth - 362, nHeight - 94, 180, 20);
+        ButtonDumpCSV->setBounds(nWidth - 362, nHeight - 94, 90, 20);
+        ButtonRenderOffline->setBounds(nWidth - 272, nHeight - 94, 90, 20);
+        ButtonBinaryLog->setBounds(nWidth - 362, nHeight - 70, 180, 20);
 
         ButtonDumpPeakMeterLevel->setBounds(nWidth - 165, nHeight - 174, 180, 20);
         ButtonDumpAverageMeterLevel->setBounds(nWidth - 165, nHeight - 154, 180, 20);
@@ -174,21 +189,23 @@ WindowValidation::WindowValidation(int nWidth, int nHeight, bool horizontal_layo
     }
     else
     {
-        ButtonFileSelection->setBounds(nWidth - 45, nHeight - 269, 30, 20);
-        LabelFileSelection->setBounds(nWidth - 188, nHeight - 269, 138, 20);
+        ButtonFileSelection->setBounds(nWidth - 45, nHeight - 289, 30, 20);
+        LabelFileSelection->setBounds(nWidth - 188, nHeight - 289, 138, 20);
 
-        LabelSampleRate->setBounds(nWidth - 192, nHeight - 244, 75, 20);
-        LabelSampleRateValue->setBounds(nWidth - 126, nHeight - 244, 82, 20);
+        LabelSampleRate->setBounds(nWidth - 192, nHeight - 264, 75, 20);
+        LabelSampleRateValue->setBounds(nWidth - 126, nHeight - 264, 82, 20);
 
-        LabelDumpSelectedChannel->setBounds(nWidth - 192, nHeight - 219, 75, 20);
-        SliderDumpSelectedChannel->setBounds(nWidth - 126, nHeight - 219, 70, 20);
+        LabelDumpSelectedChannel->setBounds(nWidth - 192, nHeight - 239, 75, 20);
+        SliderDumpSelectedChannel->setBounds(nWidth - 126, nHeight - 239, 70, 20);
 
-        ButtonDumpPeakMeterLevel->setBounds(nWidth - 192, nHeight - 189, 180, 20);
-        ButtonDumpAverageMeterLevel->setBounds(nWidth - 192, nHeight - 169, 180, 20);
-        ButtonDumpMaximumPeakLevel->setBounds(nWidth - 192, nHeight - 149, 180, 20);
-        ButtonDumpStereoMeterValue->setBounds(nWidth - 192, nHeight - 129, 180, 20);
-        ButtonDumpPhaseCorrelation->setBounds(nWidth - 192, nHeight - 109, 180, 20);
-        ButtonDumpCSV->setBounds(nWidth - 192, nHeight - 89, 180, 20);
+        ButtonDumpPeakMeterLevel->setBounds(nWidth - 192, nHeight - 209, 180, 20);
+        ButtonDumpAverageMeterLevel->setBounds(nWidth - 192, nHeight - 189, 180, 20);
+        ButtonDumpMaximumPeakLevel->setBounds(nWidth - 192, nHeight - 169, 180, 20);
+        ButtonDumpStereoMeterValue->setBounds(nWidth - 192, nHeight - 149, 180, 20);
+        ButtonDumpPhaseCorrelation->setBounds(nWidth - 192, nHeight - 129, 180, 20);
+        ButtonDumpCSV->setBounds(nWidth - 192, nHeight - 109, 90, 20);
+        ButtonRenderOffline->setBounds(nWidth - 102, nHeight - 109, 90, 20);
+        ButtonBinaryLog->setBounds(nWidth - 192, nHeight - 89, 180, 20);
 
         ButtonValidation->setBounds(nWidth - 73, nHeight - 59, 60, 20);
         ButtonCancel->setBounds(nWidth - 138, nHeight - 59, 60, 20);
@@ -230,11 +247,11 @@ void WindowValidation::paint(Graphics& g)
     {
         g.setColour(Colours::white);
         g.setOpacity(0.15f);
-        g.drawRect(nWidth - 193, nHeight - 273, 188, 244);
+        g.drawRect(nWidth - 193, nHeight - 293, 188, 264);
 
         g.setColour(Colours::white);
         g.setOpacity(0.05f);
-        g.fillRect(nWidth - 192, nHeight - 272, 186, 242);
+        g.fillRect(nWidth - 192, nHeight - 292, 186, 262);
     }
 }
 
@@ -251,6 +268,9 @@ void WindowValidation::buttonClicked(Button* button)
         bool bReportCSV = ButtonDumpCSV->getToggleState();
         pProcessor->setParameter(KmeterPluginParameters::selValidationCSVFormat, bReportCSV ? 1.0f : 0.0f);
 
+        bool bBinaryLog = ButtonBinaryLog->getToggleState();
+        pProcessor->setParameter(KmeterPluginParameters::selValidationBinaryLog, bBinaryLog ? 1.0f : 0.0f);
+
         bool bAverageMeterLevel = ButtonDumpAverageMeterLevel->getToggleState();
         pProcessor->setParameter(KmeterPluginParameters::selValidationAverageMeterLevel, bAverageMeterLevel ? 1.0f : 0.0f);
 
@@ -266,8 +286,11 @@ void WindowValidation::buttonClicked(Button* button)
         bool bPhaseCorrelation = ButtonDumpPhaseCorrelation->getToggleState();
         pProcessor->setParameter(KmeterPluginParameters::selValidationPhaseCorrelation, bPhaseCorrelation ? 1.0f : 0.0f);
 
+        bool bRenderOffline = ButtonRenderOffline->getToggleState();
+        pProcessor->setParameter(KmeterPluginParameters::selValidationRenderOffline, bRenderOffline ? 1.0f : 0.0f);
+
         // validation file has already been initialised
-        pProcessor->startValidation(fileValidation, nSelectedChannel, bReportCSV, bAverageMeterLevel, bPeakMeterLevel, bMaximumPeakLevel, bStereoMeterValue, bPhaseCorrelation);
+        pProcessor->startValidation(fileValidation, nSelectedChannel, bReportCSV, bBinaryLog, bAverageMeterLevel, bPeakMeterLevel, bMaximumPeakLevel, bStereoMeterValue, bPhaseCorrelation, bRenderOffline);
 
         // close window by making it invisible
         setVisible(false);
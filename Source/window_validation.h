@@ -62,6 +62,8 @@ private:
     Label* LabelDumpSelectedChannel;
     ChannelSlider* SliderDumpSelectedChannel;
     ToggleButton* ButtonDumpCSV;
+    ToggleButton* ButtonBinaryLog;
+    ToggleButton* ButtonRenderOffline;
     ToggleButton* ButtonDumpAverageMeterLevel;
     ToggleButton* ButtonDumpPeakMeterLevel;
     ToggleButton* ButtonDumpMaximumPeakLevel;